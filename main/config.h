@@ -16,6 +16,7 @@
 #define DISPLAY_LINES           5
 #define DISPLAY_CHARS_PER_LINE  12
 #define DISPLAY_UPDATE_MS       100
+#define DISPLAY_TICKER_MAX_CHARS 96    // Scroll strip size (6 px per char)
 
 // ============================================================================
 // I2C CONFIGURATION
@@ -42,9 +43,47 @@
 #define GPS_UART_NUM            UART_NUM_1
 #define GPS_TX_PIN              21   // ESP32-C3 TX → GPS RX (board's TX pin)
 #define GPS_RX_PIN              20   // ESP32-C3 RX ← GPS TX (board's RX pin)
-#define GPS_BAUD_RATE           9600
-#define GPS_BUFFER_SIZE         1024
+#define GPS_BAUD_RATE           9600   // Receiver power-up rate (NMEA only)
+#define GPS_BUFFER_SIZE         1024   // UART driver RX ring buffer
+#define GPS_EVENT_QUEUE_SIZE    20     // UART driver event queue depth
+#define GPS_PATTERN_QUEUE_SIZE  20     // Pending '\n' positions (lines) in RX buffer
+#define GPS_LINE_MAX            128    // NMEA max is 82 chars incl. CR/LF
 #define GPS_FIX_TIMEOUT_MS      60000  // 60 seconds for initial fix
+#define GPS_PPS_PIN             4      // NEO-6M PPS output (rising edge = UTC second)
+#define GPS_MAX_SUBSCRIBERS     4      // Tasks notified on every new fix
+#define GPS_HEADING_MIN_SPEED_KN 2.0f  // Course is noise below this speed
+
+// UBX receiver configuration at boot (falls back to GPS_BAUD_RATE on failure)
+#define GPS_UBX_CONFIGURE       1
+#define GPS_UBX_BAUD_RATE       115200
+#define GPS_NAV_RATE_HZ         5      // NEO-6M maximum; M8 and later allow 10
+#define GPS_UBX_ACK_TIMEOUT_MS  500
+#define GPS_UBX_NAV_PVT         1      // Use binary NAV-PVT when the receiver has it (not NEO-6M)
+#define GPS_UBX_NAV_PVT_EPOCHS  5      // Epochs to wait for the first NAV-PVT before falling back to NMEA
+
+// ============================================================================
+// POSITION KALMAN FILTER
+// ============================================================================
+#define KF_UERE_M               4.0    // Position error per unit HDOP (1 sigma)
+#define KF_VEL_SIGMA_MPS        0.5    // RMC speed/course velocity error
+#define KF_ACCEL_SIGMA          1.0    // Process noise: unmodelled acceleration, m/s^2
+#define KF_INIT_VEL_SIGMA_MPS   30.0   // Velocity uncertainty before the first update
+#define KF_DR_MAX_MS            30000  // Dead-reckon at most this long after the last fix
+#define KF_DR_MAX_SIGMA_M       200    // ...or until the position is this uncertain
+#define KF_RECENTER_M           10000  // Move the local plane origin after this distance
+
+// ============================================================================
+// TIME DISCIPLINE (PPS PLL/FLL)
+// ============================================================================
+#define TD_STEP_THRESHOLD_US    128000   // Step instead of slew above this offset
+#define TD_LOCK_THRESHOLD_US    500      // |offset| below this counts as "good"
+#define TD_LOCK_SAMPLES         8        // Consecutive good samples to declare lock
+#define TD_PHASE_SHIFT          2        // Phase gain 1/4 per PPS
+#define TD_FREQ_SHIFT           4        // Frequency gain 1/16 per PPS
+#define TD_FREQ_MAX_PPB         500000   // Clamp frequency estimate to +/-500 ppm
+#define TD_PPS_TIMEOUT_US       3000000  // No PPS for 3 s -> holdover
+#define TD_HOLDOVER_MAX_US      600000000 // 10 min holdover before giving up
+#define TD_HOLDOVER_DRIFT_PPB   1000     // Assumed drift in holdover (dispersion)
 
 // ============================================================================
 // RTC CONFIGURATION (DS3231)
@@ -73,6 +112,14 @@
 #define NTP_SYNC_INTERVAL_MS    3600000  // 1 hour
 #define NTP_SYNC_TIMEOUT_MS     10000    // 10 seconds
 
+// Local NTP server for the camper's sensor fleet
+#ifndef NTP_SERVER_PORT
+#define NTP_SERVER_PORT             123    // Overridable for host tests (no root needed)
+#endif
+#define NTP_SERVER_TASK_PRIORITY    4      // Below gps_task (5) so fixes are never delayed
+#define NTP_SERVER_TASK_STACK       3072
+#define NTP_SERVER_NTP_DISPERSION_US 10000 // Estimated error when synced from internet NTP
+
 // ============================================================================
 // MQTT CONFIGURATION
 // ============================================================================
@@ -81,6 +128,13 @@
 #define MQTT_CLIENT_ID_PREFIX   "localizer_"
 #define MQTT_KEEPALIVE_SEC      60
 #define MQTT_RECONNECT_MS       5000
+#define MQTT_STATUS_INTERVAL_MS 30000  // Diagnostics on the status topic
+
+// gps topic rate policy: publish on movement/turns, heartbeat when parked
+#define MQTT_GPS_MIN_DISTANCE_M     10
+#define MQTT_GPS_MIN_HEADING_DEG    15
+#define MQTT_GPS_MIN_INTERVAL_MS    1000
+#define MQTT_GPS_MAX_INTERVAL_MS    30000
 
 // Default MQTT credentials from mqtt_credentials.h (can be overridden via NVS)
 #define DEFAULT_MQTT_BROKER     MQTT_BROKER_URI
@@ -88,16 +142,80 @@
 #define DEFAULT_MQTT_USER       MQTT_USER
 #define DEFAULT_MQTT_PASS       MQTT_PASSWORD
 
-// MQTT Topics
+// MQTT Topics: "<base>/<device id>/<leaf>", composed once at startup.
+// The device ID comes from NVS (NVS_DEVICE_ID) so several units can share a broker.
 #define MQTT_TOPIC_BASE         "camper"
+#define MQTT_TOPIC_MAX_LEN      64
+#define DEFAULT_DEVICE_ID       "device01"
 #define MQTT_TOPIC_GPS          "gps"
 #define MQTT_TOPIC_STATUS       "status"
 #define MQTT_TOPIC_LOCATION     "location"
+#define MQTT_TOPIC_TRACK        "track"
+
+// ============================================================================
+// MQTT OUTBOX (bounded queue in front of the client, see outbox.h)
+// ============================================================================
+#define OUTBOX_SLOTS            8          // RAM pool, OUTBOX_SLOT_SIZE bytes each
+#define OUTBOX_SLOT_SIZE        512        // A binary track batch is <= 500
+#define OUTBOX_MSG_MAX          2048       // Largest message (status), in consecutive slots
+#define OUTBOX_MAX_INFLIGHT     4          // QoS 1 messages handed to the client at once
+#define OUTBOX_RETRY_MIN_MS     2000       // Backoff after a refused or expired publish, doubling
+#define OUTBOX_RETRY_MAX_MS     60000
+#define OUTBOX_SPILL_SLOTS      16         // Messages kept in NVS when the pool is full (0 = drop)
+#define OUTBOX_NVS_NAMESPACE    "outbox"
+#define OUTBOX_CLIENT_LIMIT     8192       // Hard cap on the client's own heap outbox, bytes
+
+// What a new message does to an unsent one on the same topic
+#define OUTBOX_POLICY_GPS       OUTBOX_COALESCE     // Only the latest position matters
+#define OUTBOX_POLICY_LOCATION  OUTBOX_COALESCE
+#define OUTBOX_POLICY_TRACK     OUTBOX_DROP_OLDEST  // Every batch is kept
+#define OUTBOX_POLICY_STATUS    OUTBOX_COALESCE
+
+// ============================================================================
+// TRACK LOG (store-and-forward)
+// ============================================================================
+#define TRACKLOG_PARTITION_LABEL    "tracklog"
+#define TRACKLOG_PARTITION_SUBTYPE  0x40   // Custom data subtype, see partitions.csv
+#define TRACKLOG_QUEUE_LEN          32     // Records buffered between gps_task and flash
+#define TRACKLOG_FLUSH_MS           5000   // Commit a partial page after this idle time
+#define TRACKLOG_TASK_PRIORITY      2
+#define TRACKLOG_TASK_STACK         3072
+#define TRACKLOG_DRAIN_BATCH        16     // Records per MQTT track message
+#define TRACKLOG_DRAIN_INTERVAL_MS  1000   // Backlog drain rate while connected
+#define TRACKLOG_BATCH_MS           10000  // Send a partial batch once it is this old
+#define MQTT_TRACK_BINARY           1      // 1 = track_codec.h payload, 0 = JSON array
+#define MQTT_GPS_JSON_ENABLE        1      // Also publish each fix as JSON on the gps topic
+
+// Track simplification defaults (overridable in NVS, see serial menu)
+#define TRACK_MIN_DISTANCE_M        5      // Drop fixes closer than this (parked jitter)
+#define TRACK_MAX_DEVIATION_M       10     // Douglas-Peucker error bound
+#define TRACK_HEADING_DEG           30     // Turn that always keeps the corner point
+#define TRACK_MAX_INTERVAL_S        60     // Heartbeat point while parked
+#define TRACK_WINDOW                32     // Fixes buffered per simplification pass
 
 // ============================================================================
 // GEOLOCATION CONFIGURATION
 // ============================================================================
-#define GEOLOCATION_UPDATE_MS   5000   // Update every 5 seconds
+#define GEOLOCATION_UPDATE_MS   5000   // Minimum time between HTTP lookups
+
+// Persistent geolocation HTTP connection
+#define GEO_HTTP_KEEPALIVE_IDLE_S       30      // TCP keep-alive probes detect dead sessions
+#define GEO_HTTP_KEEPALIVE_INTERVAL_S   10
+#define GEO_HTTP_BACKOFF_MIN_MS         5000    // Reconnect backoff after a failure
+#define GEO_HTTP_BACKOFF_MAX_MS         300000
+
+// Reverse-geocode cache: lookups only go out on entering an unknown cell
+#define GEOCACHE_SIZE           32         // Cells kept in RAM (~120 bytes each)
+#define GEOCACHE_CELL_E7        20000      // 0.002 deg grid, ~220 m north-south
+#define GEOCACHE_TTL_S          (7 * 86400)
+#define GEOCACHE_PERSIST        1          // Keep the table in NVS across reboots
+#define GEOCACHE_PERSIST_MS     600000     // At most one NVS write per 10 minutes
+#define GEOCACHE_NVS_NAMESPACE  "geocache"
+
+// Offline place index (built by tools/build_place_index.py)
+#define PLACE_INDEX_PARTITION_LABEL     "places"
+#define PLACE_INDEX_PARTITION_SUBTYPE   0x41
+#define PLACE_INDEX_MAX_DISTANCE_M      15000   // Further than this: no nearby place
 #define GEOLOCATION_API_URL     "http://api.bigdatacloud.net/data/reverse-geocode-client"
 
 // ============================================================================
@@ -0,0 +1,149 @@
+/**
+ * DS3231 RTC Driver
+ *
+ * All time registers are BCD; the chip runs in 24h mode with the year
+ * stored as an offset from 2000.
+ * Syquens B.V. - 2026
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ds3231.h"
+#include "time_discipline.h"
+
+#define DS3231_REG_SEC    0x00
+#define DS3231_REG_MIN    0x01
+#define DS3231_REG_HOUR   0x02
+#define DS3231_REG_DOW    0x03
+#define DS3231_REG_DAY    0x04
+#define DS3231_REG_MONTH  0x05
+#define DS3231_REG_YEAR   0x06
+#define DS3231_REG_CONTROL 0x0E
+#define DS3231_REG_STATUS 0x0F
+#define DS3231_REG_AGING  0x10
+#define DS3231_REG_TEMP   0x11   // MSB; LSB at 0x12
+
+#define DS3231_CONTROL_CONV 0x20 // Force temperature conversion / TCXO update
+#define DS3231_STATUS_OSF   0x80 // Oscillator stopped - time not trustworthy
+#define DS3231_STATUS_BSY   0x04 // TCXO conversion running
+
+#define DS3231_BSY_POLL_MS    10
+#define DS3231_BSY_TIMEOUT_MS 250 // Conversion takes up to 200 ms
+
+#define DS3231_TIME_REGS  7      // Seconds .. year
+
+static const hal_i2c_dev_t *s_dev = NULL;
+
+static uint8_t bcd_to_dec(uint8_t val) {
+    return (val / 16 * 10) + (val % 16);
+}
+
+static uint8_t dec_to_bcd(uint8_t val) {
+    return (val / 10 * 16) + (val % 10);
+}
+
+static esp_err_t write_reg(uint8_t reg, uint8_t val) {
+    uint8_t data[2] = {reg, val};
+    return s_dev->write(s_dev->ctx, data, 2);
+}
+
+static esp_err_t read_regs(uint8_t reg, uint8_t *buf, size_t len) {
+    // Repeated-start register read: one bus transaction
+    return s_dev->write_read(s_dev->ctx, &reg, 1, buf, len);
+}
+
+// Wait out a running conversion (also started by the chip every 64 s)
+static esp_err_t wait_not_busy(void) {
+    for (int waited = 0;; waited += DS3231_BSY_POLL_MS) {
+        uint8_t status;
+        esp_err_t err = read_regs(DS3231_REG_STATUS, &status, 1);
+        if (err != ESP_OK) return err;
+        if (!(status & DS3231_STATUS_BSY)) return ESP_OK;
+        if (waited >= DS3231_BSY_TIMEOUT_MS) return ESP_ERR_TIMEOUT;
+        vTaskDelay(pdMS_TO_TICKS(DS3231_BSY_POLL_MS));
+    }
+}
+
+void ds3231_init(const hal_i2c_dev_t *dev) {
+    s_dev = dev;
+}
+
+esp_err_t ds3231_set_time(const ds3231_time_t *t) {
+    int64_t unix_sec = td_utc_to_unix(t->year, t->month, t->day, t->hour, t->minute, t->second);
+    int dow = (int)(((unix_sec / 86400) + 3) % 7) + 1;  // 1 = Monday
+
+    // Burst write of the whole time block so the registers are consistent
+    uint8_t data[1 + DS3231_TIME_REGS] = {
+        DS3231_REG_SEC,
+        dec_to_bcd(t->second),
+        dec_to_bcd(t->minute),
+        dec_to_bcd(t->hour),     // 24h mode (bit 6 clear)
+        (uint8_t)dow,
+        dec_to_bcd(t->day),
+        dec_to_bcd(t->month),
+        dec_to_bcd(t->year - 2000),
+    };
+    esp_err_t err = s_dev->write(s_dev->ctx, data, sizeof(data));
+    if (err != ESP_OK) return err;
+
+    // Time is valid again - clear the oscillator stop flag
+    uint8_t status;
+    err = read_regs(DS3231_REG_STATUS, &status, 1);
+    if (err != ESP_OK) return err;
+    if (status & DS3231_STATUS_OSF) {
+        err = write_reg(DS3231_REG_STATUS, status & ~DS3231_STATUS_OSF);
+    }
+    return err;
+}
+
+esp_err_t ds3231_get_time(ds3231_time_t *t) {
+    uint8_t regs[DS3231_TIME_REGS];
+    esp_err_t err = read_regs(DS3231_REG_SEC, regs, sizeof(regs));
+    if (err != ESP_OK) return err;
+
+    t->second = bcd_to_dec(regs[DS3231_REG_SEC] & 0x7F);
+    t->minute = bcd_to_dec(regs[DS3231_REG_MIN] & 0x7F);
+    t->hour = bcd_to_dec(regs[DS3231_REG_HOUR] & 0x3F);
+    t->day = bcd_to_dec(regs[DS3231_REG_DAY] & 0x3F);
+    t->month = bcd_to_dec(regs[DS3231_REG_MONTH] & 0x1F);
+    t->year = bcd_to_dec(regs[DS3231_REG_YEAR]) + 2000;
+    return ESP_OK;
+}
+
+esp_err_t ds3231_oscillator_stopped(bool *stopped) {
+    uint8_t status;
+    esp_err_t err = read_regs(DS3231_REG_STATUS, &status, 1);
+    if (err != ESP_OK) return err;
+    *stopped = (status & DS3231_STATUS_OSF) != 0;
+    return ESP_OK;
+}
+
+esp_err_t ds3231_get_temperature(float *celsius) {
+    uint8_t regs[2];
+    esp_err_t err = read_regs(DS3231_REG_TEMP, regs, sizeof(regs));
+    if (err != ESP_OK) return err;
+
+    // 10-bit two's complement, 0.25 C resolution
+    int16_t raw = (int16_t)((regs[0] << 8) | regs[1]) >> 6;
+    *celsius = raw * 0.25f;
+    return ESP_OK;
+}
+
+esp_err_t ds3231_get_aging_offset(int8_t *offset) {
+    return read_regs(DS3231_REG_AGING, (uint8_t *)offset, 1);
+}
+
+esp_err_t ds3231_set_aging_offset(int8_t offset) {
+    esp_err_t err = write_reg(DS3231_REG_AGING, (uint8_t)offset);
+    if (err != ESP_OK) return err;
+
+    // Aging takes effect on the next TCXO update; force one now. The
+    // read-modify-write must not run on a failed read (it would clear
+    // INTCN, EOSC and the alarm enables), and CONV only once BSY is clear.
+    uint8_t control;
+    err = read_regs(DS3231_REG_CONTROL, &control, 1);
+    if (err != ESP_OK) return err;
+    err = wait_not_busy();
+    if (err != ESP_OK) return err;
+    return write_reg(DS3231_REG_CONTROL, control | DS3231_CONTROL_CONV);
+}
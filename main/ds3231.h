@@ -0,0 +1,48 @@
+/**
+ * DS3231 RTC Driver
+ *
+ * Register-level access (time block, status, temperature, aging) through
+ * a hal_i2c_dev_t. Caching and time interpolation stay with the caller.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef DS3231_H
+#define DS3231_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "hal.h"
+
+#define DS3231_ADDR 0x68
+
+typedef struct {
+    int year;
+    int month;
+    int day;
+    int hour;
+    int minute;
+    int second;
+} ds3231_time_t;
+
+void ds3231_init(const hal_i2c_dev_t *dev);
+
+// Burst-write the time block (UTC, 24h) and clear the oscillator stop flag;
+// an error may mean the time was written but the flag is still set
+esp_err_t ds3231_set_time(const ds3231_time_t *t);
+
+// Burst-read the time block; consistent because the chip latches it
+esp_err_t ds3231_get_time(ds3231_time_t *t);
+
+// *stopped: the oscillator stopped (battery loss) since the time was last
+// set. Left untouched on a bus error.
+esp_err_t ds3231_oscillator_stopped(bool *stopped);
+
+esp_err_t ds3231_get_temperature(float *celsius);
+esp_err_t ds3231_get_aging_offset(int8_t *offset);
+
+// Write the aging offset and force a TCXO update so it takes effect now
+// (waits up to 250 ms for a running conversion)
+esp_err_t ds3231_set_aging_offset(int8_t offset);
+
+#endif // DS3231_H
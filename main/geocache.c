@@ -0,0 +1,136 @@
+/**
+ * Reverse-Geocode Cache
+ *
+ * Only the location task touches the table, so no locking is needed.
+ * Persisting rewrites one NVS blob; it is rate-limited because every
+ * write costs flash wear.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "config.h"
+#include "geocache.h"
+
+static const char *TAG = "GEOCACHE";
+
+#define GEOCACHE_NVS_KEY    "table"
+
+static geocache_entry_t s_table[GEOCACHE_SIZE];
+static uint32_t s_clock = 0;          // LRU stamp source
+static bool s_dirty = false;
+static uint32_t s_last_persist_ms = 0;
+static geocache_stats_t s_stats = {0};
+
+static inline bool entry_used(const geocache_entry_t *e) {
+    return e->fetched != 0;
+}
+
+static bool entry_expired(const geocache_entry_t *e) {
+    uint32_t now = (uint32_t)time(NULL);
+    // Clock not set yet (or stepped back): trust the entry
+    return now > e->fetched && now - e->fetched > GEOCACHE_TTL_S;
+}
+
+uint64_t geocache_cell_key(int32_t lat_e7, int32_t lon_e7) {
+    // Floor division so cells don't straddle the equator/meridian
+    int32_t lat_cell = lat_e7 / GEOCACHE_CELL_E7 - (lat_e7 % GEOCACHE_CELL_E7 < 0);
+    int32_t lon_cell = lon_e7 / GEOCACHE_CELL_E7 - (lon_e7 % GEOCACHE_CELL_E7 < 0);
+    return ((uint64_t)(uint32_t)lat_cell << 32) | (uint32_t)lon_cell;
+}
+
+bool geocache_lookup(uint64_t key, geocache_entry_t *out) {
+    for (int i = 0; i < GEOCACHE_SIZE; i++) {
+        geocache_entry_t *e = &s_table[i];
+        if (!entry_used(e) || e->key != key) continue;
+
+        if (entry_expired(e)) {
+            s_stats.expired++;
+            break;
+        }
+        e->last_used = ++s_clock;
+        *out = *e;
+        s_stats.hits++;
+        return true;
+    }
+    s_stats.misses++;
+    return false;
+}
+
+void geocache_store(uint64_t key, const char *street, const char *city, const char *country) {
+    // Reuse the cell's slot, else a free slot, else the least recently used
+    geocache_entry_t *slot = &s_table[0];
+    for (int i = 0; i < GEOCACHE_SIZE; i++) {
+        geocache_entry_t *e = &s_table[i];
+        if (entry_used(e) && e->key == key) {
+            slot = e;
+            break;
+        }
+        if (!entry_used(slot)) continue;
+        if (!entry_used(e) || e->last_used < slot->last_used) {
+            slot = e;
+        }
+    }
+    if (entry_used(slot) && slot->key != key) {
+        s_stats.evictions++;
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    slot->key = key;
+    slot->fetched = (uint32_t)time(NULL);
+    if (slot->fetched == 0) slot->fetched = 1;
+    slot->last_used = ++s_clock;
+    strncpy(slot->street, street, sizeof(slot->street) - 1);
+    strncpy(slot->city, city, sizeof(slot->city) - 1);
+    strncpy(slot->country, country, sizeof(slot->country) - 1);
+    s_dirty = true;
+}
+
+void geocache_persist(void) {
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    if (!GEOCACHE_PERSIST || !s_dirty || now - s_last_persist_ms < GEOCACHE_PERSIST_MS) return;
+    s_last_persist_ms = now;
+
+    nvs_handle_t nvs;
+    if (nvs_open(GEOCACHE_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+    if (nvs_set_blob(nvs, GEOCACHE_NVS_KEY, s_table, sizeof(s_table)) == ESP_OK &&
+        nvs_commit(nvs) == ESP_OK) {
+        s_dirty = false;
+        ESP_LOGI(TAG, "Cache persisted");
+    }
+    nvs_close(nvs);
+}
+
+void geocache_get_stats(geocache_stats_t *out) {
+    *out = s_stats;
+    out->entries = 0;
+    for (int i = 0; i < GEOCACHE_SIZE; i++) {
+        if (entry_used(&s_table[i])) out->entries++;
+    }
+}
+
+void geocache_init(void) {
+    memset(s_table, 0, sizeof(s_table));
+    if (!GEOCACHE_PERSIST) return;
+
+    nvs_handle_t nvs;
+    if (nvs_open(GEOCACHE_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return;
+
+    // A size mismatch means the layout changed: start empty
+    size_t len = sizeof(s_table);
+    if (nvs_get_blob(nvs, GEOCACHE_NVS_KEY, s_table, &len) != ESP_OK || len != sizeof(s_table)) {
+        memset(s_table, 0, sizeof(s_table));
+    }
+    nvs_close(nvs);
+
+    for (int i = 0; i < GEOCACHE_SIZE; i++) {
+        if (s_table[i].last_used > s_clock) s_clock = s_table[i].last_used;
+    }
+    geocache_stats_t stats;
+    geocache_get_stats(&stats);
+    ESP_LOGI(TAG, "Loaded %lu cached addresses", (unsigned long)stats.entries);
+}
@@ -0,0 +1,50 @@
+/**
+ * Reverse-Geocode Cache
+ *
+ * Addresses keyed by a fixed lat/lon grid cell, kept in a small RAM LRU
+ * that is written back to NVS so a parked camper survives reboots
+ * without hitting the geocoding service again.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef GEOCACHE_H
+#define GEOCACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t key;           // geocache_cell_key() of the cell
+    uint32_t fetched;       // Unix time of the lookup
+    uint32_t last_used;     // LRU stamp
+    char street[64];
+    char city[40];
+    char country[4];        // ISO country code
+} geocache_entry_t;
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t expired;       // Misses caused by an outdated entry
+    uint32_t evictions;
+    uint32_t entries;
+} geocache_stats_t;
+
+// Load the persisted table from NVS (empty cache if none)
+void geocache_init(void);
+
+// Grid cell containing a position
+uint64_t geocache_cell_key(int32_t lat_e7, int32_t lon_e7);
+
+// Look up the cell; true and *out filled on a fresh hit
+bool geocache_lookup(uint64_t key, geocache_entry_t *out);
+
+// Insert or refresh a cell's address
+void geocache_store(uint64_t key, const char *street, const char *city, const char *country);
+
+// Write the table to NVS if it changed and GEOCACHE_PERSIST_MS has passed
+void geocache_persist(void);
+
+void geocache_get_stats(geocache_stats_t *out);
+
+#endif // GEOCACHE_H
@@ -0,0 +1,116 @@
+/**
+ * GNSS UART Ingestion
+ *
+ * Pattern detection on '\n' only serves to wake the GPS task as soon as a
+ * line is complete. The driver's event and position queues can both
+ * overflow, so neither is trusted to describe the buffer: each event reads
+ * everything buffered, splits it at '\n' and keeps a partial line for the
+ * next event. Lines cut by an overflow are resynchronised on '$'.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "gps_rx.h"
+
+static const char *TAG = "GPS_RX";
+
+static void flush(gps_rx_t *rx) {
+    uart_flush_input(rx->port);
+    xQueueReset(rx->queue);
+    if (rx->fill > 0 || rx->discard) rx->dropped++;   // Line in progress
+    rx->fill = 0;
+    rx->discard = false;
+    rx->dropped++;
+}
+
+// Hand out a line, starting at its last '$': anything before it is the
+// head of a sentence whose tail was lost to an overflow
+static void deliver(gps_rx_t *rx, const char *line, size_t len) {
+    size_t start = len;
+    while (start > 0 && line[start - 1] != '$') start--;
+    if (start == 0) {
+        rx->dropped++;  // No sentence start at all: tail of a cut line
+        return;
+    }
+    start--;
+    if (start > 0) rx->dropped++;
+    rx->on_line(line + start, len - start);
+}
+
+// Read len bytes and hand out every complete line in them
+static void read_lines(gps_rx_t *rx, size_t len) {
+    while (len > 0) {
+        size_t room = sizeof(rx->buf) - rx->fill;
+        size_t chunk = len < room ? len : room;
+        int got = uart_read_bytes(rx->port, rx->buf + rx->fill, chunk, 0);
+        if (got <= 0) break;
+        len -= got;
+
+        size_t start = 0, end = rx->fill + got;
+        for (size_t i = rx->fill; i < end; i++) {
+            if (rx->buf[i] != '\n') continue;
+            if (rx->discard) {
+                rx->discard = false;
+                rx->dropped++;
+            } else {
+                deliver(rx, rx->buf + start, i + 1 - start);
+            }
+            start = i + 1;
+        }
+
+        rx->fill = end - start;
+        if (rx->discard || rx->fill == sizeof(rx->buf)) {
+            // Longer than any NMEA line: garbage or a lost terminator
+            rx->discard = true;
+            rx->fill = 0;
+        } else if (start > 0 && rx->fill > 0) {
+            memmove(rx->buf, rx->buf + start, rx->fill);
+        }
+    }
+}
+
+void gps_rx_start(gps_rx_t *rx) {
+    uart_flush_input(rx->port);
+    xQueueReset(rx->queue);
+    if (!rx->binary) {
+        uart_enable_pattern_det_baud_intr(rx->port, '\n', 1, 9, 0, 0);
+        uart_pattern_queue_reset(rx->port, GPS_PATTERN_QUEUE_SIZE);
+    }
+    rx->fill = 0;
+    rx->discard = false;
+}
+
+void gps_rx_handle(gps_rx_t *rx, const uart_event_t *event) {
+    switch (event->type) {
+    case UART_PATTERN_DET:
+    case UART_DATA: {
+        // Everything buffered, not only this event's share
+        size_t avail = 0;
+        uart_get_buffered_data_len(rx->port, &avail);
+        if (rx->binary) {
+            while (avail > 0) {
+                size_t chunk = avail < sizeof(rx->buf) ? avail : sizeof(rx->buf);
+                int len = uart_read_bytes(rx->port, rx->buf, chunk, 0);
+                if (len <= 0) break;
+                rx->on_data((const uint8_t *)rx->buf, len);
+                avail -= len;
+            }
+        } else {
+            // The split finds the terminators again; drop their positions
+            while (uart_pattern_pop_pos(rx->port) >= 0) {
+            }
+            read_lines(rx, avail);
+        }
+        break;
+    }
+    case UART_FIFO_OVF:
+    case UART_BUFFER_FULL:
+        ESP_LOGW(TAG, "GPS UART overflow, flushing");
+        flush(rx);
+        rx->overruns++;
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,43 @@
+/**
+ * GNSS UART Ingestion
+ *
+ * Turns UART driver events into complete NMEA lines or raw byte runs
+ * (binary UBX output). Owns the line buffer and the loss counters;
+ * parsing is left to the callbacks. Runs in the GPS task.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef GPS_RX_H
+#define GPS_RX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "config.h"
+
+typedef struct {
+    uart_port_t port;
+    QueueHandle_t queue;        // Event queue from uart_driver_install
+    bool binary;                // Raw reads on UART_DATA instead of line patterns
+    void (*on_line)(const char *line, size_t len);      // Includes the "\r\n"
+    void (*on_data)(const uint8_t *data, size_t len);
+
+    uint32_t dropped;           // Lines lost: overflows, oversized and cut lines
+    uint32_t overruns;          // UART FIFO/ring overflows
+
+    char buf[GPS_LINE_MAX];     // Line being assembled (NMEA) or read chunk (binary)
+    size_t fill;
+    bool discard;               // Line outgrew buf; skip to its '\n'
+} gps_rx_t;
+
+// Flush stale input and, for NMEA, arm '\n' pattern detection. Call once
+// the receiver is configured and rx->binary is final.
+void gps_rx_start(gps_rx_t *rx);
+
+// Handle one event taken from rx->queue
+void gps_rx_handle(gps_rx_t *rx, const uart_event_t *event);
+
+#endif // GPS_RX_H
@@ -0,0 +1,35 @@
+/**
+ * Hardware Abstraction Seams
+ *
+ * Peripheral drivers (oled.c, ds3231.c, ubx.c) talk to the bus only through
+ * these interfaces. main.c binds them to the ESP-IDF drivers; a host
+ * build can bind them to in-memory device models instead.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// One device on an I2C bus
+typedef struct {
+    void *ctx;  // Passed back to the callbacks (e.g. the IDF device handle)
+    // Single write transaction
+    esp_err_t (*write)(void *ctx, const uint8_t *data, size_t len);
+    // Write then read with a repeated start, as one transaction
+    esp_err_t (*write_read)(void *ctx, const uint8_t *wr, size_t wr_len, uint8_t *rd, size_t rd_len);
+} hal_i2c_dev_t;
+
+// Byte-stream port (the GNSS UART)
+typedef struct {
+    void *ctx;
+    esp_err_t (*write)(void *ctx, const uint8_t *data, size_t len);  // Returns once sent
+    // Read up to len bytes, waiting at most timeout_ms; returns the count (<0 on error)
+    int (*read)(void *ctx, uint8_t *buf, size_t len, uint32_t timeout_ms);
+    esp_err_t (*set_baud)(void *ctx, uint32_t baud);
+} hal_uart_t;
+
+#endif // HAL_H
@@ -0,0 +1,286 @@
+/**
+ * Streaming JSON Field Extractor
+ *
+ * A byte-at-a-time state machine. Only the current container path, the
+ * last object key and the value being captured are kept, so memory use is
+ * fixed regardless of document size.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "json_extract.h"
+
+enum {
+    JX_VALUE = 0,       // Expecting a value
+    JX_KEY_OR_END,      // In an object, expecting a key or '}'
+    JX_KEY,             // Inside a key string
+    JX_COLON,           // After a key
+    JX_STRING,          // Inside a string value
+    JX_LITERAL,         // Inside a number / true / false / null
+    JX_AFTER_VALUE,     // Expecting ',' or a closing bracket
+    JX_DONE,
+};
+
+static inline bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool in_array(const jx_parser_t *jx) {
+    return jx->depth > 0 && (jx->array_mask & (1u << jx->depth));
+}
+
+static void capture_char(jx_parser_t *jx, char c) {
+    jx_field_t *f = jx->capture;
+    if (f && jx->capture_len + 1 < f->out_size) {
+        f->out[jx->capture_len++] = c;
+        f->out[jx->capture_len] = 0;
+    }
+}
+
+static void key_char(jx_parser_t *jx, char c) {
+    if (jx->key_len + 1 < JX_KEY_MAX) {
+        jx->key[jx->key_len++] = c;
+    } else {
+        jx->key_overflow = true;
+    }
+}
+
+// Route string bytes to the key or the captured value
+static void string_char(jx_parser_t *jx, char c) {
+    if (jx->state == JX_KEY) {
+        key_char(jx, c);
+    } else {
+        capture_char(jx, c);
+    }
+}
+
+static void string_codepoint(jx_parser_t *jx, uint32_t cp) {
+    if (cp < 0x80) {
+        string_char(jx, cp);
+    } else if (cp < 0x800) {
+        string_char(jx, 0xC0 | (cp >> 6));
+        string_char(jx, 0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        string_char(jx, 0xE0 | (cp >> 12));
+        string_char(jx, 0x80 | ((cp >> 6) & 0x3F));
+        string_char(jx, 0x80 | (cp & 0x3F));
+    } else {
+        string_char(jx, 0xF0 | (cp >> 18));
+        string_char(jx, 0x80 | ((cp >> 12) & 0x3F));
+        string_char(jx, 0x80 | ((cp >> 6) & 0x3F));
+        string_char(jx, 0x80 | (cp & 0x3F));
+    }
+}
+
+// Path of the value about to start: container path plus the current key
+static size_t value_path(const jx_parser_t *jx, char *buf) {
+    size_t len = jx->path_len[jx->depth];
+    memcpy(buf, jx->path, len);
+    if (in_array(jx) || jx->depth == 0) {
+        return len;
+    }
+    if (jx->key_overflow || len + 1 + jx->key_len >= JX_PATH_MAX) {
+        // Never matches a field; capped so deeper levels do not lengthen it
+        if (len > JX_PATH_MAX - 2) len = JX_PATH_MAX - 2;
+        buf[len++] = '#';
+        return len;
+    }
+    if (len) buf[len++] = '.';
+    memcpy(buf + len, jx->key, jx->key_len);
+    return len + jx->key_len;
+}
+
+static void begin_value(jx_parser_t *jx, const char *path, size_t path_len) {
+    jx->capture = NULL;
+    if (in_array(jx)) return;
+    for (int i = 0; i < jx->field_count; i++) {
+        jx_field_t *f = &jx->fields[i];
+        if (strlen(f->path) == path_len && memcmp(f->path, path, path_len) == 0) {
+            jx->capture = f;
+            jx->capture_len = 0;
+            if (f->out_size) f->out[0] = 0;
+            return;
+        }
+    }
+}
+
+static void end_value(jx_parser_t *jx) {
+    if (jx->capture) {
+        jx->capture->found = true;
+        jx->capture = NULL;
+    }
+    jx->state = jx->depth ? JX_AFTER_VALUE : JX_DONE;
+}
+
+static void push(jx_parser_t *jx, const char *path, size_t path_len, bool array) {
+    if (jx->depth >= JX_MAX_DEPTH) {
+        jx->error = true;
+        return;
+    }
+    jx->depth++;
+    if (array) {
+        jx->array_mask |= 1u << jx->depth;
+    } else {
+        jx->array_mask &= ~(1u << jx->depth);
+    }
+    memcpy(jx->path, path, path_len);
+    if (array && path_len + 2 <= JX_PATH_MAX) {
+        memcpy(jx->path + path_len, "[]", 2);
+        path_len += 2;
+    }
+    jx->path_len[jx->depth] = path_len;
+    jx->state = array ? JX_VALUE : JX_KEY_OR_END;
+}
+
+static void pop(jx_parser_t *jx) {
+    jx->depth--;
+    end_value(jx);
+}
+
+static void value_start(jx_parser_t *jx, char c) {
+    char path[JX_PATH_MAX];
+    size_t path_len = value_path(jx, path);
+
+    if (c == '{' || c == '[') {
+        push(jx, path, path_len, c == '[');
+    } else if (c == '"') {
+        begin_value(jx, path, path_len);
+        jx->state = JX_STRING;
+    } else if (c == ']' && in_array(jx)) {
+        pop(jx);  // Empty array
+    } else {
+        begin_value(jx, path, path_len);
+        capture_char(jx, c);
+        jx->state = JX_LITERAL;
+    }
+}
+
+// Handle one byte inside a string (key or value); returns true at the closing quote
+static bool string_byte(jx_parser_t *jx, char c) {
+    if (jx->hex_left) {
+        int v = (c >= '0' && c <= '9') ? c - '0' :
+                (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+                (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (v < 0) {
+            jx->error = true;
+            return false;
+        }
+        jx->codepoint = (jx->codepoint << 4) | v;
+        if (--jx->hex_left == 0) {
+            uint32_t cp = jx->codepoint;
+            if (cp >= 0xD800 && cp < 0xDC00) {
+                jx->high_surrogate = cp;  // Wait for the low half
+            } else if (cp >= 0xDC00 && cp < 0xE000 && jx->high_surrogate) {
+                string_codepoint(jx, 0x10000 + ((jx->high_surrogate - 0xD800) << 10) + (cp - 0xDC00));
+                jx->high_surrogate = 0;
+            } else {
+                string_codepoint(jx, cp);
+                jx->high_surrogate = 0;
+            }
+        }
+        return false;
+    }
+    if (jx->escape) {
+        jx->escape = false;
+        switch (c) {
+        case 'n': string_char(jx, '\n'); break;
+        case 't': string_char(jx, '\t'); break;
+        case 'r': string_char(jx, '\r'); break;
+        case 'b': string_char(jx, '\b'); break;
+        case 'f': string_char(jx, '\f'); break;
+        case 'u': jx->hex_left = 4; jx->codepoint = 0; break;
+        default: string_char(jx, c); break;   // \" \\ \/
+        }
+        return false;
+    }
+    if (c == '\\') {
+        jx->escape = true;
+        return false;
+    }
+    if (c == '"') {
+        return true;
+    }
+    string_char(jx, c);
+    return false;
+}
+
+void jx_reset(jx_parser_t *jx) {
+    jx_field_t *fields = jx->fields;
+    int count = jx->field_count;
+    memset(jx, 0, sizeof(*jx));
+    jx->fields = fields;
+    jx->field_count = count;
+    for (int i = 0; i < count; i++) {
+        fields[i].found = false;
+        if (fields[i].out_size) fields[i].out[0] = 0;
+    }
+}
+
+void jx_init(jx_parser_t *jx, jx_field_t *fields, int field_count) {
+    jx->fields = fields;
+    jx->field_count = field_count;
+    jx_reset(jx);
+}
+
+void jx_feed(jx_parser_t *jx, const char *data, size_t len) {
+    for (size_t i = 0; i < len && !jx->error; i++) {
+        char c = data[i];
+
+        switch (jx->state) {
+        case JX_VALUE:
+            if (!is_space(c)) value_start(jx, c);
+            break;
+
+        case JX_KEY_OR_END:
+            if (c == '"') {
+                jx->key_len = 0;
+                jx->key_overflow = false;
+                jx->state = JX_KEY;
+            } else if (c == '}') {
+                pop(jx);
+            } else if (!is_space(c)) {
+                jx->error = true;
+            }
+            break;
+
+        case JX_KEY:
+            if (string_byte(jx, c)) jx->state = JX_COLON;
+            break;
+
+        case JX_COLON:
+            if (c == ':') {
+                jx->state = JX_VALUE;
+            } else if (!is_space(c)) {
+                jx->error = true;
+            }
+            break;
+
+        case JX_STRING:
+            if (string_byte(jx, c)) end_value(jx);
+            break;
+
+        case JX_LITERAL:
+            if (c == ',' || c == '}' || c == ']' || is_space(c)) {
+                end_value(jx);
+                i--;  // Let the delimiter be handled in the new state
+            } else {
+                capture_char(jx, c);
+            }
+            break;
+
+        case JX_AFTER_VALUE:
+            if (c == ',') {
+                jx->state = in_array(jx) ? JX_VALUE : JX_KEY_OR_END;
+            } else if ((c == '}' && !in_array(jx)) || (c == ']' && in_array(jx))) {
+                pop(jx);
+            } else if (!is_space(c)) {
+                jx->error = true;
+            }
+            break;
+
+        case JX_DONE:
+            if (!is_space(c)) jx->error = true;
+            break;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * Streaming JSON Field Extractor
+ *
+ * Pulls a whitelist of scalar values out of a JSON document fed in
+ * arbitrary chunks (e.g. HTTP_EVENT_ON_DATA), without building a DOM or
+ * allocating. Paths are dot-separated object keys, e.g. "address.road";
+ * values inside arrays are never matched.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef JSON_EXTRACT_H
+#define JSON_EXTRACT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define JX_MAX_DEPTH    16
+#define JX_PATH_MAX     96
+#define JX_KEY_MAX      48
+
+typedef struct {
+    const char *path;       // Dot-separated key path
+    char *out;              // Receives the string (unescaped) or literal text
+    size_t out_size;
+    bool found;
+} jx_field_t;
+
+typedef struct {
+    jx_field_t *fields;
+    int field_count;
+
+    uint8_t state;
+    bool error;
+    uint8_t depth;
+    uint32_t array_mask;            // Bit n set: container at depth n is an array
+    uint8_t path_len[JX_MAX_DEPTH + 1];
+    char path[JX_PATH_MAX];
+
+    char key[JX_KEY_MAX];
+    uint8_t key_len;
+    bool key_overflow;
+
+    bool escape;
+    uint8_t hex_left;
+    uint32_t codepoint;
+    uint32_t high_surrogate;
+
+    jx_field_t *capture;            // Field receiving the current value
+    size_t capture_len;
+} jx_parser_t;
+
+// Bind a field table and reset; clears every field's output
+void jx_init(jx_parser_t *jx, jx_field_t *fields, int field_count);
+
+// Restart parsing with the same field table (e.g. on an HTTP retry)
+void jx_reset(jx_parser_t *jx);
+
+// Consume the next chunk of the document
+void jx_feed(jx_parser_t *jx, const char *data, size_t len);
+
+// True if the input so far was well-formed
+static inline bool jx_ok(const jx_parser_t *jx) {
+    return !jx->error;
+}
+
+#endif // JSON_EXTRACT_H
@@ -0,0 +1,150 @@
+/**
+ * Position Kalman Filter
+ *
+ * With a diagonal measurement noise the east and north axes decouple, so
+ * two 2-state filters replace one 4-state filter: no matrix inversion and
+ * a few dozen flops per fix.
+ * Syquens B.V. - 2026
+ */
+
+#include <math.h>
+#include <string.h>
+#include "config.h"
+#include "kalman.h"
+
+#define KF_EARTH_RADIUS_M   6371000.0
+#define KF_E7_TO_RAD        (M_PI / 180.0 / 1e7)
+
+static void axis_reset(kf_axis_t *a, double pos, double pos_var) {
+    a->pos = pos;
+    a->vel = 0;
+    a->p00 = pos_var;
+    a->p01 = 0;
+    a->p11 = KF_INIT_VEL_SIGMA_MPS * KF_INIT_VEL_SIGMA_MPS;
+}
+
+// x += v*dt, P = F P F' + Q (white-noise acceleration)
+static void axis_predict(kf_axis_t *a, double dt) {
+    double q = KF_ACCEL_SIGMA * KF_ACCEL_SIGMA;
+    a->pos += a->vel * dt;
+    a->p00 += dt * (2 * a->p01 + dt * a->p11) + q * dt * dt * dt / 3;
+    a->p01 += dt * a->p11 + q * dt * dt / 2;
+    a->p11 += q * dt;
+}
+
+static void axis_update_pos(kf_axis_t *a, double z, double r) {
+    double y = z - a->pos;
+    double s = a->p00 + r;
+    double k0 = a->p00 / s, k1 = a->p01 / s;
+    a->pos += k0 * y;
+    a->vel += k1 * y;
+    a->p11 -= k1 * a->p01;
+    a->p01 *= 1 - k0;
+    a->p00 *= 1 - k0;
+}
+
+static void axis_update_vel(kf_axis_t *a, double z, double r) {
+    double y = z - a->vel;
+    double s = a->p11 + r;
+    double k0 = a->p01 / s, k1 = a->p11 / s;
+    a->pos += k0 * y;
+    a->vel += k1 * y;
+    a->p00 -= k0 * a->p01;
+    a->p01 *= 1 - k1;
+    a->p11 *= 1 - k1;
+}
+
+static void to_plane(const kf_context_t *kf, int32_t lat_e7, int32_t lon_e7, double *east, double *north) {
+    *east = (double)(lon_e7 - kf->lon0_e7) * KF_E7_TO_RAD * kf->cos_lat0 * KF_EARTH_RADIUS_M;
+    *north = (double)(lat_e7 - kf->lat0_e7) * KF_E7_TO_RAD * KF_EARTH_RADIUS_M;
+}
+
+static void from_plane(const kf_context_t *kf, double east, double north, int32_t *lat_e7, int32_t *lon_e7) {
+    *lat_e7 = kf->lat0_e7 + (int32_t)lround(north / KF_EARTH_RADIUS_M / KF_E7_TO_RAD);
+    *lon_e7 = kf->lon0_e7 + (int32_t)lround(east / (KF_EARTH_RADIUS_M * kf->cos_lat0) / KF_E7_TO_RAD);
+}
+
+static void set_origin(kf_context_t *kf, int32_t lat_e7, int32_t lon_e7) {
+    kf->lat0_e7 = lat_e7;
+    kf->lon0_e7 = lon_e7;
+    kf->cos_lat0 = cos(lat_e7 * KF_E7_TO_RAD);
+}
+
+// Keep the plane small so the flat-earth projection stays accurate
+static void recenter(kf_context_t *kf) {
+    if (fabs(kf->east.pos) < KF_RECENTER_M && fabs(kf->north.pos) < KF_RECENTER_M) return;
+
+    int32_t lat_e7, lon_e7;
+    from_plane(kf, kf->east.pos, kf->north.pos, &lat_e7, &lon_e7);
+    set_origin(kf, lat_e7, lon_e7);
+    kf->east.pos = 0;
+    kf->north.pos = 0;
+}
+
+static void advance(kf_context_t *kf, int64_t now_us) {
+    double dt = (now_us - kf->last_us) / 1e6;
+    if (dt > 0) {
+        axis_predict(&kf->east, dt);
+        axis_predict(&kf->north, dt);
+    }
+    kf->last_us = now_us;
+}
+
+void kf_init(kf_context_t *kf) {
+    memset(kf, 0, sizeof(*kf));
+    kf->state = KF_STATE_NONE;
+}
+
+void kf_update(kf_context_t *kf, int64_t now_us, int32_t lat_e7, int32_t lon_e7,
+               float hdop, float speed_mps, float course_deg) {
+    double sigma = (hdop > 0 ? hdop : 1.0) * KF_UERE_M;
+    double r = sigma * sigma;
+
+    if (kf->state == KF_STATE_NONE) {
+        set_origin(kf, lat_e7, lon_e7);
+        axis_reset(&kf->east, 0, r);
+        axis_reset(&kf->north, 0, r);
+        kf->last_us = now_us;
+    } else {
+        advance(kf, now_us);
+    }
+
+    double east, north;
+    to_plane(kf, lat_e7, lon_e7, &east, &north);
+    axis_update_pos(&kf->east, east, r);
+    axis_update_pos(&kf->north, north, r);
+
+    if (speed_mps >= 0) {
+        double course = course_deg * M_PI / 180.0;
+        double rv = KF_VEL_SIGMA_MPS * KF_VEL_SIGMA_MPS;
+        axis_update_vel(&kf->east, speed_mps * sin(course), rv);
+        axis_update_vel(&kf->north, speed_mps * cos(course), rv);
+    }
+
+    recenter(kf);
+    kf->state = KF_STATE_FIX;
+    kf->last_fix_us = now_us;
+}
+
+void kf_predict(kf_context_t *kf, int64_t now_us) {
+    if (kf->state == KF_STATE_NONE) return;
+
+    advance(kf, now_us);
+    recenter(kf);
+    kf->state = KF_STATE_DEAD_RECKONING;
+
+    double var = kf->east.p00 + kf->north.p00;
+    if (now_us - kf->last_fix_us > (int64_t)KF_DR_MAX_MS * 1000 ||
+        var > (double)KF_DR_MAX_SIGMA_M * KF_DR_MAX_SIGMA_M) {
+        kf->state = KF_STATE_NONE;
+    }
+}
+
+void kf_get_output(const kf_context_t *kf, kf_output_t *out) {
+    out->state = kf->state;
+    from_plane(kf, kf->east.pos, kf->north.pos, &out->lat_e7, &out->lon_e7);
+    out->speed_mps = (float)hypot(kf->east.vel, kf->north.vel);
+    double course = atan2(kf->east.vel, kf->north.vel) * 180.0 / M_PI;
+    out->course_deg = (float)(course < 0 ? course + 360.0 : course);
+    out->sigma_m = (float)sqrt(kf->east.p00 + kf->north.p00);
+}
@@ -0,0 +1,61 @@
+/**
+ * Position Kalman Filter
+ *
+ * Constant-velocity model in a local east/north plane, one independent
+ * position/velocity filter per axis. Fuses GNSS position (weighted by
+ * HDOP) with RMC speed/course, and dead-reckons through short fix losses.
+ * Double precision, pure logic - no hardware access.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef KALMAN_H
+#define KALMAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    KF_STATE_NONE = 0,          // No estimate yet, or dead reckoning expired
+    KF_STATE_FIX,               // Updated from a fix
+    KF_STATE_DEAD_RECKONING,    // Predicted through a fix loss
+} kf_state_t;
+
+typedef struct {
+    double pos;             // Metres from the origin
+    double vel;             // Metres per second
+    double p00, p01, p11;   // Covariance
+} kf_axis_t;
+
+typedef struct {
+    kf_state_t state;
+    int32_t lat0_e7;        // Plane origin
+    int32_t lon0_e7;
+    double cos_lat0;
+    kf_axis_t east;
+    kf_axis_t north;
+    int64_t last_us;        // Time of the last predict/update
+    int64_t last_fix_us;
+} kf_context_t;
+
+typedef struct {
+    kf_state_t state;
+    int32_t lat_e7;
+    int32_t lon_e7;
+    float speed_mps;
+    float course_deg;
+    float sigma_m;          // 1-sigma horizontal position uncertainty
+} kf_output_t;
+
+void kf_init(kf_context_t *kf);
+
+// Fuse one fix taken at now_us (esp_timer time). speed_mps < 0 = no velocity.
+void kf_update(kf_context_t *kf, int64_t now_us, int32_t lat_e7, int32_t lon_e7,
+               float hdop, float speed_mps, float course_deg);
+
+// Advance without a fix (dead reckoning). Falls back to KF_STATE_NONE after
+// KF_DR_MAX_MS or once the uncertainty exceeds KF_DR_MAX_SIGMA_M.
+void kf_predict(kf_context_t *kf, int64_t now_us);
+
+void kf_get_output(const kf_context_t *kf, kf_output_t *out);
+
+#endif // KALMAN_H
@@ -15,9 +15,12 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
 #include <string.h>
 #include <time.h>
 #include <sys/time.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
@@ -27,16 +30,34 @@
 #include "driver/uart.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_netif.h"
 #include "esp_sntp.h"
+#include "lwip/sockets.h"
 #include "esp_http_client.h"
 #include "mqtt_client.h"
 #include "esp_crt_bundle.h"
 #include "nvs_flash.h"
-#include "cJSON.h"
 #include "config.h"
+#include "ds3231.h"
+#include "geocache.h"
+#include "gps_rx.h"
+#include "hal.h"
+#include "kalman.h"
+#include "json_extract.h"
+#include "metrics.h"
+#include "nmea.h"
+#include "oled.h"
+#include "outbox.h"
+#include "place_index.h"
+#include "ntp_server.h"
+#include "time_discipline.h"
+#include "track_codec.h"
+#include "track_simplify.h"
+#include "tracklog.h"
+#include "ubx.h"
 
 static const char *TAG = "LOCALIZER";
 
@@ -46,41 +67,130 @@ static EventGroupHandle_t s_event_group;
 #define GPS_FIX_BIT             BIT1
 #define RTC_SYNCED_BIT          BIT2
 #define NTP_SYNCED_BIT          BIT3
+#define MQTT_CONNECTED_BIT      BIT4
 
 // Global handles
 static i2c_master_bus_handle_t i2c_bus_handle = NULL;
 static i2c_master_dev_handle_t oled_dev_handle = NULL;
 static i2c_master_dev_handle_t rtc_dev_handle = NULL;
 static esp_mqtt_client_handle_t mqtt_client = NULL;
+static TaskHandle_t mqtt_task_handle = NULL;
+
+// Published topics, referenced by enum everywhere
+typedef enum {
+    TOPIC_GPS = 0,
+    TOPIC_LOCATION,
+    TOPIC_TRACK,
+    TOPIC_STATUS,
+    TOPIC_COUNT,
+} mqtt_topic_t;
+
+static const struct {
+    const char *leaf;
+    int qos;
+    outbox_policy_t policy;
+} mqtt_topic_defs[TOPIC_COUNT] = {
+    [TOPIC_GPS]      = {MQTT_TOPIC_GPS, 1, OUTBOX_POLICY_GPS},
+    [TOPIC_LOCATION] = {MQTT_TOPIC_LOCATION, 1, OUTBOX_POLICY_LOCATION},
+    [TOPIC_TRACK]    = {MQTT_TOPIC_TRACK, 1, OUTBOX_POLICY_TRACK},
+    [TOPIC_STATUS]   = {MQTT_TOPIC_STATUS, 0, OUTBOX_POLICY_STATUS},
+};
+
+// Interned "<base>/<device id>/<leaf>" strings, composed once by mqtt_topics_init
+static char mqtt_topics[TOPIC_COUNT][MQTT_TOPIC_MAX_LEN];
+static int mqtt_outbox_ids[TOPIC_COUNT];
 
 // GPS data structure
 typedef struct {
     bool fix_valid;
     float latitude;
     float longitude;
+    int32_t latitude_e7;    // Degrees * 1e7 (full NMEA precision)
+    int32_t longitude_e7;
     float altitude;
     float hdop;
     int satellites;
     int hour;
     int minute;
     int second;
+    int millisecond;
     int day;
     int month;
     int year;
     float speed_knots;
+    float course_deg;       // Course over ground, degrees true
     char fix_type;  // 0=no fix, 1=GPS, 2=DGPS
+    // Receiver estimates, only reported by UBX NAV-PVT (0 on NMEA)
+    float h_acc_m;          // Horizontal accuracy
+    float v_acc_m;
+    float speed_acc_mps;
+    float vel_north_mps;    // NED velocity
+    float vel_east_mps;
+    float vel_down_mps;
+    uint32_t time_acc_ns;
+    // Kalman-filtered position; est_state says whether it is fix-based or predicted
+    int32_t est_latitude_e7;
+    int32_t est_longitude_e7;
+    float est_sigma_m;      // 1-sigma horizontal uncertainty
+    uint8_t est_state;      // kf_state_t
+    uint32_t seq;           // Incremented on every published epoch
+    int64_t timestamp_us;   // esp_timer time the update was captured
 } gps_data_t;
 
-static gps_data_t gps_data = {0};
+// GPS task's working copy - only touched by gps_task
+static gps_data_t gps_work = {0};
+
+// Shared snapshot, published once per epoch after filtering, guarded by a
+// sequence lock (odd = write in progress).
+// Readers never block the GPS task; they retry if a write overlapped.
+static gps_data_t gps_shared = {0};
+static atomic_uint gps_shared_lock = 0;
+
+// GPS UART ingestion (owned by GPS task; counters read by status reporting)
+static gps_rx_t gps_rx = {0};
+static uint32_t gps_rx_lines = 0;
+
+// Outcome of the boot-time UBX receiver configuration (written once by GPS task)
+static ubx_config_result_t gps_ubx = {0};
+
+// PPS clock discipline state (owned by GPS task)
+static td_context_t td_ctx;
+
+// Position filter state (owned by GPS task)
+static kf_context_t kf_ctx;
+
+// Track log payload bytes handed to MQTT (for the status topic)
+static uint32_t track_bytes_sent = 0;
+
+// Geolocation HTTP connection statistics (written by location task)
+typedef struct {
+    uint32_t requests;
+    uint32_t reused;        // Served over an existing connection
+    uint32_t connects;      // New TCP + TLS handshakes
+    uint32_t failures;
+    uint32_t connect_ms;    // Smoothed handshake time
+    uint32_t request_ms;    // Smoothed request/response time
+} geo_http_stats_t;
+
+static geo_http_stats_t geo_http = {0};
+
+// Track simplification settings (NVS) and state (owned by GPS task)
+static ts_config_t track_simplify_cfg = {
+    .min_distance_m = TRACK_MIN_DISTANCE_M,
+    .max_deviation_m = TRACK_MAX_DEVIATION_M,
+    .heading_deg = TRACK_HEADING_DEG,
+    .max_interval_s = TRACK_MAX_INTERVAL_S,
+    .window = TRACK_WINDOW,
+};
+static ts_context_t track_simplify;
 
 // Location data
 static char location_street[128] = "Initializing...";
 static char location_city[64] = "";
 static char location_country[16] = "";
 
-// Display scroll positions
-static int scroll_pos_line4 = 0;
-static int scroll_pos_line5 = 0;
+// Bumped whenever the location strings change (display re-renders on change)
+static uint32_t location_seq = 0;
 
 // Configuration stored in NVS
 static char config_wifi_ssid[32] = DEFAULT_WIFI_SSID;
@@ -88,6 +198,7 @@ static char config_wifi_pass[64] = DEFAULT_WIFI_PASS;
 static char config_mqtt_broker[128] = MQTT_BROKER_URI;
 static char config_mqtt_user[64] = DEFAULT_MQTT_USER;
 static char config_mqtt_pass[64] = DEFAULT_MQTT_PASS;
+static char config_device_id[32] = DEFAULT_DEVICE_ID;
 static bool gps_debug_enabled = false;
 typedef enum {
     RTC_SYNC_GPS = 0,
@@ -95,337 +206,433 @@ typedef enum {
 } rtc_sync_source_t;
 static rtc_sync_source_t rtc_sync_source = RTC_SYNC_GPS;
 
-// 5x7 font for OLED display
-static const uint8_t font_5x7[][5] = {
-    {0x00, 0x00, 0x00, 0x00, 0x00}, // space (32)
-    {0x00, 0x00, 0x5F, 0x00, 0x00}, // !
-    {0x00, 0x07, 0x00, 0x07, 0x00}, // "
-    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // #
-    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // $
-    {0x23, 0x13, 0x08, 0x64, 0x62}, // %
-    {0x36, 0x49, 0x55, 0x22, 0x50}, // &
-    {0x00, 0x05, 0x03, 0x00, 0x00}, // '
-    {0x00, 0x1C, 0x22, 0x41, 0x00}, // (
-    {0x00, 0x41, 0x22, 0x1C, 0x00}, // )
-    {0x14, 0x08, 0x3E, 0x08, 0x14}, // *
-    {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
-    {0x00, 0x50, 0x30, 0x00, 0x00}, // ,
-    {0x08, 0x08, 0x08, 0x08, 0x08}, // -
-    {0x00, 0x60, 0x60, 0x00, 0x00}, // .
-    {0x20, 0x10, 0x08, 0x04, 0x02}, // /
-    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
-    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
-    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
-    {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
-    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
-    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
-    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
-    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
-    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
-    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
-    {0x00, 0x36, 0x36, 0x00, 0x00}, // :
-    {0x00, 0x56, 0x36, 0x00, 0x00}, // ;
-    {0x08, 0x14, 0x22, 0x41, 0x00}, // <
-    {0x14, 0x14, 0x14, 0x14, 0x14}, // =
-    {0x00, 0x41, 0x22, 0x14, 0x08}, // >
-    {0x02, 0x01, 0x51, 0x09, 0x06}, // ?
-    {0x32, 0x49, 0x79, 0x41, 0x3E}, // @
-    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // A
-    {0x7F, 0x49, 0x49, 0x49, 0x36}, // B
-    {0x3E, 0x41, 0x41, 0x41, 0x22}, // C
-    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D
-    {0x7F, 0x49, 0x49, 0x49, 0x41}, // E
-    {0x7F, 0x09, 0x09, 0x09, 0x01}, // F
-    {0x3E, 0x41, 0x49, 0x49, 0x7A}, // G
-    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H
-    {0x00, 0x41, 0x7F, 0x41, 0x00}, // I
-    {0x20, 0x40, 0x41, 0x3F, 0x01}, // J
-    {0x7F, 0x08, 0x14, 0x22, 0x41}, // K
-    {0x7F, 0x40, 0x40, 0x40, 0x40}, // L
-    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, // M
-    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N
-    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O
-    {0x7F, 0x09, 0x09, 0x09, 0x06}, // P
-    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q
-    {0x7F, 0x09, 0x19, 0x29, 0x46}, // R
-    {0x46, 0x49, 0x49, 0x49, 0x31}, // S
-    {0x01, 0x01, 0x7F, 0x01, 0x01}, // T
-    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U
-    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V
-    {0x3F, 0x40, 0x38, 0x40, 0x3F}, // W
-    {0x63, 0x14, 0x08, 0x14, 0x63}, // X
-    {0x07, 0x08, 0x70, 0x08, 0x07}, // Y
-    {0x61, 0x51, 0x49, 0x45, 0x43}, // Z
-    {0x00, 0x7F, 0x41, 0x41, 0x00}, // [
-    {0x02, 0x04, 0x08, 0x10, 0x20}, // backslash
-    {0x00, 0x41, 0x41, 0x7F, 0x00}, // ]
-    {0x04, 0x02, 0x01, 0x02, 0x04}, // ^
-    {0x40, 0x40, 0x40, 0x40, 0x40}, // _
-};
-
-// OLED frame buffer (72x40 pixels = 72*5 bytes)
-static uint8_t oled_buffer[72 * 5] = {0};
-
 // ============================================================================
-// OLED Display Functions (SSD1306 - 72x40)
+// I2C HAL (ESP-IDF master driver)
 // ============================================================================
 
-#define OLED_PAGES  5
-
-static void oled_write_command(uint8_t cmd) {
-    uint8_t data[2] = {0x00, cmd};
-    i2c_master_transmit(oled_dev_handle, data, 2, 1000);
+static esp_err_t i2c_hal_write(void *ctx, const uint8_t *data, size_t len) {
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = i2c_master_transmit((i2c_master_dev_handle_t)ctx, data, len, I2C_MASTER_TIMEOUT_MS);
+    metrics_record(METRIC_I2C, (uint32_t)(esp_timer_get_time() - start_us), err == ESP_OK);
+    return err;
 }
 
-static void oled_init(void) {
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    oled_write_command(0xAE); // Display off
-    oled_write_command(0xD5); // Set display clock
-    oled_write_command(0x80);
-    oled_write_command(0xA8); // Set multiplex
-    oled_write_command(0x27); // 40 rows
-    oled_write_command(0xD3); // Set display offset
-    oled_write_command(0x00);
-    oled_write_command(0x40); // Set start line
-    oled_write_command(0x8D); // Charge pump
-    oled_write_command(0x14);
-    oled_write_command(0x20); // Memory mode
-    oled_write_command(0x00); // Horizontal
-    oled_write_command(0xA1); // Segment remap
-    oled_write_command(0xC8); // COM scan direction
-    oled_write_command(0xDA); // COM pins
-    oled_write_command(0x12);
-    oled_write_command(0x81); // Contrast
-    oled_write_command(0xCF);
-    oled_write_command(0xD9); // Precharge
-    oled_write_command(0xF1);
-    oled_write_command(0xDB); // VCOM detect
-    oled_write_command(0x40);
-    oled_write_command(0xA4); // Resume display
-    oled_write_command(0xA6); // Normal display
-    oled_write_command(0xAF); // Display on
-    
-    ESP_LOGI(TAG, "OLED initialized");
+static esp_err_t i2c_hal_write_read(void *ctx, const uint8_t *wr, size_t wr_len, uint8_t *rd, size_t rd_len) {
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = i2c_master_transmit_receive((i2c_master_dev_handle_t)ctx, wr, wr_len, rd, rd_len,
+                                                I2C_MASTER_TIMEOUT_MS);
+    metrics_record(METRIC_I2C, (uint32_t)(esp_timer_get_time() - start_us), err == ESP_OK);
+    return err;
 }
 
-static void oled_clear(void) {
-    memset(oled_buffer, 0, sizeof(oled_buffer));
-}
+// Bound to the device handles in app_main
+static hal_i2c_dev_t oled_i2c = { .write = i2c_hal_write, .write_read = i2c_hal_write_read };
+static hal_i2c_dev_t rtc_i2c = { .write = i2c_hal_write, .write_read = i2c_hal_write_read };
 
-static void oled_set_pixel(int x, int y, bool on) {
-    if (x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
-        int page = y / 8;
-        int bit = y % 8;
-        int index = page * DISPLAY_WIDTH + x;
-        
-        if (on) {
-            oled_buffer[index] |= (1 << bit);
-        } else {
-            oled_buffer[index] &= ~(1 << bit);
-        }
-    }
-}
-
-static void oled_draw_char(int x, int y, char c) {
-    if (c < 32 || c > 95) c = 32; // Map to space if out of range
-    
-    const uint8_t *glyph = font_5x7[c - 32];
-    
-    for (int col = 0; col < 5; col++) {
-        for (int row = 0; row < 7; row++) {
-            if (glyph[col] & (1 << row)) {
-                oled_set_pixel(x + col, y + row, true);
-            }
-        }
-    }
-}
-
-static void oled_draw_string(int x, int y, const char *str) {
-    int pos = x;
-    while (*str && pos < DISPLAY_WIDTH) {
-        oled_draw_char(pos, y, *str);
-        pos += 6; // 5 pixels + 1 spacing
-        str++;
-    }
-}
+// Display tickers (owned by display task)
+static oled_ticker_t ticker_gps;
+static oled_ticker_t ticker_location;
 
-static void oled_update(void) {
-    // Set column and page address with X offset for 72x40 visible area on 128x64 display
-    oled_write_command(0x21); // Column address
-    oled_write_command(OLED_X_OFFSET);
-    oled_write_command(OLED_X_OFFSET + DISPLAY_WIDTH - 1);
-    oled_write_command(0x22); // Page address
-    oled_write_command(0x00);
-    oled_write_command(OLED_PAGES - 1);
-    
-    // Send data
-    for (int page = 0; page < OLED_PAGES; page++) {
-        uint8_t data[DISPLAY_WIDTH + 1];
-        data[0] = 0x40; // Data mode
-        memcpy(&data[1], &oled_buffer[page * DISPLAY_WIDTH], DISPLAY_WIDTH);
-        i2c_master_transmit(oled_dev_handle, data, DISPLAY_WIDTH + 1, 1000);
-    }
-}
+// Display I2C traffic, bytes per second (display task)
+static uint32_t oled_bus_bytes_per_sec = 0;
 
 // ============================================================================
 // RTC Functions (DS3231)
 // ============================================================================
 
-#define DS3231_ADDR 0x68
-#define DS3231_REG_SEC    0x00
-#define DS3231_REG_MIN    0x01
-#define DS3231_REG_HOUR   0x02
-#define DS3231_REG_DAY    0x04
-#define DS3231_REG_MONTH  0x05
-#define DS3231_REG_YEAR   0x06
-
-static uint8_t bcd_to_dec(uint8_t val) {
-    return (val / 16 * 10) + (val % 16);
-}
-
-static uint8_t dec_to_bcd(uint8_t val) {
-    return (val / 10 * 16) + (val % 10);
+// Last successful time read/write, for bus-free interpolation
+static int64_t rtc_cache_unix = 0;
+static int64_t rtc_cache_tick_us = 0;
+static bool rtc_cache_valid = false;
+static portMUX_TYPE rtc_cache_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void rtc_cache_store(int64_t unix_sec, int64_t tick_us) {
+    portENTER_CRITICAL(&rtc_cache_lock);
+    rtc_cache_unix = unix_sec;
+    rtc_cache_tick_us = tick_us;
+    rtc_cache_valid = true;
+    portEXIT_CRITICAL(&rtc_cache_lock);
 }
 
-static void rtc_write_reg(uint8_t reg, uint8_t val) {
-    uint8_t data[2] = {reg, val};
-    i2c_master_transmit(rtc_dev_handle, data, 2, 1000);
+static esp_err_t rtc_set_time(int year, int month, int day, int hour, int min, int sec) {
+    ds3231_time_t t = {year, month, day, hour, min, sec};
+    esp_err_t err = ds3231_set_time(&t);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "RTC write failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    rtc_cache_store(td_utc_to_unix(year, month, day, hour, min, sec), esp_timer_get_time());
+    
+    ESP_LOGI(TAG, "RTC set to %04d-%02d-%02d %02d:%02d:%02d", 
+             year, month, day, hour, min, sec);
+    return ESP_OK;
 }
 
-static uint8_t rtc_read_reg(uint8_t reg) {
-    uint8_t data = reg;
-    uint8_t val = 0;
+static esp_err_t rtc_get_time(ds3231_time_t *t) {
+    esp_err_t err = ds3231_get_time(t);
+    int64_t tick_us = esp_timer_get_time();
+    if (err != ESP_OK) return err;
     
-    i2c_master_transmit(rtc_dev_handle, &data, 1, 1000);
-    i2c_master_receive(rtc_dev_handle, &val, 1, 1000);
-    
-    return val;
+    rtc_cache_store(td_utc_to_unix(t->year, t->month, t->day, t->hour, t->minute, t->second), tick_us);
+    return ESP_OK;
 }
 
-static void rtc_set_time(int year, int month, int day, int hour, int min, int sec) {
-    rtc_write_reg(DS3231_REG_SEC, dec_to_bcd(sec));
-    rtc_write_reg(DS3231_REG_MIN, dec_to_bcd(min));
-    rtc_write_reg(DS3231_REG_HOUR, dec_to_bcd(hour));
-    rtc_write_reg(DS3231_REG_DAY, dec_to_bcd(day));
-    rtc_write_reg(DS3231_REG_MONTH, dec_to_bcd(month));
-    rtc_write_reg(DS3231_REG_YEAR, dec_to_bcd(year - 2000));
-    
-    ESP_LOGI(TAG, "RTC set to %04d-%02d-%02d %02d:%02d:%02d", 
-             year, month, day, hour, min, sec);
+// Interpolated RTC time from the last read/write - no bus access
+static bool rtc_get_cached_time_us(int64_t *unix_us) {
+    portENTER_CRITICAL(&rtc_cache_lock);
+    bool valid = rtc_cache_valid;
+    int64_t base = rtc_cache_unix * 1000000LL;
+    int64_t tick = rtc_cache_tick_us;
+    portEXIT_CRITICAL(&rtc_cache_lock);
+    
+    if (!valid) return false;
+    *unix_us = base + (esp_timer_get_time() - tick);
+    return true;
 }
 
-static void rtc_get_time(int *year, int *month, int *day, int *hour, int *min, int *sec) {
-    *sec = bcd_to_dec(rtc_read_reg(DS3231_REG_SEC));
-    *min = bcd_to_dec(rtc_read_reg(DS3231_REG_MIN));
-    *hour = bcd_to_dec(rtc_read_reg(DS3231_REG_HOUR) & 0x3F);
-    *day = bcd_to_dec(rtc_read_reg(DS3231_REG_DAY));
-    *month = bcd_to_dec(rtc_read_reg(DS3231_REG_MONTH) & 0x1F);
-    *year = bcd_to_dec(rtc_read_reg(DS3231_REG_YEAR)) + 2000;
+static void rtc_init(void) {
+    ds3231_init(&rtc_i2c);
+    bool stopped = false;
+    esp_err_t err = ds3231_oscillator_stopped(&stopped);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "RTC not responding: %s", esp_err_to_name(err));
+        return;
+    }
+    if (stopped) {
+        ESP_LOGW(TAG, "RTC oscillator stopped (OSF set) - time invalid until synced");
+        return;
+    }
+    
+    ds3231_time_t t;
+    if (rtc_get_time(&t) == ESP_OK) {
+        ESP_LOGI(TAG, "RTC initialized: %04d-%02d-%02d %02d:%02d:%02d",
+                 t.year, t.month, t.day, t.hour, t.minute, t.second);
+    } else {
+        ESP_LOGE(TAG, "RTC not responding");
+    }
 }
 
 // ============================================================================
 // GPS NMEA Parsing
 // ============================================================================
 
-static float nmea_to_decimal(const char *coord, char dir) {
-    if (!coord || strlen(coord) == 0) return 0.0;
-    
-    // Parse DDMM.MMMM format
-    float value = atof(coord);
-    int degrees = (int)(value / 100);
-    float minutes = value - (degrees * 100);
-    float decimal = degrees + (minutes / 60.0);
-    
-    if (dir == 'S' || dir == 'W') {
-        decimal = -decimal;
+// Set when an RMC with valid time was parsed; consumed by the PPS pairing,
+// which hands it on to the track log at the end of the epoch
+static bool gps_rmc_time_fresh = false;
+static bool gps_epoch_time_fresh = false;
+
+// Set once all of an epoch's sentences are in (NMEA) or on each NAV-PVT;
+// consumed by the fix notifier
+static bool gps_epoch_ready = false;
+
+// UTC time (ms of day) of this epoch's RMC and GGA, as they arrive
+#define GPS_EPOCH_NONE      (-1)    // Not seen yet
+#define GPS_EPOCH_NO_TIME   (-2)    // Seen with an empty time (no fix yet)
+static int32_t gps_epoch_rmc = GPS_EPOCH_NONE;
+static int32_t gps_epoch_gga = GPS_EPOCH_NONE;
+static bool gps_rmc_only = false;   // Receiver stopped sending GGA
+
+// RMC and GGA of one epoch carry the same UTC time; the epoch closes on
+// whichever of the two arrives second, so the filter and the track log
+// get that epoch's HDOP, altitude and satellites. Without GGA every RMC
+// closes an epoch on its own.
+static void gps_epoch_sentence(const nmea_field_t *time, bool rmc) {
+    int hour, minute, second, millis;
+    int32_t t = nmea_parse_time(time, &hour, &minute, &second, &millis) ?
+                ((hour * 60 + minute) * 60 + second) * 1000 + millis : GPS_EPOCH_NO_TIME;
+    if (rmc) {
+        if (gps_epoch_rmc != GPS_EPOCH_NONE) {
+            gps_rmc_only = true;    // The previous RMC never got its GGA
+        }
+        gps_epoch_rmc = t;
+    } else {
+        gps_epoch_gga = t;
+        gps_rmc_only = false;
     }
     
-    return decimal;
+    if ((gps_epoch_rmc != GPS_EPOCH_NONE && gps_epoch_rmc == gps_epoch_gga) || (rmc && gps_rmc_only)) {
+        gps_epoch_ready = true;
+        gps_epoch_rmc = GPS_EPOCH_NONE;
+        gps_epoch_gga = GPS_EPOCH_NONE;
+    }
 }
 
-static void parse_gprmc(const char *sentence) {
+static void parse_gprmc(const nmea_sentence_t *s) {
     // $GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A
-    char *tokens[15];
-    char buffer[256];
-    strncpy(buffer, sentence, sizeof(buffer) - 1);
-    
-    int count = 0;
-    char *ptr = strtok(buffer, ",");
-    while (ptr && count < 15) {
-        tokens[count++] = ptr;
-        ptr = strtok(NULL, ",");
-    }
-    
-    if (count < 10) return;
+    if (s->count < 10) return;
+    gps_epoch_sentence(&s->fields[1], true);
     
     // Check validity
-    if (tokens[2][0] == 'A') {
-        gps_data.fix_valid = true;
+    if (nmea_field_char(&s->fields[2]) == 'A') {
+        gps_work.fix_valid = true;
         xEventGroupSetBits(s_event_group, GPS_FIX_BIT);
         
-        // Parse time (hhmmss)
-        if (strlen(tokens[1]) >= 6) {
-            char tmp[3] = {0};
-            strncpy(tmp, tokens[1], 2); gps_data.hour = atoi(tmp);
-            strncpy(tmp, tokens[1] + 2, 2); gps_data.minute = atoi(tmp);
-            strncpy(tmp, tokens[1] + 4, 2); gps_data.second = atoi(tmp);
+        // Parse time (hhmmss.ss)
+        if (nmea_parse_time(&s->fields[1], &gps_work.hour, &gps_work.minute,
+                            &gps_work.second, &gps_work.millisecond)) {
+            gps_rmc_time_fresh = true;
         }
         
         // Parse date (ddmmyy)
-        if (strlen(tokens[9]) >= 6) {
-            char tmp[3] = {0};
-            strncpy(tmp, tokens[9], 2); gps_data.day = atoi(tmp);
-            strncpy(tmp, tokens[9] + 2, 2); gps_data.month = atoi(tmp);
-            strncpy(tmp, tokens[9] + 4, 2); gps_data.year = 2000 + atoi(tmp);
+        nmea_parse_date(&s->fields[9], &gps_work.day, &gps_work.month, &gps_work.year);
+        
+        // Parse position (fixed-point 1e-7 degrees)
+        if (nmea_parse_coord(&s->fields[3], &s->fields[4], &gps_work.latitude_e7)) {
+            gps_work.latitude = gps_work.latitude_e7 / 1e7f;
+        }
+        if (nmea_parse_coord(&s->fields[5], &s->fields[6], &gps_work.longitude_e7)) {
+            gps_work.longitude = gps_work.longitude_e7 / 1e7f;
+        }
+        
+        // Speed over ground (0.01 knot units)
+        int32_t speed_centi;
+        if (nmea_parse_fixed(&s->fields[7], 2, &speed_centi)) {
+            gps_work.speed_knots = speed_centi / 100.0f;
         }
         
-        // Parse position
-        gps_data.latitude = nmea_to_decimal(tokens[3], tokens[4][0]);
-        gps_data.longitude = nmea_to_decimal(tokens[5], tokens[6][0]);
-        gps_data.speed_knots = atof(tokens[7]);
+        // Course over ground (empty when stationary)
+        int32_t course_centi;
+        if (nmea_parse_fixed(&s->fields[8], 2, &course_centi)) {
+            gps_work.course_deg = course_centi / 100.0f;
+        }
     } else {
-        gps_data.fix_valid = false;
+        gps_work.fix_valid = false;
         xEventGroupClearBits(s_event_group, GPS_FIX_BIT);
     }
 }
 
-static void parse_gpgga(const char *sentence) {
+static void parse_gpgga(const nmea_sentence_t *s) {
     // $GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47
-    char *tokens[15];
-    char buffer[256];
-    strncpy(buffer, sentence, sizeof(buffer) - 1);
-    
-    int count = 0;
-    char *ptr = strtok(buffer, ",");
-    while (ptr && count < 15) {
-        tokens[count++] = ptr;
-        ptr = strtok(NULL, ",");
-    }
+    if (s->count < 10) return;
+    gps_epoch_sentence(&s->fields[1], false);
     
-    if (count < 10) return;
+    uint32_t value;
+    int32_t fixed;
     
     // Get fix quality (0=no fix, 1=GPS, 2=DGPS)
-    gps_data.fix_type = atoi(tokens[6]);
+    gps_work.fix_type = nmea_parse_uint(&s->fields[6], &value) ? (char)value : 0;
     
     // Get satellite count
-    gps_data.satellites = atoi(tokens[7]);
+    gps_work.satellites = nmea_parse_uint(&s->fields[7], &value) ? (int)value : 0;
     
     // Get HDOP (horizontal dilution of precision)
-    gps_data.hdop = atof(tokens[8]);
+    if (nmea_parse_fixed(&s->fields[8], 2, &fixed)) {
+        gps_work.hdop = fixed / 100.0f;
+    }
     
     // Get altitude
-    gps_data.altitude = atof(tokens[9]);
+    if (nmea_parse_fixed(&s->fields[9], 1, &fixed)) {
+        gps_work.altitude = fixed / 10.0f;
+    }
+}
+
+// Publish the working copy as one consistent snapshot (GPS task only)
+static void gps_snapshot_publish(void) {
+    gps_work.seq++;
+    gps_work.timestamp_us = esp_timer_get_time();
+    
+    unsigned lock = atomic_load_explicit(&gps_shared_lock, memory_order_relaxed);
+    atomic_store_explicit(&gps_shared_lock, lock + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&gps_shared, &gps_work, sizeof(gps_shared));
+    atomic_store_explicit(&gps_shared_lock, lock + 2, memory_order_release);
+}
+
+// Copy the latest snapshot; returns its sequence number
+static uint32_t gps_snapshot_read(gps_data_t *out) {
+    unsigned before, after;
+    do {
+        before = atomic_load_explicit(&gps_shared_lock, memory_order_acquire);
+        memcpy(out, &gps_shared, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&gps_shared_lock, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return out->seq;
+}
+
+// ============================================================================
+// Fix Notification Pipeline
+// ============================================================================
+
+// Consumer tasks, registered before gps_task starts, woken once per epoch
+static TaskHandle_t gps_subscribers[GPS_MAX_SUBSCRIBERS];
+static int gps_subscriber_count = 0;
+
+static void gps_subscribe(TaskHandle_t task) {
+    if (task && gps_subscriber_count < GPS_MAX_SUBSCRIBERS) {
+        gps_subscribers[gps_subscriber_count++] = task;
+    }
 }
 
-static void parse_nmea_sentence(const char *sentence) {
-    if (strncmp(sentence, "$GPRMC", 6) == 0 || strncmp(sentence, "$GNRMC", 6) == 0) {
-        parse_gprmc(sentence);
-    } else if (strncmp(sentence, "$GPGGA", 6) == 0 || strncmp(sentence, "$GNGGA", 6) == 0) {
-        parse_gpgga(sentence);
+static void gps_notify_subscribers(void) {
+    for (int i = 0; i < gps_subscriber_count; i++) {
+        xTaskNotifyGive(gps_subscribers[i]);
     }
 }
 
+// Per-consumer rate policy, evaluated on each notified fix
+typedef enum {
+    FIX_POLICY_EVERY = 0,    // Every fix
+    FIX_POLICY_ON_CHANGE,    // Position or fix state changed
+    FIX_POLICY_THRESHOLD,    // Moved min_distance_m or turned min_heading_deg
+} fix_policy_mode_t;
+
+typedef struct {
+    fix_policy_mode_t mode;
+    float min_distance_m;
+    float min_heading_deg;   // 0 = ignore heading
+    uint32_t min_interval_ms;
+    uint32_t max_interval_ms;  // Fire anyway after this long (0 = never)
+    // State of the last accepted fix
+    bool has_last;
+    bool last_valid;
+    int32_t last_lat_e7;
+    int32_t last_lon_e7;
+    float last_course;
+    uint32_t last_ms;
+} fix_policy_t;
+
+// Equirectangular distance; accurate to well under 1% at these ranges
+static float gps_distance_m(int32_t lat1_e7, int32_t lon1_e7, int32_t lat2_e7, int32_t lon2_e7) {
+    const float e7_to_rad = (float)M_PI / 180.0f / 1e7f;
+    float mean_lat = ((float)lat1_e7 + (float)lat2_e7) * 0.5f * e7_to_rad;
+    float dx = (float)(lon2_e7 - lon1_e7) * e7_to_rad * cosf(mean_lat);
+    float dy = (float)(lat2_e7 - lat1_e7) * e7_to_rad;
+    return 6371000.0f * sqrtf(dx * dx + dy * dy);
+}
+
+static bool fix_policy_due(fix_policy_t *p, const gps_data_t *gps, uint32_t now_ms) {
+    bool due;
+    uint32_t elapsed = now_ms - p->last_ms;
+    
+    if (!p->has_last || gps->fix_valid != p->last_valid) {
+        due = true;
+    } else if (p->min_interval_ms && elapsed < p->min_interval_ms) {
+        due = false;
+    } else if (p->max_interval_ms && elapsed >= p->max_interval_ms) {
+        due = true;
+    } else if (p->mode == FIX_POLICY_EVERY) {
+        due = true;
+    } else if (p->mode == FIX_POLICY_ON_CHANGE) {
+        due = gps->latitude_e7 != p->last_lat_e7 || gps->longitude_e7 != p->last_lon_e7;
+    } else {
+        due = gps_distance_m(p->last_lat_e7, p->last_lon_e7,
+                             gps->latitude_e7, gps->longitude_e7) >= p->min_distance_m;
+        if (!due && p->min_heading_deg > 0 && gps->speed_knots >= GPS_HEADING_MIN_SPEED_KN) {
+            float turn = fabsf(gps->course_deg - p->last_course);
+            if (turn > 180.0f) turn = 360.0f - turn;
+            due = turn >= p->min_heading_deg;
+        }
+    }
+    
+    if (due) {
+        p->has_last = true;
+        p->last_valid = gps->fix_valid;
+        p->last_lat_e7 = gps->latitude_e7;
+        p->last_lon_e7 = gps->longitude_e7;
+        p->last_course = gps->course_deg;
+        p->last_ms = now_ms;
+    }
+    return due;
+}
+
+// Sentence handlers, keyed on sentence type (any supported talker).
+// GSA/GSV/VTG support is added here as extra rows.
+static const nmea_handler_t nmea_handlers[] = {
+    { NMEA_TYPE('R', 'M', 'C'), parse_gprmc },
+    { NMEA_TYPE('G', 'G', 'A'), parse_gpgga },
+};
+
+// Parser counters (written by GPS task only)
+static nmea_stats_t nmea_stats = {0};
+
+static void parse_nmea_sentence(const char *sentence, size_t len) {
+    nmea_result_t res = nmea_dispatch(sentence, len, nmea_handlers,
+                                      sizeof(nmea_handlers) / sizeof(nmea_handlers[0]),
+                                      &nmea_stats);
+    
+    if (res == NMEA_ERR_CHECKSUM && gps_debug_enabled) {
+        ESP_LOGW(TAG, "NMEA checksum mismatch: %.*s", (int)len, sentence);
+    }
+}
+
+// ============================================================================
+// GPS UBX Decoding (NAV-PVT)
+// ============================================================================
+
+// Binary frame parser (GPS task only)
+static ubx_parser_t gps_ubx_parser;
+
+// RMC/GGA are muted only once a NAV-PVT frame has decoded; a receiver that
+// ACKs NAV-PVT without sending it is put back on NMEA (GPS task only)
+static bool gps_nav_pvt_seen = false;
+static bool gps_nmea_fix_muted = false;
+static int64_t gps_nav_pvt_deadline_us = 0;
+
+// UTC fields are rounded to the second and nano corrects them; apply the
+// correction at millisecond resolution so whole-second epochs stay at .000
+static void gps_set_utc(int year, int month, int day, int hour, int min, int sec,
+                        int32_t nano, uint32_t t_acc_ns) {
+    int64_t x = (int64_t)nano + 500000;
+    int64_t total_ms = td_utc_to_unix(year, month, day, hour, min, sec) * 1000 +
+                       (x >= 0 ? x / 1000000 : -((-x + 999999) / 1000000));
+    time_t t = (time_t)(total_ms / 1000);
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    
+    gps_work.year = tm.tm_year + 1900;
+    gps_work.month = tm.tm_mon + 1;
+    gps_work.day = tm.tm_mday;
+    gps_work.hour = tm.tm_hour;
+    gps_work.minute = tm.tm_min;
+    gps_work.second = tm.tm_sec;
+    gps_work.millisecond = (int)(total_ms % 1000);
+    gps_work.time_acc_ns = t_acc_ns;
+}
+
+// One NAV-PVT per epoch carries everything RMC + GGA did, plus accuracies
+static void parse_ubx_nav_pvt(const ubx_nav_pvt_t *pvt) {
+    gps_epoch_ready = true;
+    
+    bool fix_ok = (pvt->flags & UBX_PVT_FLAGS_FIX_OK) && pvt->fix_type >= 2 && pvt->fix_type <= 4;
+    gps_work.fix_valid = fix_ok;
+    gps_work.fix_type = fix_ok ? ((pvt->flags & UBX_PVT_FLAGS_DIFF) ? 2 : 1) : 0;
+    gps_work.satellites = pvt->num_sv;
+    gps_work.hdop = pvt->p_dop / 100.0f;  // Only PDOP is reported; h_acc_m is better
+    
+    if (!fix_ok) {
+        xEventGroupClearBits(s_event_group, GPS_FIX_BIT);
+        return;
+    }
+    xEventGroupSetBits(s_event_group, GPS_FIX_BIT);
+    
+    const uint8_t time_ok = UBX_PVT_VALID_DATE | UBX_PVT_VALID_TIME;
+    if ((pvt->valid & time_ok) == time_ok) {
+        gps_set_utc(pvt->year, pvt->month, pvt->day, pvt->hour, pvt->min, pvt->sec,
+                    pvt->nano, pvt->t_acc);
+        gps_rmc_time_fresh = true;
+    }
+    
+    gps_work.latitude_e7 = pvt->lat;
+    gps_work.longitude_e7 = pvt->lon;
+    gps_work.latitude = pvt->lat / 1e7f;
+    gps_work.longitude = pvt->lon / 1e7f;
+    gps_work.altitude = pvt->h_msl / 1000.0f;
+    gps_work.speed_knots = pvt->g_speed / 514.444f;
+    gps_work.course_deg = pvt->head_mot / 1e5f;
+    gps_work.h_acc_m = pvt->h_acc / 1000.0f;
+    gps_work.v_acc_m = pvt->v_acc / 1000.0f;
+    gps_work.speed_acc_mps = pvt->s_acc / 1000.0f;
+    gps_work.vel_north_mps = pvt->vel_n / 1000.0f;
+    gps_work.vel_east_mps = pvt->vel_e / 1000.0f;
+    gps_work.vel_down_mps = pvt->vel_d / 1000.0f;
+}
+
+static void parse_ubx_nav_timeutc(const ubx_nav_timeutc_t *tu) {
+    if (!(tu->valid & UBX_TIMEUTC_VALID_UTC)) return;
+    gps_set_utc(tu->year, tu->month, tu->day, tu->hour, tu->min, tu->sec, tu->nano, tu->t_acc);
+}
+
 // ============================================================================
 // WiFi Event Handler
 // ============================================================================
@@ -494,6 +701,14 @@ static void time_sync_notification_cb(struct timeval *tv) {
     ESP_LOGI(TAG, "NTP time synchronized");
     xEventGroupSetBits(s_event_group, NTP_SYNCED_BIT);
     
+    // Serve time to LAN clients as stratum 2, referencing the upstream server
+    uint32_t refid = NTP_REFID('N', 'T', 'P', 0);
+    const ip_addr_t *upstream = esp_sntp_getserver(0);
+    if (upstream && IP_IS_V4(upstream)) {
+        refid = ntohl(ip4_addr_get_u32(ip_2_ip4(upstream)));
+    }
+    ntp_server_set_reference(NTP_STRATUM_NTP, refid, tv, NTP_SERVER_NTP_DISPERSION_US);
+    
     // Update RTC from NTP if NTP sync is selected
     if (rtc_sync_source == RTC_SYNC_NTP) {
         time_t now = tv->tv_sec;
@@ -527,9 +742,22 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
     switch ((esp_mqtt_event_id_t)event_id) {
     case MQTT_EVENT_CONNECTED:
         ESP_LOGI(TAG, "MQTT connected");
+        xEventGroupSetBits(s_event_group, MQTT_CONNECTED_BIT);
+        if (mqtt_task_handle) xTaskNotifyGive(mqtt_task_handle);  // Flush the outbox
         break;
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGI(TAG, "MQTT disconnected");
+        xEventGroupClearBits(s_event_group, MQTT_CONNECTED_BIT);
+        if (mqtt_task_handle) xTaskNotifyGive(mqtt_task_handle);  // Take back in-flight messages
+        break;
+    case MQTT_EVENT_PUBLISHED:
+        outbox_acked(event->msg_id);
+        if (mqtt_task_handle) xTaskNotifyGive(mqtt_task_handle);  // A slot is free
+        break;
+    case MQTT_EVENT_DELETED:
+        // Expired in the client's outbox without a PUBACK; outbox.c requeues it
+        outbox_failed(event->msg_id);
+        if (mqtt_task_handle) xTaskNotifyGive(mqtt_task_handle);
         break;
     case MQTT_EVENT_ERROR:
         ESP_LOGE(TAG, "MQTT error");
@@ -553,13 +781,23 @@ static void serial_print_menu(void) {
     printf("║  3. GPS Debug Output                           ║\n");
     printf("║  4. View Current Settings                      ║\n");
     printf("║  5. Save Settings to NVS                       ║\n");
-    printf("║  6. Reboot Device                              ║\n");
+    printf("║  6. Track Simplification                       ║\n");
+    printf("║  7. Reboot Device                              ║\n");
     printf("║                                                ║\n");
     printf("║  Q. Quit Menu                                  ║\n");
     printf("╚════════════════════════════════════════════════╝\n");
     printf("Enter choice: ");
 }
 
+// A device ID is one MQTT topic level: printable, no spaces, '/', '+' or '#'
+static bool device_id_valid(const char *id) {
+    if (*id == '\0') return false;
+    for (const char *c = id; *c; c++) {
+        if (*c <= ' ' || *c > '~' || *c == '/' || *c == '+' || *c == '#') return false;
+    }
+    return true;
+}
+
 static void serial_configure_mqtt(void) {
     char input[128];
     
@@ -601,6 +839,21 @@ static void serial_configure_mqtt(void) {
         }
     }
     
+    printf("Current device ID: %s\n", config_device_id);
+    printf("Enter new device ID (or press Enter to keep): ");
+    fflush(stdout);
+    
+    if (fgets(input, sizeof(input), stdin) != NULL) {
+        input[strcspn(input, "\n")] = 0;
+        if (strlen(input) >= sizeof(config_device_id) || (strlen(input) > 0 && !device_id_valid(input))) {
+            printf("Invalid device ID (max %d chars, no spaces, '/', '+' or '#')\n",
+                   (int)sizeof(config_device_id) - 1);
+        } else if (strlen(input) > 0) {
+            strcpy(config_device_id, input);
+            printf("Device ID updated to: %s (topics change after reboot)\n", config_device_id);
+        }
+    }
+    
     printf("\nMQTT configuration updated (remember to save with option 5)\n");
 }
 
@@ -650,19 +903,178 @@ static void serial_configure_gps_debug(void) {
     }
 }
 
+// Prompt for one numeric setting; keeps the current value on empty input
+static void serial_prompt_float(const char *label, float *value, float min, float max) {
+    char input[16];
+    
+    printf("%s [%.0f]: ", label, *value);
+    fflush(stdout);
+    if (fgets(input, sizeof(input), stdin) != NULL && input[0] != '\n') {
+        float v = strtof(input, NULL);
+        if (v >= min && v <= max) {
+            *value = v;
+        } else {
+            printf("Out of range (%.0f-%.0f), unchanged\n", min, max);
+        }
+    }
+}
+
+static void serial_configure_track(void) {
+    float window = track_simplify_cfg.window;
+    float interval = track_simplify_cfg.max_interval_s;
+    
+    printf("\n=== Track Simplification ===\n");
+    serial_prompt_float("Min distance (m)", &track_simplify_cfg.min_distance_m, 0, 1000);
+    serial_prompt_float("Max deviation (m)", &track_simplify_cfg.max_deviation_m, 0, 1000);
+    serial_prompt_float("Heading change (deg, 0=off)", &track_simplify_cfg.heading_deg, 0, 180);
+    serial_prompt_float("Max interval (s, 0=off)", &interval, 0, 3600);
+    serial_prompt_float("Window (points)", &window, 3, TS_WINDOW_MAX);
+    track_simplify_cfg.max_interval_s = (uint32_t)interval;
+    track_simplify_cfg.window = (uint8_t)window;
+    
+    printf("\nTrack settings updated (save with option 5, applied after reboot)\n");
+}
+
 static void serial_view_settings(void) {
+    gps_data_t gps;
+    gps_snapshot_read(&gps);
+    
     printf("\n=== Current Settings ===\n");
     printf("MQTT Broker:    %s\n", config_mqtt_broker);
     printf("MQTT Username:  %s\n", config_mqtt_user);
     printf("MQTT Password:  %s\n", config_mqtt_pass);
+    printf("Device ID:      %s (%s/%s/...)\n", config_device_id, MQTT_TOPIC_BASE, config_device_id);
     printf("RTC Sync:       %s\n", rtc_sync_source == RTC_SYNC_GPS ? "GPS" : "WiFi/NTP");
     printf("GPS Debug:      %s\n", gps_debug_enabled ? "ENABLED" : "DISABLED");
+    printf("Track filter:   %.0f m min, %.0f m dev, %.0f deg, %lu s, %u pts\n",
+           track_simplify_cfg.min_distance_m, track_simplify_cfg.max_deviation_m,
+           track_simplify_cfg.heading_deg, (unsigned long)track_simplify_cfg.max_interval_s,
+           track_simplify_cfg.window);
     printf("\nGPS Status:\n");
-    printf("  Fix:          %s\n", gps_data.fix_valid ? "VALID" : "NO FIX");
-    printf("  Satellites:   %d\n", gps_data.satellites);
-    printf("  Latitude:     %.6f\n", gps_data.latitude);
-    printf("  Longitude:    %.6f\n", gps_data.longitude);
-    printf("  Time:         %02d:%02d:%02d\n", gps_data.hour, gps_data.minute, gps_data.second);
+    printf("  Fix:          %s\n", gps.fix_valid ? "VALID" : "NO FIX");
+    printf("  Satellites:   %d\n", gps.satellites);
+    printf("  Latitude:     %.6f\n", gps.latitude);
+    printf("  Longitude:    %.6f\n", gps.longitude);
+    printf("  Time:         %02d:%02d:%02d\n", gps.hour, gps.minute, gps.second);
+    if (gps_ubx.responding) {
+        printf("  Receiver:     %lu baud, %u ms epoch, %s (%u ack, %u nak, %u timeout)\n",
+               (unsigned long)gps_ubx.baud, gps_ubx.meas_rate_ms, gps_ubx.nav_pvt ? "NAV-PVT" : "NMEA",
+               gps_ubx.acks, gps_ubx.naks, gps_ubx.timeouts);
+        if (gps_ubx.nav_pvt) {
+            printf("  Accuracy:     %.1f m horiz, %.1f m vert, %lu ns time\n",
+                   gps.h_acc_m, gps.v_acc_m, (unsigned long)gps.time_acc_ns);
+            printf("  UBX frames:   %lu (bad checksum %lu)\n", (unsigned long)gps_ubx_parser.frames,
+                   (unsigned long)gps_ubx_parser.checksum_errors);
+        }
+    } else {
+        printf("  Receiver:     %lu baud, not configured (no UBX reply)\n", (unsigned long)gps_ubx.baud);
+    }
+    static const char *td_state_names[] = {"UNLOCKED", "ACQUIRING", "LOCKED", "HOLDOVER"};
+    float rtc_temp = 0;
+    int8_t rtc_aging = 0;
+    int64_t rtc_now_us = 0;
+    printf("\nRTC (DS3231):\n");
+    if (rtc_get_cached_time_us(&rtc_now_us)) {
+        time_t rtc_sec = (time_t)(rtc_now_us / 1000000LL);
+        struct tm rtc_tm;
+        gmtime_r(&rtc_sec, &rtc_tm);
+        printf("  Time (UTC):   %02d:%02d:%02d (cached)\n", rtc_tm.tm_hour, rtc_tm.tm_min, rtc_tm.tm_sec);
+    }
+    bool rtc_stopped = false;
+    if (ds3231_oscillator_stopped(&rtc_stopped) == ESP_OK) {
+        printf("  Oscillator:   %s\n", rtc_stopped ? "STOPPED (OSF)" : "OK");
+    } else {
+        printf("  Oscillator:   no response\n");
+    }
+    if (ds3231_get_temperature(&rtc_temp) == ESP_OK) {
+        printf("  Temperature:  %.2f C\n", rtc_temp);
+    }
+    if (ds3231_get_aging_offset(&rtc_aging) == ESP_OK) {
+        printf("  Aging offset: %d\n", rtc_aging);
+    }
+    printf("\nPPS Discipline:\n");
+    printf("  State:        %s\n", td_state_names[td_ctx.state]);
+    printf("  Offset:       %ld us (jitter %lu us)\n", (long)td_ctx.last_offset_us, (unsigned long)td_ctx.jitter_us);
+    printf("  Frequency:    %ld ppb\n", (long)td_ctx.freq_ppb);
+    printf("  Samples:      %lu (steps %lu)\n", (unsigned long)td_ctx.samples, (unsigned long)td_ctx.steps);
+    printf("\nPosition Filter:\n");
+    printf("  State:        %s\n", gps.est_state == KF_STATE_FIX ? "FIX" :
+           gps.est_state == KF_STATE_DEAD_RECKONING ? "DEAD RECKONING" : "NONE");
+    printf("  Accuracy:     %.1f m (1 sigma)\n", gps.est_sigma_m);
+    printf("\nNMEA Parser:\n");
+    printf("  Accepted:     %lu\n", (unsigned long)nmea_stats.accepted);
+    printf("  Bad checksum: %lu\n", (unsigned long)nmea_stats.checksum_errors);
+    printf("  Malformed:    %lu\n", (unsigned long)nmea_stats.malformed);
+    printf("  Unknown:      %lu talker, %lu type\n",
+           (unsigned long)nmea_stats.unknown_talker, (unsigned long)nmea_stats.unknown_type);
+    printf("  UART dropped: %lu (%lu overruns)\n", (unsigned long)gps_rx.dropped,
+           (unsigned long)gps_rx.overruns);
+    printf("\nDisplay:\n");
+    printf("  I2C traffic:  %lu bytes/s\n", (unsigned long)oled_bus_bytes_per_sec);
+    static const char *metric_names[METRIC_HIST_COUNT] = {"NMEA parse", "UBX decode", "Fix->MQTT", "I2C", "HTTP"};
+    printf("\nLatency (p50/p99/max us, count, errors):\n");
+    for (int i = 0; i < METRIC_HIST_COUNT; i++) {
+        metrics_hist_t h;
+        metrics_get_hist(i, &h);
+        printf("  %-13s %lu/%lu/%lu, %lu, %lu\n", metric_names[i],
+               (unsigned long)metrics_percentile(&h, 50), (unsigned long)metrics_percentile(&h, 99),
+               (unsigned long)h.max_us, (unsigned long)h.count, (unsigned long)h.errors);
+    }
+    metrics_system_t sys;
+    metrics_get_system(&sys);
+    printf("\nRuntime (at last status publish):\n");
+    printf("  Heap:         %lu free, %lu min, %lu largest block\n", (unsigned long)sys.heap_free,
+           (unsigned long)sys.heap_min, (unsigned long)sys.heap_largest);
+    if (mqtt_client) {
+        printf("  MQTT client:  %d bytes in outbox\n", esp_mqtt_client_get_outbox_size(mqtt_client));
+    }
+    outbox_stats_t ob;
+    outbox_get_stats(&ob);
+    printf("  Outbox:       %u/%d slots (%u in flight), %u in flash\n",
+           ob.depth, OUTBOX_SLOTS, ob.inflight, ob.spill_depth);
+    printf("  Outbox msgs:  %lu queued, %lu sent, %lu retried, %lu merged, %lu spilled, %lu dropped\n",
+           (unsigned long)ob.queued, (unsigned long)ob.delivered, (unsigned long)ob.retries,
+           (unsigned long)ob.coalesced, (unsigned long)ob.spilled, (unsigned long)ob.dropped);
+    for (int i = 0; i < sys.task_count; i++) {
+        printf("  %-16s prio %2u, cpu %3u%%, stack free %lu\n", sys.tasks[i].name,
+               sys.tasks[i].priority, sys.tasks[i].cpu_pct, (unsigned long)sys.tasks[i].stack_free);
+    }
+    ntp_server_stats_t ntp;
+    ntp_server_get_stats(&ntp);
+    printf("\nNTP Server:\n");
+    printf("  Requests:     %lu (rejected %lu)\n", (unsigned long)ntp.requests, (unsigned long)ntp.rejected);
+    printf("  Responses:    %lu (errors %lu)\n", (unsigned long)ntp.responses, (unsigned long)ntp.send_errors);
+    tracklog_stats_t track;
+    tracklog_get_stats(&track);
+    printf("\nTrack Log:\n");
+    printf("  Simplified:   %lu -> %lu points\n",
+           (unsigned long)track_simplify.points_in, (unsigned long)track_simplify.points_out);
+    printf("  Pending:      %lu (sent %lu, %lu bytes)\n", (unsigned long)track.pending,
+           (unsigned long)track.sent, (unsigned long)track_bytes_sent);
+    printf("  Lost:         %lu overwritten, %lu queue full\n",
+           (unsigned long)track.overwritten, (unsigned long)track.queue_drops);
+    printf("  Flash:        %lu page writes, %lu sector erases\n",
+           (unsigned long)track.page_writes, (unsigned long)track.sector_erases);
+    geocache_stats_t geo;
+    geocache_get_stats(&geo);
+    uint32_t geo_lookups = geo.hits + geo.misses;
+    printf("\nGeocode Cache:\n");
+    printf("  Entries:      %lu/%d (evictions %lu)\n", (unsigned long)geo.entries, GEOCACHE_SIZE,
+           (unsigned long)geo.evictions);
+    printf("  Hit rate:     %lu/%lu (%lu%%, %lu expired)\n", (unsigned long)geo.hits,
+           (unsigned long)geo_lookups, (unsigned long)(geo_lookups ? geo.hits * 100 / geo_lookups : 0),
+           (unsigned long)geo.expired);
+    printf("  HTTP:         %lu requests, %lu reused, %lu connects, %lu failed\n",
+           (unsigned long)geo_http.requests, (unsigned long)geo_http.reused,
+           (unsigned long)geo_http.connects, (unsigned long)geo_http.failures);
+    printf("  Latency:      %lu ms handshake, %lu ms request\n",
+           (unsigned long)geo_http.connect_ms, (unsigned long)geo_http.request_ms);
+    place_index_stats_t places;
+    place_index_get_stats(&places);
+    printf("\nPlace Index:\n");
+    printf("  Places:       %lu\n", (unsigned long)places.places);
+    printf("  Lookups:      %lu (%lu matched, last %lu us)\n", (unsigned long)places.lookups,
+           (unsigned long)places.found, (unsigned long)places.last_lookup_us);
     printf("\nLocation:\n");
     printf("  Street:       %s\n", location_street);
     printf("  City:         %s\n", location_city);
@@ -679,13 +1091,20 @@ static void serial_save_settings(void) {
         return;
     }
     
-    nvs_set_str(nvs_handle, "mqtt_broker", config_mqtt_broker);
-    nvs_set_str(nvs_handle, "mqtt_user", config_mqtt_user);
-    nvs_set_str(nvs_handle, "mqtt_pass", config_mqtt_pass);
-    nvs_set_u8(nvs_handle, "rtc_sync_src", (uint8_t)rtc_sync_source);
-    nvs_set_u8(nvs_handle, "gps_debug", (uint8_t)gps_debug_enabled);
-    
-    err = nvs_commit(nvs_handle);
+    // Stops at the first failure (a full partition reports ESP_ERR_NVS_NOT_ENOUGH_SPACE)
+    err = nvs_set_str(nvs_handle, "mqtt_broker", config_mqtt_broker);
+    if (err == ESP_OK) err = nvs_set_str(nvs_handle, "mqtt_user", config_mqtt_user);
+    if (err == ESP_OK) err = nvs_set_str(nvs_handle, "mqtt_pass", config_mqtt_pass);
+    if (err == ESP_OK) err = nvs_set_str(nvs_handle, NVS_DEVICE_ID, config_device_id);
+    if (err == ESP_OK) err = nvs_set_u8(nvs_handle, "rtc_sync_src", (uint8_t)rtc_sync_source);
+    if (err == ESP_OK) err = nvs_set_u8(nvs_handle, "gps_debug", (uint8_t)gps_debug_enabled);
+    if (err == ESP_OK) err = nvs_set_u16(nvs_handle, "trk_min_dist", (uint16_t)track_simplify_cfg.min_distance_m);
+    if (err == ESP_OK) err = nvs_set_u16(nvs_handle, "trk_max_dev", (uint16_t)track_simplify_cfg.max_deviation_m);
+    if (err == ESP_OK) err = nvs_set_u16(nvs_handle, "trk_heading", (uint16_t)track_simplify_cfg.heading_deg);
+    if (err == ESP_OK) err = nvs_set_u16(nvs_handle, "trk_max_int", (uint16_t)track_simplify_cfg.max_interval_s);
+    if (err == ESP_OK) err = nvs_set_u8(nvs_handle, "trk_window", track_simplify_cfg.window);
+    
+    if (err == ESP_OK) err = nvs_commit(nvs_handle);
     if (err == ESP_OK) {
         printf("Settings saved successfully!\n");
     } else {
@@ -729,6 +1148,14 @@ static void serial_load_settings(void) {
         ESP_LOGI(TAG, "Corrupted MQTT broker detected, reset to default");
     }
     
+    // Device ID selects this unit's topics; fall back if it is not a valid topic level
+    len = sizeof(config_device_id);
+    if (nvs_get_str(nvs_handle, NVS_DEVICE_ID, config_device_id, &len) == ESP_OK &&
+        !device_id_valid(config_device_id)) {
+        strcpy(config_device_id, DEFAULT_DEVICE_ID);
+        ESP_LOGI(TAG, "Invalid device ID in NVS, using %s", DEFAULT_DEVICE_ID);
+    }
+    
     // MQTT credentials now come from mqtt_credentials.h, not NVS
     // len = sizeof(config_mqtt_user);
     // nvs_get_str(nvs_handle, "mqtt_user", config_mqtt_user, &len);
@@ -745,6 +1172,24 @@ static void serial_load_settings(void) {
         gps_debug_enabled = (bool)temp;
     }
     
+    // Track simplification (whole metres / degrees / seconds)
+    uint16_t temp16;
+    if (nvs_get_u16(nvs_handle, "trk_min_dist", &temp16) == ESP_OK) {
+        track_simplify_cfg.min_distance_m = temp16;
+    }
+    if (nvs_get_u16(nvs_handle, "trk_max_dev", &temp16) == ESP_OK) {
+        track_simplify_cfg.max_deviation_m = temp16;
+    }
+    if (nvs_get_u16(nvs_handle, "trk_heading", &temp16) == ESP_OK) {
+        track_simplify_cfg.heading_deg = temp16;
+    }
+    if (nvs_get_u16(nvs_handle, "trk_max_int", &temp16) == ESP_OK) {
+        track_simplify_cfg.max_interval_s = temp16;
+    }
+    if (nvs_get_u8(nvs_handle, "trk_window", &temp) == ESP_OK) {
+        track_simplify_cfg.window = temp;
+    }
+    
     nvs_close(nvs_handle);
     ESP_LOGI(TAG, "Settings loaded from NVS");
 }
@@ -803,6 +1248,10 @@ static void serial_menu_task(void *pvParameters) {
                     serial_print_menu();
                     break;
                 case '6':
+                    serial_configure_track();
+                    serial_print_menu();
+                    break;
+                case '7':
                     printf("\nRebooting...\n");
                     vTaskDelay(pdMS_TO_TICKS(1000));
                     esp_restart();
@@ -821,65 +1270,291 @@ static void serial_menu_task(void *pvParameters) {
     }
 }
 
+// Compose the topic strings and register them with the outbox,
+// in table order (spilled outbox messages refer to topics by id)
+static void mqtt_topics_init(void) {
+    for (int i = 0; i < TOPIC_COUNT; i++) {
+        int len = snprintf(mqtt_topics[i], sizeof(mqtt_topics[i]), MQTT_TOPIC_BASE "/%s/%s",
+                           config_device_id, mqtt_topic_defs[i].leaf);
+        if (len >= (int)sizeof(mqtt_topics[i])) {
+            ESP_LOGW(TAG, "Topic truncated: %s", mqtt_topics[i]);
+        }
+        mqtt_outbox_ids[i] = outbox_add_topic(mqtt_topics[i], mqtt_topic_defs[i].qos,
+                                              mqtt_topic_defs[i].policy);
+    }
+    ESP_LOGI(TAG, "MQTT topics: %s/%s/*", MQTT_TOPIC_BASE, config_device_id);
+}
+
+// Outbox transport: hand one message to the client
+static int mqtt_outbox_publish(void *ctx, const char *topic, const void *data, size_t len, int qos) {
+    return esp_mqtt_client_publish((esp_mqtt_client_handle_t)ctx, topic, (const char *)data, (int)len, qos, 0);
+}
+
 static void mqtt_init(void) {
     esp_mqtt_client_config_t mqtt_cfg = {
         .broker.address.uri = config_mqtt_broker,
         .broker.verification.crt_bundle_attach = esp_crt_bundle_attach,
         .credentials.username = config_mqtt_user,
         .credentials.authentication.password = config_mqtt_pass,
+        .outbox.limit = OUTBOX_CLIENT_LIMIT,  // Backstop; outbox.c keeps it far below this
     };
     
     mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
+    
+    // Telemetry and status go through the managed outbox
+    outbox_transport_t transport = {.ctx = mqtt_client, .publish = mqtt_outbox_publish};
+    outbox_init(&transport);
+    mqtt_topics_init();
+    
     esp_mqtt_client_register_event(mqtt_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
     esp_mqtt_client_start(mqtt_client);
     
     ESP_LOGI(TAG, "MQTT client started");
 }
 
-static void mqtt_publish_gps(void) {
+// Degrees * 1e7 as a decimal string, e.g. -12.3456789
+static void format_e7(char *buf, size_t size, int32_t value_e7) {
+    uint32_t mag = value_e7 < 0 ? -(uint32_t)value_e7 : (uint32_t)value_e7;
+    snprintf(buf, size, "%s%lu.%07lu", value_e7 < 0 ? "-" : "",
+             (unsigned long)(mag / 10000000), (unsigned long)(mag % 10000000));
+}
+
+// Queue a payload formatted into an outbox slot; a truncated one is dropped
+static bool mqtt_commit(char *payload, size_t size, int len) {
+    return outbox_commit(payload, len > 0 && len < (int)size ? (size_t)len : 0);
+}
+
+static void mqtt_publish_gps(const gps_data_t *gps) {
     if (!mqtt_client) return;
     
-    char topic[128];
-    char payload[256];
-    
-    snprintf(topic, sizeof(topic), "camper/device01/gps");
-    snprintf(payload, sizeof(payload), 
-             "{\"lat\":%.6f,\"lon\":%.6f,\"sats\":%d,\"speed\":%.1f,\"fix\":%s}",
-             gps_data.latitude, gps_data.longitude, gps_data.satellites,
-             gps_data.speed_knots, gps_data.fix_valid ? "true" : "false");
-    
-    esp_mqtt_client_publish(mqtt_client, topic, payload, 0, 1, 0);
+    // Filtered position, printed from the 1e-7 integers (no float rounding)
+    char lat[16], lon[16];
+    format_e7(lat, sizeof(lat), gps->est_latitude_e7);
+    format_e7(lon, sizeof(lon), gps->est_longitude_e7);
+    
+    size_t size;
+    char *payload = outbox_reserve(mqtt_outbox_ids[TOPIC_GPS], OUTBOX_SLOT_SIZE, &size);
+    bool queued = false;
+    if (payload) {
+        int len = snprintf(payload, size, 
+                 "{\"lat\":%s,\"lon\":%s,\"acc\":%.1f,\"sats\":%d,\"speed\":%.1f,\"fix\":%s,\"dr\":%s}",
+                 lat, lon, gps->est_sigma_m, gps->satellites, gps->speed_knots,
+                 gps->fix_valid ? "true" : "false",
+                 gps->est_state == KF_STATE_DEAD_RECKONING ? "true" : "false");
+        queued = mqtt_commit(payload, size, len);
+    }
+    metrics_record(METRIC_FIX_PUBLISH, (uint32_t)(esp_timer_get_time() - gps->timestamp_us), queued);
 }
 
 static void mqtt_publish_location(void) {
     if (!mqtt_client) return;
     
-    char topic[128];
-    char payload[256];
+    size_t size;
+    char *payload = outbox_reserve(mqtt_outbox_ids[TOPIC_LOCATION], OUTBOX_SLOT_SIZE, &size);
+    if (!payload) return;
     
-    snprintf(topic, sizeof(topic), "camper/device01/location");
-    snprintf(payload, sizeof(payload), 
+    int len = snprintf(payload, size, 
              "{\"street\": \"%s\",\"city\":\"%s\",\"country\":\"%s\"}",
              location_street, location_city, location_country);
+    mqtt_commit(payload, size, len);
+}
+
+// Length after an append, held at size once snprintf truncates so the
+// next append gets no room instead of a pointer past the buffer
+static inline int status_clamp(int len, size_t size) {
+    return len < (int)size ? len : (int)size;
+}
+
+// Append a histogram as "name":[count,errors,p50_us,p99_us,max_us]
+static int status_append_hist(char *buf, size_t size, const char *name, metric_id_t id) {
+    metrics_hist_t h;
+    metrics_get_hist(id, &h);
+    return snprintf(buf, size, "\"%s\":[%lu,%lu,%lu,%lu,%lu]", name,
+                    (unsigned long)h.count, (unsigned long)h.errors,
+                    (unsigned long)metrics_percentile(&h, 50), (unsigned long)metrics_percentile(&h, 99),
+                    (unsigned long)h.max_us);
+}
+
+// Managed outbox: depth in RAM/flash and what happened to queued messages
+static int status_append_outbox(char *buf, size_t size) {
+    outbox_stats_t ob;
+    outbox_get_stats(&ob);
+    return snprintf(buf, size,
+                    ",\"ob\":{\"depth\":%u,\"flight\":%u,\"spill\":%u,\"queued\":%lu,"
+                    "\"sent\":%lu,\"retry\":%lu,\"merged\":%lu,\"spilled\":%lu,\"dropped\":%lu}",
+                    ob.depth, ob.inflight, ob.spill_depth, (unsigned long)ob.queued,
+                    (unsigned long)ob.delivered, (unsigned long)ob.retries, (unsigned long)ob.coalesced,
+                    (unsigned long)ob.spilled, (unsigned long)ob.dropped);
+}
+
+// Runtime metrics for the status topic: rates, latencies, heap and tasks
+static int status_append_runtime(char *buf, size_t size) {
+    static uint32_t last_lines = 0;
+    static int64_t last_us = 0;
+    
+    int64_t now_us = esp_timer_get_time();
+    uint32_t lines = gps_rx_lines;
+    float nmea_hz = last_us ? (lines - last_lines) * 1e6f / (float)(now_us - last_us) : 0;
+    last_lines = lines;
+    last_us = now_us;
+    
+    metrics_sample_system();
+    metrics_system_t sys;
+    metrics_get_system(&sys);
+    
+    // "client_ob" is bytes held by the IDF client's own outbox (QoS 1 awaiting
+    // PUBACK), next to the managed outbox counts in "ob"
+    int len = snprintf(buf, size,
+                       ",\"rt\":{\"nmea_hz\":%.1f,\"overruns\":%lu,\"client_ob\":%d,"
+                       "\"heap\":[%lu,%lu,%lu],\"lat\":{",
+                       nmea_hz, (unsigned long)gps_rx.overruns,
+                       esp_mqtt_client_get_outbox_size(mqtt_client),
+                       (unsigned long)sys.heap_free, (unsigned long)sys.heap_min,
+                       (unsigned long)sys.heap_largest);
+    len = status_clamp(len, size);
+    len = status_clamp(len + status_append_hist(buf + len, size - len, "parse", METRIC_NMEA_PARSE), size);
+    len = status_clamp(len + snprintf(buf + len, size - len, ","), size);
+    len = status_clamp(len + status_append_hist(buf + len, size - len, "ubx", METRIC_UBX_DECODE), size);
+    len = status_clamp(len + snprintf(buf + len, size - len, ","), size);
+    len = status_clamp(len + status_append_hist(buf + len, size - len, "fix", METRIC_FIX_PUBLISH), size);
+    len = status_clamp(len + snprintf(buf + len, size - len, ","), size);
+    len = status_clamp(len + status_append_hist(buf + len, size - len, "i2c", METRIC_I2C), size);
+    len = status_clamp(len + snprintf(buf + len, size - len, ","), size);
+    len = status_clamp(len + status_append_hist(buf + len, size - len, "http", METRIC_HTTP), size);
+    
+    // Tasks as [name, cpu %, stack bytes free, priority]
+    len = status_clamp(len + snprintf(buf + len, size - len, "},\"tasks\":["), size);
+    for (int i = 0; i < sys.task_count && len < (int)size; i++) {
+        const metrics_task_t *t = &sys.tasks[i];
+        int n = snprintf(buf + len, size - len, "%s[\"%s\",%u,%lu,%u]", i ? "," : "",
+                         t->name, t->cpu_pct, (unsigned long)t->stack_free, t->priority);
+        len = status_clamp(len + n, size);
+    }
+    if (len < (int)size) {
+        len = status_clamp(len + snprintf(buf + len, size - len, "]}"), size);
+    }
+    return len;
+}
+
+static void mqtt_publish_status(void) {
+    if (!mqtt_client) return;
     
-    esp_mqtt_client_publish(mqtt_client, topic, payload, 0, 1, 0);
+    // Rendered here first so the outbox only gives up the slots it needs
+    static char payload[OUTBOX_MSG_MAX];
+    const size_t size = sizeof(payload);
+    
+    tracklog_stats_t track;
+    tracklog_get_stats(&track);
+    geocache_stats_t geo;
+    geocache_get_stats(&geo);
+    
+    int len = snprintf(payload, size, 
+             "{\"nmea\":{\"ok\":%lu,\"bad_cs\":%lu,\"malformed\":%lu,"
+             "\"unk_talker\":%lu,\"unk_type\":%lu},\"uart\":{\"lines\":%lu,\"dropped\":%lu},"
+             "\"oled_bps\":%lu,\"track\":{\"pending\":%lu,\"sent\":%lu,\"lost\":%lu,\"bytes\":%lu},"
+             "\"geo\":{\"hits\":%lu,\"misses\":%lu,\"entries\":%lu,\"reused\":%lu,"
+             "\"connects\":%lu,\"connect_ms\":%lu,\"request_ms\":%lu}",
+             (unsigned long)nmea_stats.accepted, (unsigned long)nmea_stats.checksum_errors,
+             (unsigned long)nmea_stats.malformed, (unsigned long)nmea_stats.unknown_talker,
+             (unsigned long)nmea_stats.unknown_type,
+             (unsigned long)gps_rx_lines, (unsigned long)gps_rx.dropped,
+             (unsigned long)oled_bus_bytes_per_sec,
+             (unsigned long)track.pending, (unsigned long)track.sent,
+             (unsigned long)(track.overwritten + track.queue_drops),
+             (unsigned long)track_bytes_sent,
+             (unsigned long)geo.hits, (unsigned long)geo.misses, (unsigned long)geo.entries,
+             (unsigned long)geo_http.reused, (unsigned long)geo_http.connects,
+             (unsigned long)geo_http.connect_ms, (unsigned long)geo_http.request_ms);
+    len = status_clamp(len, size);
+    len = status_clamp(len + status_append_outbox(payload + len, size - len), size);
+    len = status_clamp(len + status_append_runtime(payload + len, size - len), size);
+    if (len >= (int)size) {
+        ESP_LOGW(TAG, "Status payload truncated");
+        return;
+    }
+    payload[len++] = '}';
+    outbox_put(mqtt_outbox_ids[TOPIC_STATUS], payload, len);
+}
+
+// Publish the oldest logged fixes as one QoS 1 batch; they are only marked
+// sent once the outbox has queued the message. The track log is already the
+// flash backlog, so batches wait there until the outbox has a free slot.
+static void mqtt_publish_track_batch(void) {
+    if (!mqtt_client || outbox_free_slots() == 0) return;
+    
+    track_record_t recs[TRACKLOG_DRAIN_BATCH];
+    int count = tracklog_peek_unsent(recs, TRACKLOG_DRAIN_BATCH);
+    if (count == 0) return;
+    
+    // Encoded straight into the outbox slot
+    size_t size;
+    uint8_t *payload = outbox_reserve(mqtt_outbox_ids[TOPIC_TRACK], OUTBOX_SLOT_SIZE, &size);
+    if (!payload) return;
+    
+#if MQTT_TRACK_BINARY
+    _Static_assert(TRACK_CODEC_HEADER_SIZE + TRACKLOG_DRAIN_BATCH * TRACK_CODEC_POINT_MAX <= OUTBOX_SLOT_SIZE,
+                   "a full track batch must fit one outbox slot");
+    size_t len = track_codec_encode(recs, count, payload, size);
+    int fitted = count;
+#else
+    char *json = (char *)payload;
+    size_t len = 0;
+    int fitted = 0;
+    
+    // As many records as fit one outbox slot; the rest go in the next batch
+    json[len++] = '[';
+    for (; fitted < count; fitted++) {
+        const track_record_t *r = &recs[fitted];
+        int n = snprintf(json + len, size - len,
+                         "%s{\"t\":%lu,\"lat\":%ld,\"lon\":%ld,\"alt\":%ld,\"spd\":%u,\"hdop\":%u,\"sats\":%u}",
+                         fitted ? "," : "", (unsigned long)r->time, (long)r->lat_e7, (long)r->lon_e7,
+                         (long)r->alt_dm, r->speed_ckn, r->hdop_c, r->sats);
+        if (len + n + 1 > size) break;  // No room for this record and the ']'
+        len += n;
+    }
+    json[len++] = ']';
+    if (fitted == 0) len = 0;
+#endif
+    
+    if (outbox_commit(payload, len)) {
+        tracklog_mark_sent(fitted);
+        track_bytes_sent += len;
+    }
 }
 
 // ============================================================================
 // HTTP Geolocation Lookup
 // ============================================================================
 
-static char http_response_buffer[4096];
-static int http_response_len = 0;
+// Address fields pulled from the response stream as it arrives
+enum { GEO_ROAD, GEO_CITY, GEO_TOWN, GEO_VILLAGE, GEO_COUNTRY_CODE };
+static char geo_road[sizeof(location_street)];
+static char geo_city[sizeof(location_city)];
+static char geo_town[sizeof(location_city)];
+static char geo_village[sizeof(location_city)];
+static char geo_country_code[sizeof(location_country)];
+static jx_field_t geo_fields[] = {
+    [GEO_ROAD]         = { "address.road", geo_road, sizeof(geo_road) },
+    [GEO_CITY]         = { "address.city", geo_city, sizeof(geo_city) },
+    [GEO_TOWN]         = { "address.town", geo_town, sizeof(geo_town) },
+    [GEO_VILLAGE]      = { "address.village", geo_village, sizeof(geo_village) },
+    [GEO_COUNTRY_CODE] = { "address.country_code", geo_country_code, sizeof(geo_country_code) },
+};
+static jx_parser_t geo_json;
+
+// Long-lived client: the TCP/TLS session is reused across lookups
+static esp_http_client_handle_t geo_client = NULL;
+static int64_t geo_connected_us = 0;      // Set when a new connection came up
+static uint32_t geo_backoff_ms = 0;       // Current reconnect backoff (0 = healthy)
+static uint32_t geo_failed_at_ms = 0;
 
 static esp_err_t http_event_handler(esp_http_client_event_t *evt) {
     switch(evt->event_id) {
+    case HTTP_EVENT_ON_CONNECTED:
+        geo_connected_us = esp_timer_get_time();
+        break;
     case HTTP_EVENT_ON_DATA:
-        if (http_response_len + evt->data_len < sizeof(http_response_buffer)) {
-            memcpy(http_response_buffer + http_response_len, evt->data, evt->data_len);
-            http_response_len += evt->data_len;
-            http_response_buffer[http_response_len] = 0;
-        }
+        jx_feed(&geo_json, evt->data, evt->data_len);
         break;
     default:
         break;
@@ -887,70 +1562,519 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt) {
     return ESP_OK;
 }
 
-static void lookup_location(void) {
-    if (!gps_data.fix_valid) return;
+static inline void geo_smooth(uint32_t *avg, int64_t sample_us) {
+    uint32_t ms = (uint32_t)(sample_us / 1000);
+    *avg = *avg ? *avg + ((int32_t)ms - (int32_t)*avg) / 4 : ms;
+}
+
+// GET url over the persistent connection, streaming the body into geo_json.
+// A connection the server closed while idle is reopened once; repeated
+// failures drop the client and back off exponentially.
+static esp_err_t geo_http_get(const char *url) {
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    if (geo_backoff_ms && now - geo_failed_at_ms < geo_backoff_ms) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (!geo_client) {
+        esp_http_client_config_t config = {
+            .url = url,
+            .event_handler = http_event_handler,
+            .timeout_ms = 5000,
+            .user_agent = "Localizer/1.0",
+            .crt_bundle_attach = esp_crt_bundle_attach,
+            .keep_alive_enable = true,
+            .keep_alive_idle = GEO_HTTP_KEEPALIVE_IDLE_S,
+            .keep_alive_interval = GEO_HTTP_KEEPALIVE_INTERVAL_S,
+            .keep_alive_count = 3,
+        };
+        geo_client = esp_http_client_init(&config);
+        if (!geo_client) return ESP_ERR_NO_MEM;
+    } else {
+        esp_http_client_set_url(geo_client, url);
+    }
+    
+    esp_err_t err = ESP_FAIL;
+    int status = 0;
+    int64_t lookup_start_us = esp_timer_get_time();
+    geo_http.requests++;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        jx_reset(&geo_json);
+        geo_connected_us = 0;
+        
+        int64_t start_us = esp_timer_get_time();
+        err = esp_http_client_perform(geo_client);
+        int64_t end_us = esp_timer_get_time();
+        
+        if (err == ESP_OK) {
+            if (geo_connected_us) {
+                geo_http.connects++;
+                geo_smooth(&geo_http.connect_ms, geo_connected_us - start_us);
+                geo_smooth(&geo_http.request_ms, end_us - geo_connected_us);
+            } else {
+                geo_http.reused++;
+                geo_smooth(&geo_http.request_ms, end_us - start_us);
+            }
+            status = esp_http_client_get_status_code(geo_client);
+            break;
+        }
+        
+        // Stale keep-alive connection: drop it and retry on a fresh one
+        esp_http_client_close(geo_client);
+    }
+    
+    bool ok = err == ESP_OK && status == 200;
+    metrics_record(METRIC_HTTP, (uint32_t)(esp_timer_get_time() - lookup_start_us), ok);
+    if (ok) {
+        geo_backoff_ms = 0;
+        return ESP_OK;
+    }
+    
+    // Transport failure or rate limiting (429): back off before the next try
+    geo_http.failures++;
+    geo_failed_at_ms = now;
+    geo_backoff_ms = geo_backoff_ms ? geo_backoff_ms * 2 : GEO_HTTP_BACKOFF_MIN_MS;
+    if (geo_backoff_ms > GEO_HTTP_BACKOFF_MAX_MS) geo_backoff_ms = GEO_HTTP_BACKOFF_MAX_MS;
+    
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+        esp_http_client_cleanup(geo_client);
+        geo_client = NULL;
+    } else {
+        ESP_LOGW(TAG, "HTTP status %d", status);
+    }
+    return err != ESP_OK ? err : ESP_FAIL;
+}
+
+// Serve the address from the reverse-geocode cache; no HTTP or JSON parse
+static bool location_from_cache(uint64_t cell) {
+    geocache_entry_t entry;
+    if (!geocache_lookup(cell, &entry)) return false;
+    
+    strncpy(location_street, entry.street, sizeof(location_street) - 1);
+    strncpy(location_city, entry.city, sizeof(location_city) - 1);
+    strncpy(location_country, entry.country, sizeof(location_country) - 1);
+    location_seq++;
+    return true;
+}
+
+// Nearest town from the on-flash place index; works without WiFi.
+// The street is cleared when the town changes, until refined online.
+static bool location_from_index(const gps_data_t *gps) {
+    place_result_t place;
+    if (!place_index_lookup(gps->latitude_e7, gps->longitude_e7, &place)) return false;
+    
+    if (strncmp(location_city, place.name, sizeof(location_city) - 1) != 0) {
+        location_street[0] = 0;
+        strncpy(location_city, place.name, sizeof(location_city) - 1);
+    }
+    strncpy(location_country, place.country, sizeof(location_country) - 1);
+    location_seq++;
+    return true;
+}
+
+// Query Nominatim and cache the result for the fix's grid cell
+static bool lookup_location(const gps_data_t *gps, uint64_t cell) {
+    if (!gps->fix_valid) return false;
+    bool found = false;
     
     char url[256];
     snprintf(url, sizeof(url), 
              "https://nominatim.openstreetmap.org/reverse?format=json&lat=%.6f&lon=%.6f",
-             gps_data.latitude, gps_data.longitude);
+             gps->latitude, gps->longitude);
+    
+    jx_init(&geo_json, geo_fields, sizeof(geo_fields) / sizeof(geo_fields[0]));
+    if (geo_http_get(url) != ESP_OK || !jx_ok(&geo_json)) return false;
+    
+    if (geo_fields[GEO_ROAD].found) {
+        strncpy(location_street, geo_road, sizeof(location_street) - 1);
+        found = true;
+    }
     
-    http_response_len = 0;
-    memset(http_response_buffer, 0, sizeof(http_response_buffer));
+    if (geo_fields[GEO_CITY].found) {
+        strncpy(location_city, geo_city, sizeof(location_city) - 1);
+        found = true;
+    } else if (geo_fields[GEO_TOWN].found) {
+        strncpy(location_city, geo_town, sizeof(location_city) - 1);
+        found = true;
+    } else if (geo_fields[GEO_VILLAGE].found) {
+        strncpy(location_city, geo_village, sizeof(location_city) - 1);
+        found = true;
+    }
+    
+    if (geo_fields[GEO_COUNTRY_CODE].found) {
+        strncpy(location_country, geo_country_code, sizeof(location_country) - 1);
+        found = true;
+    }
     
-    esp_http_client_config_t config = {
-        .url = url,
-        .event_handler = http_event_handler,
-        .timeout_ms = 5000,
-        .user_agent = "Localizer/1.0",
+    if (found) {
+        location_seq++;
+        geocache_store(cell, location_street, location_city, location_country);
+        ESP_LOGI(TAG, "Location: %s, %s, %s", 
+                location_street, location_city, location_country);
+    }
+    
+    return found;
+}
+
+// ============================================================================
+// PPS Time Discipline
+// ============================================================================
+
+static td_state_t td_reported_state = TD_STATE_UNLOCKED;
+static int64_t td_last_tick_us = 0;
+
+// Written by the PPS ISR
+static volatile int64_t pps_edge_us = 0;
+static volatile uint32_t pps_edge_count = 0;
+static uint32_t pps_used_count = 0;
+
+static void IRAM_ATTR pps_isr_handler(void *arg) {
+    pps_edge_us = esp_timer_get_time();
+    pps_edge_count++;
+}
+
+static void pps_init(void) {
+    td_init(&td_ctx);
+    
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << GPS_PPS_PIN,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
     };
+    gpio_config(&io_conf);
+    gpio_install_isr_service(0);
+    gpio_isr_handler_add(GPS_PPS_PIN, pps_isr_handler, NULL);
     
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    esp_err_t err = esp_http_client_perform(client);
+    ESP_LOGI(TAG, "PPS input on GPIO%d", GPS_PPS_PIN);
+}
+
+static void td_apply(td_result_t res) {
+    if (res.action == TD_ACTION_STEP) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        int64_t us = (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec + res.correction_us;
+        tv.tv_sec = us / 1000000LL;
+        tv.tv_usec = us % 1000000LL;
+        settimeofday(&tv, NULL);
+        ESP_LOGI(TAG, "System clock stepped by %lld us", (long long)res.correction_us);
+    } else if (res.action == TD_ACTION_SLEW) {
+        struct timeval delta = {
+            .tv_sec = res.correction_us / 1000000LL,
+            .tv_usec = res.correction_us % 1000000LL,
+        };
+        adjtime(&delta, NULL);
+    }
+}
+
+static void td_publish_reference(int64_t now_us) {
+    bool steering = td_ctx.state != TD_STATE_UNLOCKED;
+    bool was_steering = td_reported_state != TD_STATE_UNLOCKED;
+    bool disciplined = td_ctx.state == TD_STATE_LOCKED || td_ctx.state == TD_STATE_HOLDOVER;
+    bool was_disciplined = td_reported_state == TD_STATE_LOCKED || td_reported_state == TD_STATE_HOLDOVER;
+    
+    if (steering && !was_steering) {
+        // PPS owns the clock from the first step; SNTP steps would fight the
+        // loop, and its stratum 2 no longer describes the clock
+        esp_sntp_stop();
+        ntp_server_set_reference(NTP_STRATUM_UNSYNC, NTP_REFID_NONE, NULL, 0);
+        ESP_LOGI(TAG, "Disciplining system clock to GPS PPS");
+    } else if (!steering && was_steering) {
+        // Holdover expired (or acquisition failed): back to SNTP, whose
+        // sync callback re-announces stratum 2
+        ntp_server_set_reference(NTP_STRATUM_UNSYNC, NTP_REFID_NONE, NULL, 0);
+        esp_sntp_init();
+        ESP_LOGW(TAG, "GPS PPS discipline lost");
+    } else if (was_disciplined && !disciplined) {
+        // Re-acquiring after holdover: not a stratum 1 source until locked again
+        ntp_server_set_reference(NTP_STRATUM_UNSYNC, NTP_REFID_NONE, NULL, 0);
+    }
     
-    if (err == ESP_OK) {
-        cJSON *root = cJSON_Parse(http_response_buffer);
-        if (root) {
-            cJSON *address = cJSON_GetObjectItem(root, "address");
-            if (address) {
-                cJSON *road = cJSON_GetObjectItem(address, "road");
-                cJSON *city = cJSON_GetObjectItem(address, "city");
-                cJSON *town = cJSON_GetObjectItem(address, "town");
-                cJSON *village = cJSON_GetObjectItem(address, "village");
-                cJSON *country_code = cJSON_GetObjectItem(address, "country_code");
-                
-                if (road && road->valuestring) {
-                    strncpy(location_street, road->valuestring, sizeof(location_street) - 1);
-                }
-                
-                if (city && city->valuestring) {
-                    strncpy(location_city, city->valuestring, sizeof(location_city) - 1);
-                } else if (town && town->valuestring) {
-                    strncpy(location_city, town->valuestring, sizeof(location_city) - 1);
-                } else if (village && village->valuestring) {
-                    strncpy(location_city, village->valuestring, sizeof(location_city) - 1);
-                }
-                
-                if (country_code && country_code->valuestring) {
-                    strncpy(location_country, country_code->valuestring, sizeof(location_country) - 1);
-                }
-                
-                ESP_LOGI(TAG, "Location: %s, %s, %s", 
-                        location_street, location_city, location_country);
-            }
-            cJSON_Delete(root);
-        }
-    } else {
-        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+    if (disciplined) {
+        struct timeval ref;
+        gettimeofday(&ref, NULL);
+        ntp_server_set_reference(NTP_STRATUM_GPS, NTP_REFID('P', 'P', 'S', 0), &ref,
+                                 td_dispersion_us(&td_ctx, now_us));
+        if (!was_disciplined) ESP_LOGI(TAG, "System clock locked to GPS PPS");
     }
+    td_reported_state = td_ctx.state;
+}
+
+// Pair the latest PPS edge with the RMC second it labels
+static void td_on_rmc(const gps_data_t *gps, int64_t line_us) {
+    uint32_t count = pps_edge_count;
+    int64_t edge_us = pps_edge_us;
+    if (count != pps_edge_count) return;       // Edge arrived while reading
+    if (count == pps_used_count) return;       // No new edge
+    
+    // RMC for second N follows the PPS edge of second N within the same second
+    int64_t age_us = line_us - edge_us;
+    if (age_us <= 0 || age_us >= 1000000) return;
+    pps_used_count = count;
+    
+    struct timeval now_tv;
+    gettimeofday(&now_tv, NULL);
+    int64_t mono_us = esp_timer_get_time();
+    int64_t sys_at_edge = (int64_t)now_tv.tv_sec * 1000000LL + now_tv.tv_usec - (mono_us - edge_us);
+    int64_t utc_at_edge = td_utc_to_unix(gps->year, gps->month, gps->day,
+                                         gps->hour, gps->minute, gps->second) * 1000000LL;
+    
+    td_apply(td_update(&td_ctx, sys_at_edge - utc_at_edge, edge_us));
+    
+    if (td_ctx.state != td_reported_state || (td_ctx.samples % 16) == 0) {
+        td_publish_reference(mono_us);
+    }
+}
+
+// Loss-of-PPS detection and holdover, called about once per second
+static void td_service(void) {
+    int64_t now_us = esp_timer_get_time();
+    if (now_us - td_last_tick_us < 1000000) return;
+    td_last_tick_us = now_us;
     
-    esp_http_client_cleanup(client);
+    td_apply(td_tick(&td_ctx, now_us));
+    if (td_ctx.state != td_reported_state) {
+        td_publish_reference(now_us);
+    }
 }
 
 // ============================================================================
 // GPS UART Task
 // ============================================================================
 
+static bool gps_time_synced = false;
+static uint32_t gps_last_status_print = 0;
+
+// Points released by the simplifier (GPS task only; too big for its stack)
+static track_record_t track_kept[TS_WINDOW_MAX];
+
+// Run each RMC fix through the simplifier and log the points it keeps;
+// the MQTT task drains the log when connected
+static void tracklog_append_fix(const gps_data_t *gps) {
+    track_record_t rec = {
+        .time = (uint32_t)td_utc_to_unix(gps->year, gps->month, gps->day,
+                                         gps->hour, gps->minute, gps->second),
+        .lat_e7 = gps->est_latitude_e7,
+        .lon_e7 = gps->est_longitude_e7,
+        .alt_dm = (int32_t)(gps->altitude * 10.0f),
+        .millis = (uint16_t)gps->millisecond,
+        .speed_ckn = (uint16_t)(gps->speed_knots * 100.0f + 0.5f),
+        .hdop_c = (uint16_t)(gps->hdop * 100.0f + 0.5f),
+        .sats = (uint8_t)gps->satellites,
+        .fix_type = (uint8_t)gps->fix_type,
+    };
+    int n = ts_push(&track_simplify, &rec, track_kept);
+    for (int i = 0; i < n; i++) {
+        tracklog_append(&track_kept[i]);
+    }
+}
+
+// Fix lost: log the buffered tail so the track ends where the fix did
+static void tracklog_end_track(void) {
+    int n = ts_flush(&track_simplify, track_kept);
+    for (int i = 0; i < n; i++) {
+        tracklog_append(&track_kept[i]);
+    }
+}
+
+// Fuse the epoch's fix into the position filter, or dead-reckon without one
+static void gps_filter_epoch(int64_t now_us) {
+    if (gps_work.fix_valid) {
+        // Receiver accuracy (UBX) expressed as the HDOP the filter expects
+        float hdop = gps_work.h_acc_m > 0 ? gps_work.h_acc_m / (float)KF_UERE_M : gps_work.hdop;
+        kf_update(&kf_ctx, now_us, gps_work.latitude_e7, gps_work.longitude_e7, hdop,
+                  gps_work.speed_knots * 0.514444f, gps_work.course_deg);
+    } else {
+        kf_predict(&kf_ctx, now_us);
+    }
+    
+    kf_output_t est;
+    kf_get_output(&kf_ctx, &est);
+    gps_work.est_latitude_e7 = est.lat_e7;
+    gps_work.est_longitude_e7 = est.lon_e7;
+    gps_work.est_sigma_m = est.sigma_m;
+    gps_work.est_state = est.state;
+}
+
+// Common tail for every decoded message (NMEA line or UBX frame)
+static void gps_message_done(int64_t line_us) {
+    // New epoch: filter the position, then publish raw and filtered fields
+    // together; messages between epochs only update the working copy
+    bool epoch = gps_epoch_ready;
+    if (epoch) {
+        gps_epoch_ready = false;
+        gps_filter_epoch(line_us);
+        gps_snapshot_publish();
+    }
+    
+    // Whole-second RMC labels the preceding PPS edge
+    if (gps_rmc_time_fresh) {
+        gps_rmc_time_fresh = false;
+        gps_epoch_time_fresh = true;
+        if (gps_work.fix_valid && gps_work.millisecond == 0) {
+            td_on_rmc(&gps_work, line_us);
+        }
+    }
+    
+    // End of an epoch: log the complete fix, wake the publisher and location stages
+    if (epoch) {
+        if (gps_epoch_time_fresh && gps_work.fix_valid) {
+            tracklog_append_fix(&gps_work);
+        }
+        gps_epoch_time_fresh = false;
+        if (!gps_work.fix_valid) {
+            tracklog_end_track();
+        }
+        gps_notify_subscribers();
+    }
+    
+    // Print GPS status once per second
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    if (now - gps_last_status_print >= 1000) {
+        gps_last_status_print = now;
+        
+        // WiFi status
+        const char *wifi_status = (xEventGroupGetBits(s_event_group) & WIFI_CONNECTED_BIT) ? "WIFI:OK" : "WIFI:--";
+        
+        // GPS fix status
+        if (gps_work.fix_valid) {
+            printf("GPS: FIX | Sats:%d | Lat:%.6f Lon:%.6f | Time:%02d:%02d:%02d | %s | %s, %s, %s\n",
+                   gps_work.satellites,
+                   gps_work.latitude,
+                   gps_work.longitude,
+                   gps_work.hour,
+                   gps_work.minute,
+                   gps_work.second,
+                   wifi_status,
+                   location_street[0] ? location_street : "---",
+                   location_city[0] ? location_city : "---",
+                   location_country[0] ? location_country : "--");
+        } else {
+            printf("GPS: Searching... | Sats:%d | %s\n", 
+                   gps_work.satellites,
+                   wifi_status);
+        }
+    }
+    
+    // Sync RTC from GPS when first fix is acquired (if GPS sync is selected)
+    if (gps_work.fix_valid && !gps_time_synced && rtc_sync_source == RTC_SYNC_GPS) {
+        rtc_set_time(gps_work.year, gps_work.month, gps_work.day,
+                   gps_work.hour, gps_work.minute, gps_work.second);
+        xEventGroupSetBits(s_event_group, RTC_SYNCED_BIT);
+        gps_time_synced = true;
+        ESP_LOGI(TAG, "RTC synced from GPS");
+    }
+}
+
+static void gps_process_line(const char *line, size_t len) {
+    if (len == 0 || line[0] != '$') return;
+    
+    int64_t line_us = esp_timer_get_time();
+    gps_rx_lines++;
+    parse_nmea_sentence(line, len);
+    metrics_record(METRIC_NMEA_PARSE, (uint32_t)(esp_timer_get_time() - line_us), true);
+    gps_message_done(line_us);
+}
+
+// Feed raw bytes in NAV-PVT mode; handles each frame as it completes
+static void gps_process_ubx(const uint8_t *data, size_t len) {
+    while (len > 0) {
+        bool frame;
+        size_t used = ubx_parse(&gps_ubx_parser, data, len, &frame);
+        data += used;
+        len -= used;
+        if (!frame) continue;
+        
+        int64_t rx_us = esp_timer_get_time();
+        ubx_nav_pvt_t pvt;
+        ubx_nav_timeutc_t tu;
+        if (ubx_decode_nav_pvt(&gps_ubx_parser, &pvt)) {
+            parse_ubx_nav_pvt(&pvt);
+            gps_nav_pvt_seen = true;
+        } else if (ubx_decode_nav_timeutc(&gps_ubx_parser, &tu)) {
+            parse_ubx_nav_timeutc(&tu);
+        } else {
+            continue;  // ACKs and messages nobody asked for
+        }
+        gps_rx_lines++;
+        metrics_record(METRIC_UBX_DECODE, (uint32_t)(esp_timer_get_time() - rx_us), true);
+        gps_message_done(rx_us);
+    }
+}
+
+// ============================================================================
+// GNSS Receiver Configuration (UBX)
+// ============================================================================
+
+static esp_err_t uart_hal_write(void *ctx, const uint8_t *data, size_t len) {
+    uart_port_t port = (uart_port_t)(intptr_t)ctx;
+    if (uart_write_bytes(port, data, len) != (int)len) return ESP_FAIL;
+    return uart_wait_tx_done(port, pdMS_TO_TICKS(100));
+}
+
+static int uart_hal_read(void *ctx, uint8_t *buf, size_t len, uint32_t timeout_ms) {
+    return uart_read_bytes((uart_port_t)(intptr_t)ctx, buf, len, pdMS_TO_TICKS(timeout_ms));
+}
+
+static esp_err_t uart_hal_set_baud(void *ctx, uint32_t baud) {
+    uart_port_t port = (uart_port_t)(intptr_t)ctx;
+    uart_wait_tx_done(port, pdMS_TO_TICKS(100));
+    esp_err_t err = uart_set_baudrate(port, baud);
+    uart_flush_input(port);
+    return err;
+}
+
+static const hal_uart_t gps_uart = {
+    .ctx = (void *)(intptr_t)GPS_UART_NUM,
+    .write = uart_hal_write,
+    .read = uart_hal_read,
+    .set_baud = uart_hal_set_baud,
+};
+
+// Raise the link rate and nav rate and mute unused sentences. Runs before
+// line pattern detection is enabled, so raw reads do not disturb it.
+static void gps_configure_receiver(void) {
+    ubx_config_t cfg = {
+        .baud = GPS_UBX_BAUD_RATE,
+        .fallback_baud = GPS_BAUD_RATE,
+        .meas_rate_ms = 1000 / GPS_NAV_RATE_HZ,
+        .ack_timeout_ms = GPS_UBX_ACK_TIMEOUT_MS,
+        .nav_pvt = GPS_UBX_NAV_PVT,
+    };
+    
+    bool ok = ubx_configure(&gps_uart, &cfg, &gps_ubx);
+    if (!gps_ubx.responding) {
+        ESP_LOGW(TAG, "GPS receiver did not answer UBX - staying at %lu baud, default output",
+                 (unsigned long)gps_ubx.baud);
+    } else {
+        ESP_LOGI(TAG, "GPS receiver at %lu baud, %u ms epoch, %s (%u ack, %u nak, %u timeout)%s",
+                 (unsigned long)gps_ubx.baud, gps_ubx.meas_rate_ms, gps_ubx.nav_pvt ? "NAV-PVT" : "NMEA",
+                 gps_ubx.acks, gps_ubx.naks, gps_ubx.timeouts, ok ? "" : " - partially configured");
+    }
+}
+
+// NAV-PVT handover, from the GPS task loop: mute RMC/GGA after the first
+// frame, or turn NAV-PVT off and read NMEA lines if none arrives in time
+static void gps_nav_pvt_service(void) {
+    if (!gps_rx.binary || gps_nmea_fix_muted) return;
+    
+    if (gps_nav_pvt_seen) {
+        if (ubx_set_msg_rate(&gps_uart, UBX_CLASS_NMEA, NMEA_ID_RMC, 0) == ESP_OK &&
+            ubx_set_msg_rate(&gps_uart, UBX_CLASS_NMEA, NMEA_ID_GGA, 0) == ESP_OK) {
+            gps_nmea_fix_muted = true;
+            ESP_LOGI(TAG, "NAV-PVT received, RMC/GGA muted");
+        }
+    } else if (esp_timer_get_time() > gps_nav_pvt_deadline_us) {
+        ESP_LOGW(TAG, "No NAV-PVT after %d epochs - falling back to NMEA", GPS_UBX_NAV_PVT_EPOCHS);
+        ubx_set_msg_rate(&gps_uart, UBX_CLASS_NAV, UBX_NAV_PVT, 0);
+        gps_ubx.nav_pvt = false;
+        gps_rx.binary = false;
+        gps_rx_start(&gps_rx);
+    }
+}
+
 static void gps_task(void *pvParameters) {
     uart_config_t uart_config = {
         .baud_rate = GPS_BAUD_RATE,
@@ -960,71 +2084,41 @@ static void gps_task(void *pvParameters) {
         .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
     };
     
-    uart_driver_install(GPS_UART_NUM, GPS_BUFFER_SIZE, 0, 0, NULL, 0);
+    QueueHandle_t uart_queue;
+    uart_driver_install(GPS_UART_NUM, GPS_BUFFER_SIZE, 0, GPS_EVENT_QUEUE_SIZE, &uart_queue, 0);
     uart_param_config(GPS_UART_NUM, &uart_config);
     uart_set_pin(GPS_UART_NUM, GPS_TX_PIN, GPS_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
     
+#if GPS_UBX_CONFIGURE
+    gps_configure_receiver();
+#endif
+    
+    // NMEA: a UART_PATTERN_DET event per line terminator.
+    // NAV-PVT is binary, so it is read on plain UART_DATA events instead.
+    gps_rx.port = GPS_UART_NUM;
+    gps_rx.queue = uart_queue;
+    gps_rx.binary = gps_ubx.nav_pvt;
+    gps_rx.on_line = gps_process_line;
+    gps_rx.on_data = gps_process_ubx;
+    gps_rx_start(&gps_rx);
+    ubx_parser_reset(&gps_ubx_parser);
+    uint32_t epoch_ms = gps_ubx.meas_rate_ms ? gps_ubx.meas_rate_ms : 1000;
+    gps_nav_pvt_deadline_us = esp_timer_get_time() + (int64_t)GPS_UBX_NAV_PVT_EPOCHS * epoch_ms * 1000;
+    
     ESP_LOGI(TAG, "GPS UART initialized on UART%d (TX:%d RX:%d)", GPS_UART_NUM, GPS_TX_PIN, GPS_RX_PIN);
     
-    char line_buffer[256];
-    int line_pos = 0;
-    bool gps_time_synced = false;
-    uint32_t last_status_print = 0;
+    pps_init();
+    kf_init(&kf_ctx);
+    
+    uart_event_t event;
     
     while (1) {
-        uint8_t data;
-        int len = uart_read_bytes(GPS_UART_NUM, &data, 1, 100 / portTICK_PERIOD_MS);
-        
-        if (len > 0) {
-            if (data == '\n') {
-                line_buffer[line_pos] = 0;
-                if (line_pos > 0 && line_buffer[0] == '$') {
-                    parse_nmea_sentence(line_buffer);
-                    
-                    // Print GPS status once per second
-                    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
-                    if (now - last_status_print >= 1000) {
-                        last_status_print = now;
-                        
-                        // WiFi status
-                        const char *wifi_status = (xEventGroupGetBits(s_event_group) & WIFI_CONNECTED_BIT) ? "WIFI:OK" : "WIFI:--";
-                        
-                        // GPS fix status
-                        if (gps_data.fix_valid) {
-                            printf("GPS: FIX | Sats:%d | Lat:%.6f Lon:%.6f | Time:%02d:%02d:%02d | %s | %s, %s, %s\n",
-                                   gps_data.satellites,
-                                   gps_data.latitude,
-                                   gps_data.longitude,
-                                   gps_data.hour,
-                                   gps_data.minute,
-                                   gps_data.second,
-                                   wifi_status,
-                                   location_street[0] ? location_street : "---",
-                                   location_city[0] ? location_city : "---",
-                                   location_country[0] ? location_country : "--");
-                        } else {
-                            printf("GPS: Searching... | Sats:%d | %s\n", 
-                                   gps_data.satellites,
-                                   wifi_status);
-                        }
-                    }
-                    
-                    // Sync RTC from GPS when first fix is acquired (if GPS sync is selected)
-                    if (gps_data.fix_valid && !gps_time_synced && rtc_sync_source == RTC_SYNC_GPS) {
-                        rtc_set_time(gps_data.year, gps_data.month, gps_data.day,
-                                   gps_data.hour, gps_data.minute, gps_data.second);
-                        xEventGroupSetBits(s_event_group, RTC_SYNCED_BIT);
-                        gps_time_synced = true;
-                        ESP_LOGI(TAG, "RTC synced from GPS");
-                    }
-                }
-                line_pos = 0;
-            } else if (line_pos < sizeof(line_buffer) - 1) {
-                line_buffer[line_pos++] = data;
-            }
+        bool got_event = xQueueReceive(uart_queue, &event, pdMS_TO_TICKS(1000)) == pdTRUE;
+        td_service();
+        if (got_event) {
+            gps_rx_handle(&gps_rx, &event);
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(10));
+        gps_nav_pvt_service();
     }
 }
 
@@ -1033,18 +2127,60 @@ static void gps_task(void *pvParameters) {
 // ============================================================================
 
 static void location_task(void *pvParameters) {
+    bool resolved = false;
+    uint64_t resolved_cell = 0;
+    uint32_t resolved_ms = 0;
+    bool missed = false;
+    uint64_t missed_cell = 0;
+    bool indexed = false;
+    uint64_t indexed_cell = 0;
+    uint32_t last_http_ms = 0;
+    gps_data_t gps;
+    
     while (1) {
-        EventBits_t bits = xEventGroupWaitBits(s_event_group, 
-                                               WIFI_CONNECTED_BIT | GPS_FIX_BIT,
-                                               pdFALSE, pdTRUE, portMAX_DELAY);
+        xEventGroupWaitBits(s_event_group, GPS_FIX_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
         
-        if ((bits & (WIFI_CONNECTED_BIT | GPS_FIX_BIT)) == 
-            (WIFI_CONNECTED_BIT | GPS_FIX_BIT)) {
-            lookup_location();
-            mqtt_publish_location();
+        // Block until gps_task reports a new fix
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        gps_snapshot_read(&gps);
+        if (!gps.fix_valid) continue;
+        
+        // Still inside the cell we resolved: nothing to do
+        uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        uint64_t cell = geocache_cell_key(gps.latitude_e7, gps.longitude_e7);
+        if (resolved && cell == resolved_cell && now - resolved_ms < GEOCACHE_TTL_S * 1000ULL) {
+            continue;
         }
         
-        vTaskDelay(pdMS_TO_TICKS(5000)); // Every 5 seconds
+        // Offline town name first, so the display is never stuck without WiFi
+        if (!indexed || cell != indexed_cell) {
+            indexed = true;
+            indexed_cell = cell;
+            location_from_index(&gps);
+        }
+        
+        // Refine with a street: cache once per new cell, then rate-limited HTTP
+        bool found = false;
+        if (!missed || cell != missed_cell) {
+            found = location_from_cache(cell);
+            missed = !found;
+            missed_cell = cell;
+        }
+        bool online = xEventGroupGetBits(s_event_group) & WIFI_CONNECTED_BIT;
+        if (!found && online && now - last_http_ms >= GEOLOCATION_UPDATE_MS) {
+            last_http_ms = now;
+            found = lookup_location(&gps, cell);
+        }
+        
+        if (found) {
+            resolved = true;
+            resolved_cell = cell;
+            resolved_ms = now;
+            missed = false;
+            mqtt_publish_location();
+        }
+        geocache_persist();
     }
 }
 
@@ -1052,19 +2188,70 @@ static void location_task(void *pvParameters) {
 // MQTT Publish Task
 // ============================================================================
 
+// Milliseconds until the next track batch is due; UINT32_MAX when idle
+static uint32_t track_batch_wait_ms(uint32_t since_drain_ms) {
+    tracklog_stats_t track;
+    tracklog_get_stats(&track);
+    if (!track.pending || !(xEventGroupGetBits(s_event_group) & MQTT_CONNECTED_BIT)) return UINT32_MAX;
+    
+    // A full batch means there is a backlog, which drains at TRACKLOG_DRAIN_INTERVAL_MS
+    uint32_t interval = track.pending >= TRACKLOG_DRAIN_BATCH ? TRACKLOG_DRAIN_INTERVAL_MS
+                                                              : TRACKLOG_BATCH_MS;
+    return since_drain_ms >= interval ? 0 : interval - since_drain_ms;
+}
+
 static void mqtt_publish_task(void *pvParameters) {
+    fix_policy_t gps_policy = {
+        .mode = FIX_POLICY_THRESHOLD,
+        .min_distance_m = MQTT_GPS_MIN_DISTANCE_M,
+        .min_heading_deg = MQTT_GPS_MIN_HEADING_DEG,
+        .min_interval_ms = MQTT_GPS_MIN_INTERVAL_MS,
+        .max_interval_ms = MQTT_GPS_MAX_INTERVAL_MS,
+    };
+    uint32_t last_status_publish = 0;
+    uint32_t last_track_drain = 0;
+    uint32_t wait_ms = 0;
+    uint32_t last_fix_seq = 0;
+    gps_data_t gps;
+    
     while (1) {
-        EventBits_t bits = xEventGroupWaitBits(s_event_group, 
-                                               WIFI_CONNECTED_BIT,
-                                               pdFALSE, pdFALSE, portMAX_DELAY);
+        xEventGroupWaitBits(s_event_group, WIFI_CONNECTED_BIT,
+                            pdFALSE, pdFALSE, portMAX_DELAY);
         
-        if (bits & WIFI_CONNECTED_BIT) {
-            if (gps_data.fix_valid) {
-                mqtt_publish_gps();
+        // Sleep until gps_task reports a fix, the MQTT handler frees an outbox
+        // slot, or the next status/track/retry deadline
+        bool woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms)) > 0;
+        uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        
+        if (woken && MQTT_GPS_JSON_ENABLE && gps_snapshot_read(&gps) != last_fix_seq) {
+            last_fix_seq = gps.seq;
+            bool has_position = gps.fix_valid || gps.est_state == KF_STATE_DEAD_RECKONING;
+            if (has_position && fix_policy_due(&gps_policy, &gps, now)) {
+                mqtt_publish_gps(&gps);
             }
         }
         
-        vTaskDelay(pdMS_TO_TICKS(2000)); // Every 2 seconds
+        if (now - last_status_publish >= MQTT_STATUS_INTERVAL_MS) {
+            last_status_publish = now;
+            mqtt_publish_status();
+        }
+        
+        if (track_batch_wait_ms(now - last_track_drain) == 0) {
+            last_track_drain = now;
+            mqtt_publish_track_batch();
+        }
+        
+        bool connected = xEventGroupGetBits(s_event_group) & MQTT_CONNECTED_BIT;
+        uint32_t outbox_wait = outbox_service(now, connected);
+        
+        wait_ms = MQTT_STATUS_INTERVAL_MS - (now - last_status_publish);
+        uint32_t track_wait = track_batch_wait_ms(now - last_track_drain);
+        if (track_wait < wait_ms) {
+            wait_ms = track_wait;
+        }
+        if (outbox_wait < wait_ms) {
+            wait_ms = outbox_wait;
+        }
     }
 }
 
@@ -1074,8 +2261,14 @@ static void mqtt_publish_task(void *pvParameters) {
 
 static void display_task(void *pvParameters) {
     TickType_t last_wake_time = xTaskGetTickCount();
+    TickType_t last_metric_time = last_wake_time;
+    uint32_t last_bus_bytes = 0;
+    uint32_t gps_seq_shown = 0;
+    uint32_t location_seq_shown = 0;
+    gps_data_t gps;
     
     while (1) {
+        gps_snapshot_read(&gps);
         oled_clear();
         
         EventBits_t bits = xEventGroupGetBits(s_event_group);
@@ -1109,50 +2302,41 @@ static void display_task(void *pvParameters) {
             oled_draw_string(48, 16, "---");
         }
         
-        // Line 4: Scrolling GPS data
-        char line4[128];
-        snprintf(line4, sizeof(line4), 
-                "%.6f %.6f %02d:%02d:%02d SAT:%d  ",
-                gps_data.latitude, gps_data.longitude,
-                gps_data.hour, gps_data.minute, gps_data.second,
-                gps_data.satellites);
-        
-        int line4_len = strlen(line4) * 6; // 6 pixels per char
-        if (line4_len > DISPLAY_WIDTH) {
-            int offset = scroll_pos_line4 % line4_len;
-            // Draw scrolling text
-            for (int i = 0; i < strlen(line4); i++) {
-                int x = i * 6 - offset;
-                if (x >= -6 && x < DISPLAY_WIDTH) {
-                    oled_draw_char(x, 24, line4[i]);
-                }
-            }
-            scroll_pos_line4 = (scroll_pos_line4 + 2) % line4_len;
-        } else {
-            oled_draw_string(0, 24, line4);
+        // Line 4: Scrolling GPS data (re-rendered only on a new fix)
+        if (gps.seq != gps_seq_shown || !ticker_gps.width) {
+            gps_seq_shown = gps.seq;
+            char line4[DISPLAY_TICKER_MAX_CHARS + 1];
+            snprintf(line4, sizeof(line4), 
+                    "%.6f %.6f %02d:%02d:%02d SAT:%d  ",
+                    gps.latitude, gps.longitude,
+                    gps.hour, gps.minute, gps.second,
+                    gps.satellites);
+            oled_ticker_set_text(&ticker_gps, line4);
         }
+        oled_ticker_render(&ticker_gps, 3);
         
         // Line 5: Scrolling location
-        char line5[256];
-        snprintf(line5, sizeof(line5), "%s %s %s  ",
-                location_street, location_city, location_country);
-        
-        int line5_len = strlen(line5) * 6;
-        if (line5_len > DISPLAY_WIDTH) {
-            int offset = scroll_pos_line5 % line5_len;
-            for (int i = 0; i < strlen(line5); i++) {
-                int x = i * 6 - offset;
-                if (x >= -6 && x < DISPLAY_WIDTH) {
-                    oled_draw_char(x, 32, line5[i]);
-                }
-            }
-            scroll_pos_line5 = (scroll_pos_line5 + 2) % line5_len;
-        } else {
-            oled_draw_string(0, 32, line5);
+        if (location_seq != location_seq_shown || !ticker_location.width) {
+            location_seq_shown = location_seq;
+            char line5[DISPLAY_TICKER_MAX_CHARS + 1];
+            snprintf(line5, sizeof(line5), "%s %s %s  ",
+                    location_street, location_city, location_country);
+            oled_ticker_set_text(&ticker_location, line5);
         }
+        oled_ticker_render(&ticker_location, 4);
         
         oled_update();
         
+        // I2C bus occupancy by the display, sampled once per second
+        TickType_t now = xTaskGetTickCount();
+        if (now - last_metric_time >= pdMS_TO_TICKS(1000)) {
+            uint32_t elapsed_ms = (now - last_metric_time) * portTICK_PERIOD_MS;
+            uint32_t bus_bytes = oled_bus_bytes();
+            oled_bus_bytes_per_sec = (bus_bytes - last_bus_bytes) * 1000 / elapsed_ms;
+            last_bus_bytes = bus_bytes;
+            last_metric_time = now;
+        }
+        
         vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(100)); // 10 Hz refresh
     }
 }
@@ -1174,6 +2358,8 @@ void app_main(void) {
     
     // Load settings from NVS
     serial_load_settings();
+    geocache_init();
+    place_index_init();
     
     // Create event group
     s_event_group = xEventGroupCreate();
@@ -1197,6 +2383,7 @@ void app_main(void) {
         .scl_speed_hz = 400000,
     };
     ESP_ERROR_CHECK(i2c_master_bus_add_device(i2c_bus_handle, &oled_dev_cfg, &oled_dev_handle));
+    oled_i2c.ctx = oled_dev_handle;
     
     // Initialize RTC device
     i2c_device_config_t rtc_dev_cfg = {
@@ -1205,9 +2392,17 @@ void app_main(void) {
         .scl_speed_hz = 400000,
     };
     ESP_ERROR_CHECK(i2c_master_bus_add_device(i2c_bus_handle, &rtc_dev_cfg, &rtc_dev_handle));
+    rtc_i2c.ctx = rtc_dev_handle;
+    rtc_init();
     
-    // Initialize OLED display
-    oled_init();
+    // Mount the flash track log before GPS starts producing fixes
+    tracklog_init();
+    ts_init(&track_simplify, &track_simplify_cfg);
+    
+    // Initialize OLED display (panel needs ~100 ms after power-up)
+    vTaskDelay(pdMS_TO_TICKS(100));
+    oled_init(&oled_i2c);
+    ESP_LOGI(TAG, "OLED initialized");
     oled_clear();
     oled_draw_string(0, 0, "Localizer");
     oled_draw_string(0, 8, "Starting...");
@@ -1223,14 +2418,20 @@ void app_main(void) {
     // Initialize NTP
     ntp_init();
     
+    // Start local NTP server (answers "unsynchronized" until a source is available)
+    ntp_server_start();
+    
     // Initialize MQTT
     mqtt_init();
     
-    // Create tasks
-    xTaskCreate(gps_task, "gps_task", 4096, NULL, 5, NULL);
+    // Create tasks; fix consumers subscribe before gps_task starts notifying
+    TaskHandle_t location_handle = NULL;
+    xTaskCreate(location_task, "location_task", 8192, NULL, 3, &location_handle);
+    xTaskCreate(mqtt_publish_task, "mqtt_task", 4096, NULL, 3, &mqtt_task_handle);
+    gps_subscribe(location_handle);
+    gps_subscribe(mqtt_task_handle);
     xTaskCreate(display_task, "display_task", 4096, NULL, 4, NULL);
-    xTaskCreate(location_task, "location_task", 8192, NULL, 3, NULL);
-    xTaskCreate(mqtt_publish_task, "mqtt_task", 4096, NULL, 3, NULL);
+    xTaskCreate(gps_task, "gps_task", 4096, NULL, 5, NULL);
     // Serial menu permanently disabled - GPS shares UART0 with console on ESP32-C3
     // xTaskCreate(serial_menu_task, "serial_menu", 4096, NULL, 2, NULL);
     
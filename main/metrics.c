@@ -0,0 +1,124 @@
+/**
+ * Runtime Metrics - latency histograms and task/heap snapshots
+ *
+ * Per-task CPU needs CONFIG_FREERTOS_USE_TRACE_FACILITY and
+ * CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS (see sdkconfig.defaults);
+ * without them only heap figures are reported.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "metrics.h"
+
+static metrics_hist_t s_hist[METRIC_HIST_COUNT];
+static metrics_system_t s_system;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int bucket_of(uint32_t us) {
+    if (us < 2) return 0;
+    int b = 31 - __builtin_clz(us);
+    return b < METRICS_BUCKETS ? b : METRICS_BUCKETS - 1;
+}
+
+void metrics_record(metric_id_t id, uint32_t us, bool ok) {
+    if (id >= METRIC_HIST_COUNT) return;
+    int b = bucket_of(us);
+
+    metrics_hist_t *h = &s_hist[id];
+    portENTER_CRITICAL(&s_lock);
+    h->count++;
+    h->sum_us += us;
+    h->buckets[b]++;
+    if (us > h->max_us) h->max_us = us;
+    if (!ok) h->errors++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void metrics_get_hist(metric_id_t id, metrics_hist_t *out) {
+    if (id >= METRIC_HIST_COUNT) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    *out = s_hist[id];
+    portEXIT_CRITICAL(&s_lock);
+}
+
+uint32_t metrics_percentile(const metrics_hist_t *h, int pct) {
+    if (h->count == 0) return 0;
+
+    uint64_t target = ((uint64_t)h->count * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < METRICS_BUCKETS - 1; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            uint32_t upper = (2u << i) - 1;
+            return upper < h->max_us ? upper : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+// Run-time counters from the previous sample, keyed by task number
+static struct {
+    UBaseType_t number;
+    uint32_t runtime;
+} s_prev[METRICS_MAX_TASKS];
+static int s_prev_count = 0;
+static uint32_t s_prev_total = 0;
+
+static uint32_t prev_runtime(UBaseType_t number) {
+    for (int i = 0; i < s_prev_count; i++) {
+        if (s_prev[i].number == number) return s_prev[i].runtime;
+    }
+    return 0;
+}
+#endif
+
+void metrics_sample_system(void) {
+    metrics_system_t snap = {
+        .heap_free = esp_get_free_heap_size(),
+        .heap_min = esp_get_minimum_free_heap_size(),
+        .heap_largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+    };
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    static TaskStatus_t status[METRICS_MAX_TASKS];
+    uint32_t total = 0;
+    // Returns 0 if there are more tasks than slots
+    UBaseType_t n = uxTaskGetSystemState(status, METRICS_MAX_TASKS, &total);
+    uint32_t total_delta = total - s_prev_total;
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        metrics_task_t *t = &snap.tasks[i];
+        strncpy(t->name, status[i].pcTaskName, sizeof(t->name) - 1);
+        t->priority = (uint8_t)status[i].uxCurrentPriority;
+        t->stack_free = status[i].usStackHighWaterMark;  // Bytes: IDF stacks are uint8_t
+        uint32_t delta = status[i].ulRunTimeCounter - prev_runtime(status[i].xTaskNumber);
+        t->cpu_pct = total_delta ? (uint8_t)((uint64_t)delta * 100 / total_delta) : 0;
+    }
+    snap.task_count = (int)n;
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        s_prev[i].number = status[i].xTaskNumber;
+        s_prev[i].runtime = status[i].ulRunTimeCounter;
+    }
+    s_prev_count = (int)n;
+    s_prev_total = total;
+#endif
+
+    portENTER_CRITICAL(&s_lock);
+    s_system = snap;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void metrics_get_system(metrics_system_t *out) {
+    portENTER_CRITICAL(&s_lock);
+    *out = s_system;
+    portEXIT_CRITICAL(&s_lock);
+}
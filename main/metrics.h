@@ -0,0 +1,67 @@
+/**
+ * Runtime Metrics - latency histograms and task/heap snapshots
+ *
+ * Histograms use power-of-two microsecond buckets, so recording is a few
+ * instructions inside a short critical section and is safe from any task.
+ * Task CPU shares are deltas between two metrics_sample_system() calls.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define METRICS_BUCKETS     24      // Last bucket holds everything >= 2^23 us (~8 s)
+#define METRICS_MAX_TASKS   20
+#define METRICS_NAME_LEN    16
+
+typedef enum {
+    METRIC_NMEA_PARSE = 0,  // One NMEA line through the parser
+    METRIC_UBX_DECODE,      // One NAV-PVT frame into the fix snapshot
+    METRIC_FIX_PUBLISH,     // Epoch received -> gps message handed to MQTT
+    METRIC_I2C,             // One I2C transaction (OLED or RTC)
+    METRIC_HTTP,            // One geolocation request, including retries
+    METRIC_HIST_COUNT,
+} metric_id_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t errors;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[METRICS_BUCKETS];  // Bucket i: [2^i, 2^(i+1)) us, bucket 0 also holds 0
+} metrics_hist_t;
+
+typedef struct {
+    char name[METRICS_NAME_LEN];
+    uint8_t priority;
+    uint8_t cpu_pct;        // Share of the last sample interval
+    uint32_t stack_free;    // Stack high-water mark, bytes never used
+} metrics_task_t;
+
+typedef struct {
+    uint32_t heap_free;
+    uint32_t heap_min;      // Low-water mark since boot
+    uint32_t heap_largest;  // Largest allocatable block (fragmentation)
+    int task_count;
+    metrics_task_t tasks[METRICS_MAX_TASKS];
+} metrics_system_t;
+
+// Record one sample; ok = false also counts an error
+void metrics_record(metric_id_t id, uint32_t us, bool ok);
+
+void metrics_get_hist(metric_id_t id, metrics_hist_t *out);
+
+// Upper bound of the bucket holding the given percentile (0..100), in us
+uint32_t metrics_percentile(const metrics_hist_t *h, int pct);
+
+// Snapshot tasks and heap. Call from one task only: CPU shares are
+// measured against the previous call.
+void metrics_sample_system(void);
+
+// Last snapshot taken by metrics_sample_system()
+void metrics_get_system(metrics_system_t *out);
+
+#endif // METRICS_H
@@ -0,0 +1,248 @@
+/**
+ * NMEA 0183 Tokenizer
+ *
+ * Walks each line exactly once and hands out pointer/length views, so
+ * the hot GPS path never copies a sentence or calls strtok/atof.
+ * Syquens B.V. - 2026
+ */
+
+#include "nmea.h"
+
+static inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline int two_digits(const char *p) {
+    return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+static inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static nmea_talker_t talker_from_address(const nmea_field_t *addr) {
+    if (addr->len != 5) return NMEA_TALKER_UNKNOWN;
+
+    switch (((uint16_t)addr->ptr[0] << 8) | (uint8_t)addr->ptr[1]) {
+    case ('G' << 8) | 'P': return NMEA_TALKER_GP;
+    case ('G' << 8) | 'N': return NMEA_TALKER_GN;
+    case ('G' << 8) | 'L': return NMEA_TALKER_GL;
+    case ('G' << 8) | 'A': return NMEA_TALKER_GA;
+    case ('B' << 8) | 'D': return NMEA_TALKER_BD;
+    default:               return NMEA_TALKER_UNKNOWN;
+    }
+}
+
+static inline void push_field(nmea_sentence_t *out, const char *start, const char *p) {
+    if (out->count < NMEA_MAX_FIELDS) {
+        out->fields[out->count].ptr = start;
+        out->fields[out->count].len = (uint8_t)(p - start);
+        out->count++;
+    }
+}
+
+bool nmea_tokenize(const char *line, size_t len, nmea_sentence_t *out) {
+    out->count = 0;
+    out->talker = NMEA_TALKER_UNKNOWN;
+    out->has_checksum = false;
+    out->checksum_ok = false;
+    if (len == 0 || line[0] != '$') return false;
+
+    const char *p = line + 1;
+    const char *end = line + len;
+    const char *start = p;
+    uint8_t sum = 0;
+
+    while (p < end) {
+        char c = *p;
+        if (c == '*' || c == '\r' || c == '\n') {
+            push_field(out, start, p);
+            if (c == '*' && end - p >= 3) {
+                int hi = hex_value(p[1]);
+                int lo = hex_value(p[2]);
+                out->has_checksum = hi >= 0 && lo >= 0;
+                out->checksum_ok = out->has_checksum && sum == (uint8_t)((hi << 4) | lo);
+            }
+            break;
+        }
+        sum ^= (uint8_t)c;
+        if (c == ',') {
+            push_field(out, start, p);
+            start = p + 1;
+        }
+        p++;
+    }
+
+    // Unterminated line (no checksum) - keep the trailing field
+    if (p == end) {
+        push_field(out, start, p);
+    }
+
+    if (out->count == 0) return false;
+    out->talker = talker_from_address(&out->fields[0]);
+    return true;
+}
+
+nmea_result_t nmea_dispatch(const char *line, size_t len,
+                            const nmea_handler_t *table, size_t table_len,
+                            nmea_stats_t *stats) {
+    nmea_sentence_t s;
+    nmea_result_t result;
+
+    if (!nmea_tokenize(line, len, &s)) {
+        result = NMEA_ERR_MALFORMED;
+    } else if (!s.checksum_ok) {
+        result = NMEA_ERR_CHECKSUM;
+    } else if (s.talker == NMEA_TALKER_UNKNOWN) {
+        result = NMEA_ERR_TALKER;
+    } else {
+        const char *t = s.fields[0].ptr + 2;
+        uint32_t type = NMEA_TYPE(t[0], t[1], t[2]);
+
+        result = NMEA_ERR_UNKNOWN_TYPE;
+        for (size_t i = 0; i < table_len; i++) {
+            if (table[i].type == type) {
+                table[i].handler(&s);
+                result = NMEA_OK;
+                break;
+            }
+        }
+    }
+
+    if (stats) {
+        switch (result) {
+        case NMEA_OK:               stats->accepted++; break;
+        case NMEA_ERR_MALFORMED:    stats->malformed++; break;
+        case NMEA_ERR_CHECKSUM:     stats->checksum_errors++; break;
+        case NMEA_ERR_TALKER:       stats->unknown_talker++; break;
+        case NMEA_ERR_UNKNOWN_TYPE: stats->unknown_type++; break;
+        }
+    }
+    return result;
+}
+
+bool nmea_parse_uint(const nmea_field_t *f, uint32_t *out) {
+    if (f->len == 0) return false;
+
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < f->len; i++) {
+        if (!is_digit(f->ptr[i])) return false;
+        value = value * 10 + (uint32_t)(f->ptr[i] - '0');
+    }
+    *out = value;
+    return true;
+}
+
+bool nmea_parse_fixed(const nmea_field_t *f, uint8_t decimals, int32_t *out) {
+    if (f->len == 0) return false;
+
+    uint8_t i = 0;
+    bool negative = false;
+    if (f->ptr[0] == '-') {
+        negative = true;
+        i++;
+    }
+
+    int32_t value = 0;
+    uint8_t frac_digits = 0;
+    bool in_fraction = false;
+    bool any_digit = false;
+
+    for (; i < f->len; i++) {
+        char c = f->ptr[i];
+        if (c == '.') {
+            if (in_fraction) return false;
+            in_fraction = true;
+        } else if (is_digit(c)) {
+            any_digit = true;
+            if (in_fraction) {
+                if (frac_digits >= decimals) continue;  // truncate
+                frac_digits++;
+            }
+            value = value * 10 + (c - '0');
+        } else {
+            return false;
+        }
+    }
+    if (!any_digit) return false;
+
+    for (; frac_digits < decimals; frac_digits++) {
+        value *= 10;
+    }
+    *out = negative ? -value : value;
+    return true;
+}
+
+bool nmea_parse_coord(const nmea_field_t *f, const nmea_field_t *hemi, int32_t *out_e7) {
+    if (f->len < 4) return false;
+
+    // Integer part holds degrees * 100 + whole minutes
+    uint32_t whole = 0;
+    uint8_t i = 0;
+    for (; i < f->len && is_digit(f->ptr[i]); i++) {
+        whole = whole * 10 + (uint32_t)(f->ptr[i] - '0');
+    }
+    if (i < 3) return false;
+
+    // Fraction of minutes, scaled to 1e7
+    uint32_t frac = 0;
+    uint32_t scale = 10000000;
+    if (i < f->len) {
+        if (f->ptr[i] != '.') return false;
+        for (i++; i < f->len; i++) {
+            if (!is_digit(f->ptr[i])) return false;
+            if (scale > 1) {
+                scale /= 10;
+                frac += (uint32_t)(f->ptr[i] - '0') * scale;
+            }
+        }
+    }
+
+    uint32_t degrees = whole / 100;
+    uint64_t minutes_e7 = (uint64_t)(whole % 100) * 10000000ULL + frac;
+    int64_t value = (int64_t)degrees * 10000000LL + (int64_t)((minutes_e7 + 30) / 60);
+
+    char dir = nmea_field_char(hemi);
+    if (dir == 'S' || dir == 'W') value = -value;
+
+    *out_e7 = (int32_t)value;
+    return true;
+}
+
+bool nmea_parse_time(const nmea_field_t *f, int *hour, int *minute, int *second, int *millis) {
+    if (f->len < 6) return false;
+    for (int i = 0; i < 6; i++) {
+        if (!is_digit(f->ptr[i])) return false;
+    }
+
+    *hour = two_digits(f->ptr);
+    *minute = two_digits(f->ptr + 2);
+    *second = two_digits(f->ptr + 4);
+
+    int ms = 0;
+    if (f->len > 7 && f->ptr[6] == '.') {
+        int scale = 100;
+        for (uint8_t i = 7; i < f->len && scale > 0; i++) {
+            if (!is_digit(f->ptr[i])) break;
+            ms += (f->ptr[i] - '0') * scale;
+            scale /= 10;
+        }
+    }
+    if (millis) *millis = ms;
+    return true;
+}
+
+bool nmea_parse_date(const nmea_field_t *f, int *day, int *month, int *year) {
+    if (f->len < 6) return false;
+    for (int i = 0; i < 6; i++) {
+        if (!is_digit(f->ptr[i])) return false;
+    }
+
+    *day = two_digits(f->ptr);
+    *month = two_digits(f->ptr + 2);
+    *year = 2000 + two_digits(f->ptr + 4);
+    return true;
+}
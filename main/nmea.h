@@ -0,0 +1,100 @@
+/**
+ * NMEA 0183 Tokenizer
+ *
+ * Single-pass, zero-copy field splitter with fixed-point conversions
+ * Syquens B.V. - 2026
+ */
+
+#ifndef NMEA_H
+#define NMEA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define NMEA_MAX_FIELDS         24   // GSV carries up to 20 fields
+
+// View into the original sentence - NOT null terminated
+typedef struct {
+    const char *ptr;
+    uint8_t len;
+} nmea_field_t;
+
+typedef enum {
+    NMEA_TALKER_UNKNOWN = 0,
+    NMEA_TALKER_GP,     // GPS
+    NMEA_TALKER_GN,     // Multi-constellation
+    NMEA_TALKER_GL,     // GLONASS
+    NMEA_TALKER_GA,     // Galileo
+    NMEA_TALKER_BD,     // BeiDou
+} nmea_talker_t;
+
+// Tokenized sentence. fields[0] is the address ("GPRMC"), without the '$'.
+// Empty fields are preserved, so field indices always match the NMEA spec.
+typedef struct {
+    nmea_field_t fields[NMEA_MAX_FIELDS];
+    uint8_t count;
+    nmea_talker_t talker;
+    bool has_checksum;
+    bool checksum_ok;       // XOR of the body matches the *hh suffix
+} nmea_sentence_t;
+
+// Sentence type key, e.g. NMEA_TYPE('R','M','C')
+#define NMEA_TYPE(a, b, c)      (((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(c))
+
+typedef void (*nmea_handler_fn)(const nmea_sentence_t *s);
+
+// Dispatch table entry - new sentence types are added as table rows
+typedef struct {
+    uint32_t type;
+    nmea_handler_fn handler;
+} nmea_handler_t;
+
+typedef enum {
+    NMEA_OK = 0,
+    NMEA_ERR_MALFORMED,
+    NMEA_ERR_CHECKSUM,
+    NMEA_ERR_TALKER,
+    NMEA_ERR_UNKNOWN_TYPE,
+} nmea_result_t;
+
+typedef struct {
+    uint32_t accepted;
+    uint32_t malformed;
+    uint32_t checksum_errors;
+    uint32_t unknown_talker;
+    uint32_t unknown_type;
+} nmea_stats_t;
+
+// Split a '$'-prefixed line into fields, stopping at '*', CR, LF or len.
+// The checksum is accumulated during the same pass. Returns false if the
+// line is not an NMEA sentence.
+bool nmea_tokenize(const char *line, size_t len, nmea_sentence_t *out);
+
+// Tokenize, verify checksum and talker, then call the matching handler.
+// Sentences without a valid *hh checksum are rejected. stats may be NULL.
+nmea_result_t nmea_dispatch(const char *line, size_t len,
+                            const nmea_handler_t *table, size_t table_len,
+                            nmea_stats_t *stats);
+
+// First character of a field, or 0 when the field is empty
+static inline char nmea_field_char(const nmea_field_t *f) {
+    return f->len ? f->ptr[0] : 0;
+}
+
+// Unsigned integer field ("08" -> 8). Returns false on empty/non-digit.
+bool nmea_parse_uint(const nmea_field_t *f, uint32_t *out);
+
+// Decimal field scaled by 10^decimals ("545.4", 1 -> 5454). Extra digits are truncated.
+bool nmea_parse_fixed(const nmea_field_t *f, uint8_t decimals, int32_t *out);
+
+// (D)DDMM.MMMMM + hemisphere to degrees * 1e7 (negative for S/W)
+bool nmea_parse_coord(const nmea_field_t *f, const nmea_field_t *hemi, int32_t *out_e7);
+
+// hhmmss[.sss] to hour/minute/second/millisecond
+bool nmea_parse_time(const nmea_field_t *f, int *hour, int *minute, int *second, int *millis);
+
+// ddmmyy to day/month/year (year as 2000 + yy)
+bool nmea_parse_date(const nmea_field_t *f, int *day, int *month, int *year);
+
+#endif // NMEA_H
@@ -0,0 +1,159 @@
+/**
+ * NTP Server (NTPv4, UDP port 123)
+ *
+ * Responses are copied from a pre-built 48-byte template, so each request
+ * only patches the version/poll bytes and the three timestamps. The
+ * receive timestamp is taken immediately after recvfrom() returns and the
+ * transmit timestamp immediately before sendto().
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "lwip/sockets.h"
+#include "config.h"
+#include "ntp_server.h"
+
+static const char *TAG = "NTP_SRV";
+
+#define NTP_PACKET_SIZE         48
+#define NTP_MODE_CLIENT         3
+#define NTP_MODE_SERVER         4
+#define NTP_LI_ALARM            3
+#define NTP_UNIX_OFFSET         2208988800UL  // 1900-01-01 to 1970-01-01
+#define NTP_PRECISION           -19           // ~2 us (esp_timer resolution)
+
+// Byte offsets in the NTP header
+#define NTP_OFF_LI_VN_MODE      0
+#define NTP_OFF_STRATUM         1
+#define NTP_OFF_POLL            2
+#define NTP_OFF_PRECISION       3
+#define NTP_OFF_ROOT_DELAY      4
+#define NTP_OFF_ROOT_DISP       8
+#define NTP_OFF_REFID           12
+#define NTP_OFF_REF_TS          16
+#define NTP_OFF_ORIGIN_TS       24
+#define NTP_OFF_RECV_TS         32
+#define NTP_OFF_XMIT_TS         40
+
+static uint8_t s_template[NTP_PACKET_SIZE];
+static portMUX_TYPE s_template_lock = portMUX_INITIALIZER_UNLOCKED;
+static ntp_server_stats_t s_stats = {0};
+
+static inline void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+// Unix timeval to 64-bit NTP timestamp (32.32 fixed point)
+static inline void put_timestamp(uint8_t *p, const struct timeval *tv) {
+    // usec * 2^32 / 1e6 without a 64-bit division
+    uint32_t frac = (uint32_t)(((uint64_t)tv->tv_usec * 18446744073709ULL) >> 32);
+    put_be32(p, (uint32_t)tv->tv_sec + NTP_UNIX_OFFSET);
+    put_be32(p + 4, frac);
+}
+
+// Microseconds to NTP short format (16.16 seconds)
+static inline uint32_t us_to_short(uint32_t us) {
+    return (uint32_t)(((uint64_t)us << 16) / 1000000ULL);
+}
+
+void ntp_server_set_reference(uint8_t stratum, uint32_t refid,
+                              const struct timeval *ref_time, uint32_t dispersion_us) {
+    uint8_t pkt[NTP_PACKET_SIZE] = {0};
+
+    bool synced = stratum != NTP_STRATUM_UNSYNC;
+    pkt[NTP_OFF_LI_VN_MODE] = ((synced ? 0 : NTP_LI_ALARM) << 6) | (4 << 3) | NTP_MODE_SERVER;
+    pkt[NTP_OFF_STRATUM] = stratum;
+    pkt[NTP_OFF_PRECISION] = (uint8_t)NTP_PRECISION;
+    put_be32(&pkt[NTP_OFF_ROOT_DELAY], 0);
+    put_be32(&pkt[NTP_OFF_ROOT_DISP], us_to_short(dispersion_us));
+    put_be32(&pkt[NTP_OFF_REFID], refid);
+    if (ref_time) {
+        put_timestamp(&pkt[NTP_OFF_REF_TS], ref_time);
+    }
+
+    portENTER_CRITICAL(&s_template_lock);
+    memcpy(s_template, pkt, sizeof(s_template));
+    portEXIT_CRITICAL(&s_template_lock);
+
+    ESP_LOGI(TAG, "Reference updated: stratum %d", stratum);
+}
+
+void ntp_server_get_stats(ntp_server_stats_t *out) {
+    *out = s_stats;
+}
+
+static void ntp_server_task(void *pvParameters) {
+    int sock = (int)(intptr_t)pvParameters;
+    uint8_t req[NTP_PACKET_SIZE + 20];  // Room for a MAC, which is ignored
+    uint8_t resp[NTP_PACKET_SIZE];
+    struct sockaddr_in client;
+    struct timeval rx_tv, tx_tv;
+
+    while (1) {
+        socklen_t addr_len = sizeof(client);
+        int len = recvfrom(sock, req, sizeof(req), 0, (struct sockaddr *)&client, &addr_len);
+        gettimeofday(&rx_tv, NULL);
+
+        if (len < NTP_PACKET_SIZE || (req[NTP_OFF_LI_VN_MODE] & 0x07) != NTP_MODE_CLIENT) {
+            s_stats.rejected++;
+            continue;
+        }
+        s_stats.requests++;
+
+        portENTER_CRITICAL(&s_template_lock);
+        memcpy(resp, s_template, sizeof(resp));
+        portEXIT_CRITICAL(&s_template_lock);
+
+        // Answer with the client's version, echo its poll and transmit time
+        resp[NTP_OFF_LI_VN_MODE] = (resp[NTP_OFF_LI_VN_MODE] & 0xC7) | (req[NTP_OFF_LI_VN_MODE] & 0x38);
+        resp[NTP_OFF_POLL] = req[NTP_OFF_POLL];
+        memcpy(&resp[NTP_OFF_ORIGIN_TS], &req[NTP_OFF_XMIT_TS], 8);
+        put_timestamp(&resp[NTP_OFF_RECV_TS], &rx_tv);
+
+        gettimeofday(&tx_tv, NULL);
+        put_timestamp(&resp[NTP_OFF_XMIT_TS], &tx_tv);
+
+        if (sendto(sock, resp, sizeof(resp), 0, (struct sockaddr *)&client, addr_len) == sizeof(resp)) {
+            s_stats.responses++;
+        } else {
+            s_stats.send_errors++;
+        }
+    }
+}
+
+esp_err_t ntp_server_start(void) {
+    // Until a source is known, answer "unsynchronized" so clients ignore us
+    ntp_server_set_reference(NTP_STRATUM_UNSYNC, NTP_REFID_NONE, NULL, 0);
+
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "Socket create failed");
+        return ESP_FAIL;
+    }
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(NTP_SERVER_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        ESP_LOGE(TAG, "Bind to port %d failed", NTP_SERVER_PORT);
+        close(sock);
+        return ESP_FAIL;
+    }
+
+    if (xTaskCreate(ntp_server_task, "ntp_server", NTP_SERVER_TASK_STACK, (void *)(intptr_t)sock,
+                    NTP_SERVER_TASK_PRIORITY, NULL) != pdPASS) {
+        close(sock);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "NTP server listening on UDP %d", NTP_SERVER_PORT);
+    return ESP_OK;
+}
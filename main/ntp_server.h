@@ -0,0 +1,42 @@
+/**
+ * NTP Server (NTPv4, UDP port 123)
+ *
+ * Serves the system clock to LAN clients
+ * Syquens B.V. - 2026
+ */
+
+#ifndef NTP_SERVER_H
+#define NTP_SERVER_H
+
+#include <stdint.h>
+#include <sys/time.h>
+#include "esp_err.h"
+
+#define NTP_STRATUM_UNSYNC      16   // With LI=3: clients treat as "not a valid source"
+#define NTP_STRATUM_GPS         1    // Disciplined from GPS
+#define NTP_STRATUM_NTP         2    // Synced from an upstream NTP server
+
+// No reference while unsynchronized. ASCII refids are Kiss-o'-Death codes
+// at stratum 0 only, so none is sent with stratum 16.
+#define NTP_REFID_NONE          0
+#define NTP_REFID(a, b, c, d)   (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+typedef struct {
+    uint32_t requests;       // Valid client requests received
+    uint32_t responses;      // Responses sent
+    uint32_t rejected;       // Short or non-client packets
+    uint32_t send_errors;
+} ntp_server_stats_t;
+
+// Create the server task and bind UDP port NTP_SERVER_PORT
+esp_err_t ntp_server_start(void);
+
+// Update the response template after the clock source changed.
+// refid is host order (IPv4 of upstream for stratum 2, ASCII code for stratum 1).
+// dispersion_us is the estimated error of the system clock.
+void ntp_server_set_reference(uint8_t stratum, uint32_t refid,
+                              const struct timeval *ref_time, uint32_t dispersion_us);
+
+void ntp_server_get_stats(ntp_server_stats_t *out);
+
+#endif // NTP_SERVER_H
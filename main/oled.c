@@ -0,0 +1,246 @@
+/**
+ * SSD1306 OLED Renderer (72x40 visible window)
+ *
+ * The frame buffer uses the controller's page layout: one byte per column,
+ * eight rows per page, LSB on top. oled_update keeps a shadow copy of the
+ * panel and only sends the changed column range of each page.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "oled.h"
+
+// 5x7 font, ASCII 32..95
+static const uint8_t s_font_5x7[][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, // space (32)
+    {0x00, 0x00, 0x5F, 0x00, 0x00}, // !
+    {0x00, 0x07, 0x00, 0x07, 0x00}, // "
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // #
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // $
+    {0x23, 0x13, 0x08, 0x64, 0x62}, // %
+    {0x36, 0x49, 0x55, 0x22, 0x50}, // &
+    {0x00, 0x05, 0x03, 0x00, 0x00}, // '
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, // (
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, // )
+    {0x14, 0x08, 0x3E, 0x08, 0x14}, // *
+    {0x08, 0x08, 0x3E, 0x08, 0x08}, // +
+    {0x00, 0x50, 0x30, 0x00, 0x00}, // ,
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // -
+    {0x00, 0x60, 0x60, 0x00, 0x00}, // .
+    {0x20, 0x10, 0x08, 0x04, 0x02}, // /
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // 0
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
+    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
+    {0x21, 0x41, 0x45, 0x4B, 0x31}, // 3
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
+    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
+    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
+    {0x00, 0x36, 0x36, 0x00, 0x00}, // :
+    {0x00, 0x56, 0x36, 0x00, 0x00}, // ;
+    {0x08, 0x14, 0x22, 0x41, 0x00}, // <
+    {0x14, 0x14, 0x14, 0x14, 0x14}, // =
+    {0x00, 0x41, 0x22, 0x14, 0x08}, // >
+    {0x02, 0x01, 0x51, 0x09, 0x06}, // ?
+    {0x32, 0x49, 0x79, 0x41, 0x3E}, // @
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // A
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, // B
+    {0x3E, 0x41, 0x41, 0x41, 0x22}, // C
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // D
+    {0x7F, 0x49, 0x49, 0x49, 0x41}, // E
+    {0x7F, 0x09, 0x09, 0x09, 0x01}, // F
+    {0x3E, 0x41, 0x49, 0x49, 0x7A}, // G
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // H
+    {0x00, 0x41, 0x7F, 0x41, 0x00}, // I
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, // J
+    {0x7F, 0x08, 0x14, 0x22, 0x41}, // K
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, // L
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, // M
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // N
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // O
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, // P
+    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // Q
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, // R
+    {0x46, 0x49, 0x49, 0x49, 0x31}, // S
+    {0x01, 0x01, 0x7F, 0x01, 0x01}, // T
+    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // U
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // V
+    {0x3F, 0x40, 0x38, 0x40, 0x3F}, // W
+    {0x63, 0x14, 0x08, 0x14, 0x63}, // X
+    {0x07, 0x08, 0x70, 0x08, 0x07}, // Y
+    {0x61, 0x51, 0x49, 0x45, 0x43}, // Z
+    {0x00, 0x7F, 0x41, 0x41, 0x00}, // [
+    {0x02, 0x04, 0x08, 0x10, 0x20}, // backslash
+    {0x00, 0x41, 0x41, 0x7F, 0x00}, // ]
+    {0x04, 0x02, 0x01, 0x02, 0x04}, // ^
+    {0x40, 0x40, 0x40, 0x40, 0x40}, // _
+};
+
+static const hal_i2c_dev_t *s_dev = NULL;
+
+// Frame buffer and a copy of what the panel currently shows
+static uint8_t s_buffer[DISPLAY_WIDTH * OLED_PAGES];
+static uint8_t s_shadow[DISPLAY_WIDTH * OLED_PAGES];
+static uint8_t s_shadow_valid = 0;  // Bit per page: the shadow matches the panel
+_Static_assert(OLED_PAGES <= 8, "one validity bit per page");
+static uint32_t s_bus_bytes = 0;
+
+static void oled_write_command(uint8_t cmd) {
+    uint8_t data[2] = {0x00, cmd};
+    s_dev->write(s_dev->ctx, data, 2);
+}
+
+void oled_init(const hal_i2c_dev_t *dev) {
+    s_dev = dev;
+
+    oled_write_command(0xAE); // Display off
+    oled_write_command(0xD5); // Set display clock
+    oled_write_command(0x80);
+    oled_write_command(0xA8); // Set multiplex
+    oled_write_command(0x27); // 40 rows
+    oled_write_command(0xD3); // Set display offset
+    oled_write_command(0x00);
+    oled_write_command(0x40); // Set start line
+    oled_write_command(0x8D); // Charge pump
+    oled_write_command(0x14);
+    oled_write_command(0x20); // Memory mode
+    oled_write_command(0x00); // Horizontal
+    oled_write_command(0xA1); // Segment remap
+    oled_write_command(0xC8); // COM scan direction
+    oled_write_command(0xDA); // COM pins
+    oled_write_command(0x12);
+    oled_write_command(0x81); // Contrast
+    oled_write_command(0xCF);
+    oled_write_command(0xD9); // Precharge
+    oled_write_command(0xF1);
+    oled_write_command(0xDB); // VCOM detect
+    oled_write_command(0x40);
+    oled_write_command(0xA4); // Resume display
+    oled_write_command(0xA6); // Normal display
+    oled_write_command(0xAF); // Display on
+
+    s_shadow_valid = 0;
+}
+
+void oled_clear(void) {
+    memset(s_buffer, 0, sizeof(s_buffer));
+}
+
+void oled_draw_char(int x, int y, char c) {
+    // Clip whole glyphs before touching the buffer
+    if (x <= -5 || x >= DISPLAY_WIDTH || y <= -8 || y >= DISPLAY_HEIGHT) return;
+    if (c < 32 || c > 95) c = 32; // Map to space if out of range
+
+    const uint8_t *glyph = s_font_5x7[c - 32];
+
+    // Glyph columns are vertical bytes, same layout as the frame buffer:
+    // OR each column into its page, spilling into the next page when y
+    // is not page-aligned
+    int page = y >> 3;          // Arithmetic shift floors negative y
+    int shift = y & 7;
+    int col_start = x < 0 ? -x : 0;
+    int col_end = x + 5 > DISPLAY_WIDTH ? DISPLAY_WIDTH - x : 5;
+
+    for (int col = col_start; col < col_end; col++) {
+        uint16_t bits = (uint16_t)glyph[col] << shift;
+        if (page >= 0) {
+            s_buffer[page * DISPLAY_WIDTH + x + col] |= (uint8_t)bits;
+        }
+        if (shift && page + 1 < OLED_PAGES) {
+            s_buffer[(page + 1) * DISPLAY_WIDTH + x + col] |= (uint8_t)(bits >> 8);
+        }
+    }
+}
+
+void oled_draw_string(int x, int y, const char *str) {
+    int pos = x;
+    while (*str && pos < DISPLAY_WIDTH) {
+        oled_draw_char(pos, y, *str);
+        pos += 6; // 5 pixels + 1 spacing
+        str++;
+    }
+}
+
+void oled_ticker_set_text(oled_ticker_t *t, const char *text) {
+    if (strncmp(t->text, text, DISPLAY_TICKER_MAX_CHARS) == 0 && t->width) return;
+
+    strncpy(t->text, text, DISPLAY_TICKER_MAX_CHARS);
+    t->text[DISPLAY_TICKER_MAX_CHARS] = 0;
+
+    int x = 0;
+    for (const char *p = t->text; *p; p++) {
+        char c = (*p < 32 || *p > 95) ? 32 : *p;
+        memcpy(&t->strip[x], s_font_5x7[c - 32], 5);
+        t->strip[x + 5] = 0;
+        x += 6;
+    }
+    t->width = x;
+    if (t->pos >= t->width) t->pos = 0;
+}
+
+void oled_ticker_render(oled_ticker_t *t, int page) {
+    uint8_t *dst = &s_buffer[page * DISPLAY_WIDTH];
+
+    if (t->width <= DISPLAY_WIDTH) {
+        memcpy(dst, t->strip, t->width);
+        return;
+    }
+
+    // Window wraps around the end of the strip
+    int first = t->width - t->pos;
+    if (first > DISPLAY_WIDTH) first = DISPLAY_WIDTH;
+    memcpy(dst, &t->strip[t->pos], first);
+    memcpy(dst + first, t->strip, DISPLAY_WIDTH - first);
+
+    t->pos = (t->pos + 2) % t->width;
+}
+
+void oled_update(void) {
+    for (int page = 0; page < OLED_PAGES; page++) {
+        const uint8_t *cur = &s_buffer[page * DISPLAY_WIDTH];
+        uint8_t *shown = &s_shadow[page * DISPLAY_WIDTH];
+
+        // Find the changed column range on this page
+        int first = 0;
+        int last = DISPLAY_WIDTH - 1;
+        if (s_shadow_valid & (1u << page)) {
+            while (first < DISPLAY_WIDTH && cur[first] == shown[first]) first++;
+            if (first == DISPLAY_WIDTH) continue;  // Page unchanged
+            while (cur[last] == shown[last]) last--;
+        }
+        int count = last - first + 1;
+
+        // Address window and data in one transaction: each command byte is
+        // prefixed with Co=1/D/C=0 (0x80), the payload with Co=0/D/C=1 (0x40)
+        uint8_t data[12 + 1 + DISPLAY_WIDTH];
+        int n = 0;
+        data[n++] = 0x80; data[n++] = 0x21; // Column address
+        data[n++] = 0x80; data[n++] = OLED_X_OFFSET + first;
+        data[n++] = 0x80; data[n++] = OLED_X_OFFSET + last;
+        data[n++] = 0x80; data[n++] = 0x22; // Page address
+        data[n++] = 0x80; data[n++] = page;
+        data[n++] = 0x80; data[n++] = page;
+        data[n++] = 0x40;                   // Data mode
+        memcpy(&data[n], &cur[first], count);
+        n += count;
+
+        // A failed write may have landed partly: repaint the whole page next time
+        if (s_dev->write(s_dev->ctx, data, n) == ESP_OK) {
+            memcpy(&shown[first], &cur[first], count);
+            s_shadow_valid |= 1u << page;
+        } else {
+            s_shadow_valid &= ~(1u << page);
+        }
+        s_bus_bytes += n + 1;
+    }
+}
+
+const uint8_t *oled_framebuffer(void) {
+    return s_buffer;
+}
+
+uint32_t oled_bus_bytes(void) {
+    return s_bus_bytes;
+}
@@ -0,0 +1,49 @@
+/**
+ * SSD1306 OLED Renderer (72x40 visible window)
+ *
+ * Frame buffer, 5x7 text, scrolling tickers and dirty-range updates.
+ * Bus access goes through a hal_i2c_dev_t; no RTOS dependencies.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef OLED_H
+#define OLED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "hal.h"
+
+#define OLED_PAGES  (DISPLAY_HEIGHT / 8)
+
+// Scrolling ticker: text is rasterized once into an off-screen page strip,
+// each frame copies a DISPLAY_WIDTH window out of it
+typedef struct {
+    char text[DISPLAY_TICKER_MAX_CHARS + 1];
+    uint8_t strip[DISPLAY_TICKER_MAX_CHARS * 6];
+    int width;      // Rendered width in pixels
+    int pos;        // Scroll offset in pixels
+} oled_ticker_t;
+
+// Send the SSD1306 init sequence; the panel needs ~100 ms after power-up
+void oled_init(const hal_i2c_dev_t *dev);
+
+void oled_clear(void);
+void oled_draw_char(int x, int y, char c);
+void oled_draw_string(int x, int y, const char *str);
+
+void oled_ticker_set_text(oled_ticker_t *t, const char *text);
+
+// Copy the visible window into display page `page` and advance the scroll
+void oled_ticker_render(oled_ticker_t *t, int page);
+
+// Send the pages/columns that changed since the last update
+void oled_update(void);
+
+// Frame buffer, DISPLAY_WIDTH bytes per page (for inspection by host models)
+const uint8_t *oled_framebuffer(void);
+
+// Bytes put on the I2C bus so far (incl. address byte per transaction)
+uint32_t oled_bus_bytes(void);
+
+#endif // OLED_H
@@ -0,0 +1,572 @@
+/**
+ * MQTT Outbox - bounded store-and-forward queue in front of the MQTT client
+ *
+ * Slot life cycle: FREE -> FILLING -> READY -> SENDING -> INFLIGHT -> FREE
+ * on PUBACK. A message larger than a slot occupies a run of consecutive
+ * slots: the first carries its state, the others are TAIL until it is freed. The client retransmits an in-flight message itself, so the
+ * outbox only takes it back (to READY) when the link drops or the client
+ * gives up on it (MQTT_EVENT_DELETED). A refused publish goes back to READY
+ * and is retried after an exponential backoff. Payloads are formatted and
+ * handed to the client outside the lock (the client takes its own, and its
+ * event handler calls outbox_acked), so FILLING and SENDING slots are never
+ * coalesced or evicted.
+ *
+ * Spill ring: OUTBOX_SPILL_SLOTS NVS blobs "m00".."mNN" plus a meta blob
+ * with head/count. Reloaded entries are left in place and overwritten on
+ * reuse, so a reload only rewrites the meta blob.
+ * Syquens B.V. - 2026
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "config.h"
+#include "outbox.h"
+
+static const char *TAG = "OUTBOX";
+
+#define OB_META_KEY     "ring"
+
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_FILLING,       // Reserved by outbox_reserve, payload being written
+    SLOT_READY,         // Waiting to be sent; after a failed attempt, not before deadline
+    SLOT_SENDING,       // Being handed to the client outside the lock
+    SLOT_INFLIGHT,      // Handed to the client, waiting for PUBACK
+    SLOT_TAIL,          // Continuation of the message in an earlier slot
+} slot_state_t;
+
+typedef struct {
+    uint8_t state;
+    uint8_t topic;
+    uint8_t attempts;       // Times handed to the client
+    uint8_t span;           // Slots the message occupies, this one included
+    uint16_t len;
+    int msg_id;
+    uint32_t seq;           // Queue order, lowest is sent first
+    uint32_t deadline_ms;   // Backoff end after a refused or failed attempt
+} ob_slot_t;
+
+typedef struct {
+    const char *name;
+    uint8_t qos;
+    uint8_t policy;
+} ob_topic_t;
+
+// Spilled message: this header followed by the payload
+typedef struct __attribute__((packed)) {
+    uint32_t seq;
+    uint8_t topic;
+    uint8_t reserved;
+    uint16_t len;
+} ob_spill_hdr_t;
+
+// Client report on an in-flight message
+typedef struct {
+    int msg_id;
+    bool delivered;         // PUBACK; false: the client deleted it unsent
+} ob_ack_t;
+
+typedef struct {
+    uint32_t head;          // Ring index of the oldest spilled message
+    uint32_t count;
+    uint32_t next_seq;      // Above every spilled seq, so order survives a reboot
+} ob_meta_t;
+
+_Static_assert(OUTBOX_MSG_MAX <= OUTBOX_SLOTS * OUTBOX_SLOT_SIZE && OUTBOX_MSG_MAX <= UINT16_MAX,
+               "the largest message must fit the pool");
+
+static ob_slot_t s_slots[OUTBOX_SLOTS];
+static uint8_t s_data[OUTBOX_SLOTS][OUTBOX_SLOT_SIZE];  // One arena: a run of slots is contiguous
+static ob_topic_t s_topics[OUTBOX_MAX_TOPICS];
+static int s_topic_count = 0;
+static outbox_transport_t s_transport;
+static SemaphoreHandle_t s_lock = NULL;
+static QueueHandle_t s_acks = NULL;
+static uint32_t s_seq = 0;
+static ob_meta_t s_meta = {0};
+static outbox_stats_t s_stats = {0};
+
+static inline bool seq_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+static inline bool time_reached(uint32_t now, uint32_t t) {
+    return (int32_t)(now - t) >= 0;
+}
+
+static uint32_t backoff_ms(uint8_t attempts) {
+    uint32_t ms = OUTBOX_RETRY_MIN_MS;
+    for (int i = 1; i < attempts && ms < OUTBOX_RETRY_MAX_MS; i++) {
+        ms *= 2;
+    }
+    return ms < OUTBOX_RETRY_MAX_MS ? ms : OUTBOX_RETRY_MAX_MS;
+}
+
+static inline uint8_t *slot_data(const ob_slot_t *s) {
+    return s_data[s - s_slots];
+}
+
+static inline int span_for(size_t len) {
+    return len > OUTBOX_SLOT_SIZE ? (int)((len + OUTBOX_SLOT_SIZE - 1) / OUTBOX_SLOT_SIZE) : 1;
+}
+
+// First run of span free slots
+static ob_slot_t *find_free(int span) {
+    int run = 0;
+    for (int i = 0; i < OUTBOX_SLOTS; i++) {
+        run = s_slots[i].state == SLOT_FREE ? run + 1 : 0;
+        if (run == span) return &s_slots[i - span + 1];
+    }
+    return NULL;
+}
+
+// True if some run of span slots holds only free slots and unsent
+// messages, so evicting can make room; in-flight and reserved slots stay
+static bool run_possible(int span) {
+    int run = 0;
+    uint8_t owner = SLOT_FREE;
+    for (int i = 0; i < OUTBOX_SLOTS; i++) {
+        if (s_slots[i].state != SLOT_TAIL) owner = s_slots[i].state;
+        run = owner == SLOT_FREE || owner == SLOT_READY ? run + 1 : 0;
+        if (run == span) return true;
+    }
+    return false;
+}
+
+// Claim a run of free slots for a message
+static void claim(ob_slot_t *s, int span) {
+    s->span = (uint8_t)span;
+    for (int i = 1; i < span; i++) {
+        s[i].state = SLOT_TAIL;
+    }
+}
+
+// Free a message and its tail; from slot keep onward only (keep 0: all)
+static void free_from(ob_slot_t *s, int keep) {
+    for (int i = keep; i < s->span; i++) {
+        s[i].state = SLOT_FREE;
+    }
+    if (keep) {
+        s->span = (uint8_t)keep;
+    }
+}
+
+static inline void free_msg(ob_slot_t *s) {
+    free_from(s, 0);
+}
+
+// Unsent message on a topic (at most one for coalescing topics)
+static ob_slot_t *find_ready(uint8_t topic) {
+    for (int i = 0; i < OUTBOX_SLOTS; i++) {
+        if (s_slots[i].state == SLOT_READY && s_slots[i].topic == topic) return &s_slots[i];
+    }
+    return NULL;
+}
+
+static int count_state(slot_state_t state) {
+    int n = 0;
+    for (int i = 0; i < OUTBOX_SLOTS; i++) {
+        if (s_slots[i].state == state) n++;
+    }
+    return n;
+}
+
+// A newer unsent message on a coalescing topic makes this one redundant
+static bool superseded(const ob_slot_t *slot) {
+    if (s_topics[slot->topic].policy != OUTBOX_COALESCE) return false;
+    for (int i = 0; i < OUTBOX_SLOTS; i++) {
+        const ob_slot_t *s = &s_slots[i];
+        if (s != slot && s->state == SLOT_READY && s->topic == slot->topic &&
+            seq_before(slot->seq, s->seq)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if OUTBOX_SPILL_SLOTS > 0
+static uint8_t s_spill_buf[sizeof(ob_spill_hdr_t) + OUTBOX_MSG_MAX];
+
+static void spill_key(char *key, size_t size, uint32_t index) {
+    snprintf(key, size, "m%02u", (unsigned)(index % 100));
+}
+
+// Persist head/count; while this fails the ring in flash is stale, which
+// only matters if the device reboots before the next successful write
+static bool spill_save_meta(nvs_handle_t nvs) {
+    s_meta.next_seq = s_seq;
+    esp_err_t err = nvs_set_blob(nvs, OB_META_KEY, &s_meta, sizeof(s_meta));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Spill ring state not saved: %s", esp_err_to_name(err));
+    }
+    return err == ESP_OK;
+}
+
+static bool spill_push(const ob_slot_t *slot) {
+    nvs_handle_t nvs;
+    if (nvs_open(OUTBOX_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return false;
+
+    // Ring full: the oldest spilled message gives way
+    bool full = s_meta.count == OUTBOX_SPILL_SLOTS;
+    uint32_t index = (s_meta.head + s_meta.count) % OUTBOX_SPILL_SLOTS;
+
+    ob_spill_hdr_t hdr = {.seq = slot->seq, .topic = slot->topic, .len = slot->len};
+    memcpy(s_spill_buf, &hdr, sizeof(hdr));
+    memcpy(s_spill_buf + sizeof(hdr), slot_data(slot), slot->len);
+
+    char key[8];
+    spill_key(key, sizeof(key), index);
+    esp_err_t err = nvs_set_blob(nvs, key, s_spill_buf, sizeof(hdr) + slot->len);
+    if (err == ESP_OK) {
+        if (full) {
+            s_meta.head = (s_meta.head + 1) % OUTBOX_SPILL_SLOTS;
+            s_stats.dropped++;
+        } else {
+            s_meta.count++;
+        }
+        spill_save_meta(nvs);
+    } else {
+        ESP_LOGW(TAG, "Spill failed: %s", esp_err_to_name(err));
+    }
+    nvs_close(nvs);
+    return err == ESP_OK;
+}
+
+// Load the oldest spilled message into free slots (left READY); false if
+// it does not fit yet or was unreadable
+static bool spill_pop(void) {
+    nvs_handle_t nvs;
+    if (nvs_open(OUTBOX_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return false;
+
+    char key[8];
+    spill_key(key, sizeof(key), s_meta.head);
+    size_t len = sizeof(s_spill_buf);
+    esp_err_t err = nvs_get_blob(nvs, key, s_spill_buf, &len);
+
+    ob_spill_hdr_t hdr;
+    memcpy(&hdr, s_spill_buf, sizeof(hdr));
+    bool valid = err == ESP_OK && len >= sizeof(hdr) && hdr.len == len - sizeof(hdr) &&
+                 hdr.len <= OUTBOX_MSG_MAX && hdr.topic < s_topic_count;
+    ob_slot_t *slot = valid ? find_free(span_for(hdr.len)) : NULL;
+    if (valid && !slot) {
+        nvs_close(nvs);     // Stays in the ring until a run of slots frees up
+        return false;
+    }
+
+    // A failed save leaves the message in the flash ring: sent again after a reboot
+    s_meta.head = (s_meta.head + 1) % OUTBOX_SPILL_SLOTS;
+    s_meta.count--;
+    spill_save_meta(nvs);
+    nvs_close(nvs);
+
+    if (!valid) {
+        s_stats.dropped++;
+        return false;
+    }
+
+    claim(slot, span_for(hdr.len));
+    slot->state = SLOT_READY;
+    slot->topic = hdr.topic;
+    slot->attempts = 0;
+    slot->len = hdr.len;
+    slot->seq = hdr.seq;
+    memcpy(slot_data(slot), s_spill_buf + sizeof(hdr), hdr.len);
+    if (superseded(slot)) {
+        free_msg(slot);
+        s_stats.coalesced++;
+    }
+    return true;
+}
+#endif
+
+// Make room by moving the oldest unsent message out of RAM
+static bool evict_oldest(void) {
+    ob_slot_t *oldest = NULL;
+    for (int i = 0; i < OUTBOX_SLOTS; i++) {
+        ob_slot_t *s = &s_slots[i];
+        if (s->state == SLOT_READY && (!oldest || seq_before(s->seq, oldest->seq))) {
+            oldest = s;
+        }
+    }
+    if (!oldest) return false;
+
+#if OUTBOX_SPILL_SLOTS > 0
+    if (spill_push(oldest)) {
+        s_stats.spilled++;
+    } else {
+        s_stats.dropped++;
+    }
+#else
+    s_stats.dropped++;
+#endif
+    free_msg(oldest);
+    return true;
+}
+
+// Oldest READY message whose backoff has expired
+static ob_slot_t *next_due(uint32_t now_ms) {
+    ob_slot_t *next = NULL;
+    for (int i = 0; i < OUTBOX_SLOTS; i++) {
+        ob_slot_t *s = &s_slots[i];
+        if (s->state != SLOT_READY) continue;
+        if (s->attempts && !time_reached(now_ms, s->deadline_ms)) continue;
+        if (!next || seq_before(s->seq, next->seq)) {
+            next = s;
+        }
+    }
+    return next;
+}
+
+esp_err_t outbox_init(const outbox_transport_t *transport) {
+    s_transport = *transport;
+    s_lock = xSemaphoreCreateMutex();
+    s_acks = xQueueCreate(OUTBOX_MAX_INFLIGHT * 2, sizeof(ob_ack_t));
+    if (!s_lock || !s_acks) return ESP_ERR_NO_MEM;
+
+#if OUTBOX_SPILL_SLOTS > 0
+    nvs_handle_t nvs;
+    if (nvs_open(OUTBOX_NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+        size_t len = sizeof(s_meta);
+        if (nvs_get_blob(nvs, OB_META_KEY, &s_meta, &len) != ESP_OK || len != sizeof(s_meta) ||
+            s_meta.head >= OUTBOX_SPILL_SLOTS || s_meta.count > OUTBOX_SPILL_SLOTS) {
+            memset(&s_meta, 0, sizeof(s_meta));
+        }
+        nvs_close(nvs);
+    }
+    s_seq = s_meta.next_seq;
+    if (s_meta.count) {
+        ESP_LOGI(TAG, "%lu spilled messages waiting", (unsigned long)s_meta.count);
+    }
+#endif
+    return ESP_OK;
+}
+
+int outbox_add_topic(const char *topic, int qos, outbox_policy_t policy) {
+    if (s_topic_count >= OUTBOX_MAX_TOPICS) return -1;
+
+    ob_topic_t *t = &s_topics[s_topic_count];
+    t->name = topic;
+    t->qos = (uint8_t)qos;
+    t->policy = (uint8_t)policy;
+    return s_topic_count++;
+}
+
+void *outbox_reserve(int topic, size_t len, size_t *size) {
+    if (!s_lock || topic < 0 || topic >= s_topic_count || len > OUTBOX_MSG_MAX) return NULL;
+
+    int span = span_for(len);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    ob_slot_t *slot = find_free(span);
+    if (!slot && s_topics[topic].policy == OUTBOX_COALESCE) {
+        // Pool full: overwrite the unsent message in place (its backoff still applies)
+        slot = find_ready(topic);
+        if (slot && slot->span >= span) {
+            s_stats.coalesced++;
+        } else {
+            slot = NULL;
+        }
+    } else if (slot) {
+        claim(slot, span);
+        slot->attempts = 0;
+    }
+    // Spill the oldest unsent messages until a long enough run is free; if
+    // in-flight messages break up every run, fail without spilling anything
+    while (!slot && run_possible(span) && evict_oldest()) {
+        slot = find_free(span);
+        if (slot) {
+            claim(slot, span);
+            slot->attempts = 0;
+        }
+    }
+
+    if (slot) {
+        slot->state = SLOT_FILLING;
+        slot->topic = (uint8_t)topic;
+    } else {
+        s_stats.dropped++;
+    }
+    xSemaphoreGive(s_lock);
+
+    *size = slot ? (size_t)slot->span * OUTBOX_SLOT_SIZE : 0;
+    return slot ? slot_data(slot) : NULL;
+}
+
+bool outbox_commit(void *buf, size_t len) {
+    if (!buf) return false;
+
+    ob_slot_t *slot = &s_slots[((uint8_t *)buf - s_data[0]) / OUTBOX_SLOT_SIZE];
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool ok = len > 0 && len <= (size_t)slot->span * OUTBOX_SLOT_SIZE;
+    if (ok && s_topics[slot->topic].policy == OUTBOX_COALESCE) {
+        // Replace the unsent message on this topic; a pending backoff carries over
+        ob_slot_t *old;
+        while ((old = find_ready(slot->topic)) != NULL) {
+            if (old->attempts && !slot->attempts) {
+                slot->attempts = old->attempts;
+                slot->deadline_ms = old->deadline_ms;
+            }
+            free_msg(old);
+            s_stats.coalesced++;
+        }
+    }
+    if (ok) {
+        free_from(slot, span_for(len));     // Hand back the unused tail
+        slot->state = SLOT_READY;
+        slot->len = (uint16_t)len;
+        slot->seq = s_seq++;
+        s_stats.queued++;
+    } else {
+        free_msg(slot);
+        s_stats.dropped++;
+    }
+    xSemaphoreGive(s_lock);
+    return ok;
+}
+
+bool outbox_put(int topic, const void *data, size_t len) {
+    size_t size;
+    void *buf = outbox_reserve(topic, len, &size);
+    if (!buf) return false;
+    memcpy(buf, data, len);
+    return outbox_commit(buf, len);
+}
+
+// If the queue is full the report is lost: the slot stays in flight until
+// the link drops, and is then sent again
+static void report(int msg_id, bool delivered) {
+    if (s_acks) {
+        ob_ack_t ack = {.msg_id = msg_id, .delivered = delivered};
+        xQueueSend(s_acks, &ack, 0);
+    }
+}
+
+void outbox_acked(int msg_id) {
+    report(msg_id, true);
+}
+
+void outbox_failed(int msg_id) {
+    report(msg_id, false);
+}
+
+// Take an in-flight message back from the client: queue it again, or drop
+// it if a newer message on a coalescing topic replaces it
+static void release(ob_slot_t *s, uint32_t deadline_ms) {
+    if (superseded(s)) {
+        free_msg(s);
+        s_stats.coalesced++;
+    } else {
+        s->state = SLOT_READY;
+        s->deadline_ms = deadline_ms;
+        s_stats.retries++;
+    }
+}
+
+uint32_t outbox_service(uint32_t now_ms, bool connected) {
+    if (!s_lock) return UINT32_MAX;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    ob_ack_t ack;
+    while (xQueueReceive(s_acks, &ack, 0) == pdTRUE) {
+        for (int i = 0; i < OUTBOX_SLOTS; i++) {
+            ob_slot_t *s = &s_slots[i];
+            if (s->state != SLOT_INFLIGHT || s->msg_id != ack.msg_id) continue;
+            if (ack.delivered) {
+                free_msg(s);
+                s_stats.delivered++;
+            } else {
+                // Expired in the client: the broker is not acking, back off
+                release(s, now_ms + backoff_ms(s->attempts));
+            }
+            break;
+        }
+    }
+
+    if (!connected) {
+        // The client's copies may not survive the reconnect; ours are sent
+        // again as soon as the link is back
+        for (int i = 0; i < OUTBOX_SLOTS; i++) {
+            if (s_slots[i].state == SLOT_INFLIGHT) {
+                release(&s_slots[i], now_ms);
+            }
+        }
+    }
+
+    if (connected) {
+#if OUTBOX_SPILL_SLOTS > 0
+        // Reload from flash once the pool has drained to half
+        while (s_meta.count && count_state(SLOT_FREE) > OUTBOX_SLOTS / 2) {
+            if (!spill_pop()) break;
+        }
+#endif
+
+        while (count_state(SLOT_INFLIGHT) < OUTBOX_MAX_INFLIGHT) {
+            ob_slot_t *slot = next_due(now_ms);
+            if (!slot) break;
+
+            const ob_topic_t *t = &s_topics[slot->topic];
+            slot->state = SLOT_SENDING;
+            xSemaphoreGive(s_lock);
+            int id = s_transport.publish(s_transport.ctx, t->name, slot_data(slot), slot->len, t->qos);
+            xSemaphoreTake(s_lock, portMAX_DELAY);
+
+            if (slot->attempts < UINT8_MAX) {
+                slot->attempts++;
+            }
+            if (id < 0) {
+                // Client refused (its outbox is full or the link just dropped)
+                slot->state = SLOT_READY;
+                slot->deadline_ms = now_ms + backoff_ms(slot->attempts);
+                s_stats.retries++;
+                break;
+            }
+            if (t->qos == 0) {
+                free_msg(slot);
+                s_stats.delivered++;
+            } else {
+                slot->state = SLOT_INFLIGHT;
+                slot->msg_id = id;
+            }
+        }
+    }
+
+    // Nearest backoff end; messages blocked by the in-flight limit wait for an ack
+    uint32_t wait = UINT32_MAX;
+    for (int i = 0; i < OUTBOX_SLOTS; i++) {
+        const ob_slot_t *s = &s_slots[i];
+        if (!connected || s->state != SLOT_READY || !s->attempts) continue;
+        uint32_t until = time_reached(now_ms, s->deadline_ms) ? 0 : s->deadline_ms - now_ms;
+        if (until < wait) {
+            wait = until;
+        }
+    }
+    xSemaphoreGive(s_lock);
+    return wait;
+}
+
+int outbox_free_slots(void) {
+    if (!s_lock) return 0;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int n = count_state(SLOT_FREE);
+    xSemaphoreGive(s_lock);
+    return n;
+}
+
+void outbox_get_stats(outbox_stats_t *out) {
+    if (s_lock) xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out = s_stats;
+    out->depth = (uint16_t)(OUTBOX_SLOTS - count_state(SLOT_FREE) - count_state(SLOT_TAIL));
+    out->inflight = (uint16_t)count_state(SLOT_INFLIGHT);
+    out->spill_depth = (uint16_t)s_meta.count;
+    if (s_lock) xSemaphoreGive(s_lock);
+}
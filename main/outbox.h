@@ -0,0 +1,91 @@
+/**
+ * MQTT Outbox - bounded store-and-forward queue in front of the MQTT client
+ *
+ * Messages live in a fixed pool of RAM slots (a large one in several
+ * consecutive slots) until the broker acknowledges them; only
+ * OUTBOX_MAX_INFLIGHT are handed to the client at a time, so its own heap
+ * outbox stays small during a broker stall. When the pool is full
+ * the oldest unsent message is spilled to a small ring in NVS (or dropped)
+ * and is reloaded once the link drains - after the messages still in RAM,
+ * so a backlog is not strictly in order (track batches carry timestamps).
+ * Syquens B.V. - 2026
+ */
+
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define OUTBOX_MAX_TOPICS   8
+
+typedef enum {
+    OUTBOX_DROP_OLDEST = 0, // Queue every message; the oldest leaves the pool first
+    OUTBOX_COALESCE,        // Keep only the latest unsent message for the topic
+} outbox_policy_t;
+
+// How messages reach the broker (main.c binds this to esp_mqtt_client_publish)
+typedef struct {
+    void *ctx;
+    // Returns the msg_id (0 for QoS 0), <0 if the client refused the message
+    int (*publish)(void *ctx, const char *topic, const void *data, size_t len, int qos);
+} outbox_transport_t;
+
+typedef struct {
+    uint32_t queued;        // Messages accepted by outbox_put
+    uint32_t delivered;     // Acknowledged by the broker (QoS 0: taken by the client)
+    uint32_t retries;       // Refused publishes, and messages taken back from the client
+    uint32_t coalesced;     // Unsent messages replaced by a newer one on the same topic
+    uint32_t dropped;       // Lost to a full pool and spill ring, or a flash error
+    uint32_t spilled;       // Moved from RAM to flash
+    uint16_t depth;         // Messages in the RAM pool, including in flight
+    uint16_t inflight;      // Handed to the client, waiting for PUBACK
+    uint16_t spill_depth;   // Messages waiting in flash
+} outbox_stats_t;
+
+// Set up the pool and recover spilled messages from NVS
+esp_err_t outbox_init(const outbox_transport_t *transport);
+
+// Register a topic; returns its id, -1 if the table is full. The string is
+// referenced, not copied, so it must outlive the outbox. Register in a
+// fixed order: spilled messages refer to topics by id across reboots.
+int outbox_add_topic(const char *topic, int qos, outbox_policy_t policy);
+
+// Zero-copy put: reserve room for up to len bytes (consecutive slots for
+// more than OUTBOX_SLOT_SIZE, evicting the oldest messages until a run is
+// free), format the payload into it, then commit. Returns NULL if len is
+// over OUTBOX_MSG_MAX or no room could be made; *size is the room available.
+void *outbox_reserve(int topic, size_t len, size_t *size);
+
+// Queue a reservation holding len bytes; slots it does not need are freed.
+// len 0 (or too large) releases it. False if nothing was queued.
+bool outbox_commit(void *buf, size_t len);
+
+// Queue a copy of a message of up to OUTBOX_MSG_MAX bytes. Never waits on
+// the network; false if it was dropped.
+bool outbox_put(int topic, const void *data, size_t len);
+
+// Record a PUBACK (MQTT_EVENT_PUBLISHED). Safe from the MQTT event handler;
+// applied by the next outbox_service() call.
+void outbox_acked(int msg_id);
+
+// Record that the client deleted an unacknowledged message
+// (MQTT_EVENT_DELETED); it is queued again after a backoff. Same context
+// rules as outbox_acked.
+void outbox_failed(int msg_id);
+
+// Apply acks and failures, take in-flight messages back while disconnected
+// and, while connected, hand the next ones to the client. The client
+// retransmits in-flight messages itself. Call from one task only. Returns
+// the ms until the next backoff ends, UINT32_MAX when there is nothing to
+// wait for.
+uint32_t outbox_service(uint32_t now_ms, bool connected);
+
+// RAM slots currently unused
+int outbox_free_slots(void);
+
+void outbox_get_stats(outbox_stats_t *out);
+
+#endif // OUTBOX_H
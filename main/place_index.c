@@ -0,0 +1,167 @@
+/**
+ * Offline Place Index
+ *
+ * Each place kind has a radius of influence. Candidates are ranked by
+ * distance / radius, so a city 4 km away wins over a hamlet 800 m away.
+ * Syquens B.V. - 2026
+ */
+
+#include <math.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "config.h"
+#include "place_index.h"
+
+static const char *TAG = "PLACES";
+
+#define PI_E7_TO_RAD    ((float)M_PI / 180.0f / 1e7f)
+
+// Radius of influence per place_kind_t, metres
+static const float s_kind_radius_m[PLACE_KIND_COUNT] = {
+    [PLACE_CITY]    = 10000,
+    [PLACE_TOWN]    = 5000,
+    [PLACE_VILLAGE] = 2000,
+    [PLACE_SUBURB]  = 1500,
+    [PLACE_HAMLET]  = 1000,
+};
+
+static const uint8_t *s_image = NULL;
+static const place_index_header_t *s_hdr = NULL;
+static const uint32_t *s_tiles = NULL;
+static const place_index_entry_t *s_places = NULL;
+static place_index_stats_t s_stats = {0};
+
+static inline int32_t floor_div(int32_t a, int32_t b) {
+    return a / b - (a % b < 0);
+}
+
+// Every region inside the image, so a truncated or stale image is refused
+// before anything is read through the mapping
+static bool header_valid(const place_index_header_t *hdr, uint32_t part_size) {
+    uint64_t tiles_end = hdr->tiles_off + ((uint64_t)hdr->rows * hdr->cols + 1) * sizeof(uint32_t);
+    uint64_t places_end = hdr->places_off + (uint64_t)hdr->count * sizeof(place_index_entry_t);
+    return hdr->magic == PLACE_INDEX_MAGIC && hdr->version == 1 && hdr->tile_e7 != 0 &&
+           hdr->size >= sizeof(*hdr) && hdr->size <= part_size &&
+           hdr->tiles_off >= sizeof(*hdr) && hdr->tiles_off % sizeof(uint32_t) == 0 &&
+           tiles_end <= hdr->size && places_end <= hdr->size && hdr->strings_off < hdr->size;
+}
+
+// Tile starts must not decrease or point past the places, and the last
+// string must be terminated so every name_off inside the table is too
+static bool tables_valid(const uint8_t *image, const place_index_header_t *hdr) {
+    const uint32_t *tiles = (const uint32_t *)(image + hdr->tiles_off);
+    uint32_t n = (uint32_t)hdr->rows * hdr->cols;
+    for (uint32_t i = 0; i < n; i++) {
+        if (tiles[i] > tiles[i + 1]) return false;
+    }
+    return tiles[n] <= hdr->count && image[hdr->size - 1] == '\0';
+}
+
+esp_err_t place_index_init(void) {
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           PLACE_INDEX_PARTITION_SUBTYPE,
+                                                           PLACE_INDEX_PARTITION_LABEL);
+    if (!part) {
+        ESP_LOGW(TAG, "No '%s' partition - offline geocoding disabled", PLACE_INDEX_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    place_index_header_t hdr;
+    esp_err_t err = esp_partition_read(part, 0, &hdr, sizeof(hdr));
+    if (err != ESP_OK) return err;
+    if (hdr.magic != PLACE_INDEX_MAGIC) {
+        ESP_LOGW(TAG, "Place index not flashed");
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (!header_valid(&hdr, part->size)) {
+        ESP_LOGE(TAG, "Place index header invalid");
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const void *ptr;
+    esp_partition_mmap_handle_t handle;
+    err = esp_partition_mmap(part, 0, hdr.size, ESP_PARTITION_MMAP_DATA, &ptr, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "mmap failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    if (!tables_valid(ptr, &hdr)) {
+        ESP_LOGE(TAG, "Place index tables invalid");
+        esp_partition_munmap(handle);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_image = ptr;
+    s_hdr = ptr;
+    s_tiles = (const uint32_t *)(s_image + hdr.tiles_off);
+    s_places = (const place_index_entry_t *)(s_image + hdr.places_off);
+    s_stats.places = hdr.count;
+
+    ESP_LOGI(TAG, "%lu places, %ux%u tiles", (unsigned long)hdr.count, hdr.cols, hdr.rows);
+    return ESP_OK;
+}
+
+bool place_index_lookup(int32_t lat_e7, int32_t lon_e7, place_result_t *out) {
+    if (!s_hdr) return false;
+
+    int64_t start_us = esp_timer_get_time();
+    s_stats.lookups++;
+
+    int32_t row = floor_div(lat_e7, s_hdr->tile_e7) - s_hdr->lat0_tile;
+    int32_t col = floor_div(lon_e7, s_hdr->tile_e7) - s_hdr->lon0_tile;
+    float cos_lat = cosf(lat_e7 * PI_E7_TO_RAD);
+
+    // Tiles within PLACE_INDEX_MAX_DISTANCE_M; east-west they narrow with cos(lat)
+    float tile_m = s_hdr->tile_e7 * PI_E7_TO_RAD * 6371000.0f;
+    float reach_rows = ceilf(PLACE_INDEX_MAX_DISTANCE_M / tile_m);
+    float reach_cols = cos_lat > 0.01f ? ceilf(PLACE_INDEX_MAX_DISTANCE_M / (tile_m * cos_lat)) : s_hdr->cols;
+    int32_t dr = reach_rows < s_hdr->rows ? (int32_t)reach_rows : s_hdr->rows;
+    int32_t dc = reach_cols < s_hdr->cols ? (int32_t)reach_cols : s_hdr->cols;
+    int32_t r_lo = row - dr > 0 ? row - dr : 0;
+    int32_t r_hi = row + dr < s_hdr->rows - 1 ? row + dr : s_hdr->rows - 1;
+    int32_t c_lo = col - dc > 0 ? col - dc : 0;
+    int32_t c_hi = col + dc < s_hdr->cols - 1 ? col + dc : s_hdr->cols - 1;
+
+    const place_index_entry_t *best = NULL;
+    float best_score = 0;
+    float best_dist = 0;
+
+    for (int32_t r = r_lo; r <= r_hi; r++) {
+        for (int32_t c = c_lo; c <= c_hi; c++) {
+            uint32_t tile = (uint32_t)r * s_hdr->cols + c;
+            for (uint32_t i = s_tiles[tile]; i < s_tiles[tile + 1]; i++) {
+                const place_index_entry_t *p = &s_places[i];
+                float dx = (float)(p->lon_e7 - lon_e7) * PI_E7_TO_RAD * cos_lat;
+                float dy = (float)(p->lat_e7 - lat_e7) * PI_E7_TO_RAD;
+                float dist = 6371000.0f * sqrtf(dx * dx + dy * dy);
+                if (dist > PLACE_INDEX_MAX_DISTANCE_M) continue;    // Out of range before ranking
+                float radius = p->kind < PLACE_KIND_COUNT ? s_kind_radius_m[p->kind] : 1000;
+                float score = dist / radius;
+                if (!best || score < best_score) {
+                    best = p;
+                    best_score = score;
+                    best_dist = dist;
+                }
+            }
+        }
+    }
+
+    s_stats.last_lookup_us = (uint32_t)(esp_timer_get_time() - start_us);
+    if (!best) return false;
+    if (best->name_off >= s_hdr->size - s_hdr->strings_off) return false;
+
+    out->name = (const char *)(s_image + s_hdr->strings_off + best->name_off);
+    out->country[0] = best->country[0];
+    out->country[1] = best->country[1];
+    out->country[2] = 0;
+    out->kind = best->kind;
+    out->distance_m = (uint32_t)best_dist;
+    s_stats.found++;
+    return true;
+}
+
+void place_index_get_stats(place_index_stats_t *out) {
+    *out = s_stats;
+}
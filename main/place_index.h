@@ -0,0 +1,87 @@
+/**
+ * Offline Place Index
+ *
+ * Nearest-place reverse geocoding from a memory-mapped flash partition
+ * built by tools/build_place_index.py. No heap use after init; lookups
+ * touch only the tiles within PLACE_INDEX_MAX_DISTANCE_M of the query
+ * point. Init checks every table against the image size.
+ *
+ * Image layout (little-endian):
+ *   header     place_index_header_t
+ *   tiles      (rows * cols + 1) x u32   first place index of each tile,
+ *                                        row-major from (lat0, lon0)
+ *   places     count x place_index_entry_t, sorted by tile
+ *   strings    NUL-terminated UTF-8 names
+ * Syquens B.V. - 2026
+ */
+
+#ifndef PLACE_INDEX_H
+#define PLACE_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define PLACE_INDEX_MAGIC   0x31494C50   // "PLI1"
+
+typedef enum {
+    PLACE_CITY = 0,
+    PLACE_TOWN,
+    PLACE_VILLAGE,
+    PLACE_SUBURB,
+    PLACE_HAMLET,
+    PLACE_KIND_COUNT,
+} place_kind_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t tile_e7;       // Tile edge, degrees * 1e7
+    int32_t lat0_tile;      // Southernmost tile row (lat_e7 / tile_e7)
+    int32_t lon0_tile;      // Westernmost tile column
+    uint16_t rows;
+    uint16_t cols;
+    uint32_t count;
+    uint32_t tiles_off;
+    uint32_t places_off;
+    uint32_t strings_off;
+    uint32_t size;          // Total image size in bytes
+} place_index_header_t;
+
+typedef struct __attribute__((packed)) {
+    int32_t lat_e7;
+    int32_t lon_e7;
+    uint32_t name_off;      // Offset into the string table
+    char country[2];        // ISO 3166-1 alpha-2, lower case
+    uint8_t kind;           // place_kind_t
+    uint8_t reserved;
+} place_index_entry_t;
+
+_Static_assert(sizeof(place_index_header_t) == 44, "place index header is 44 bytes");
+_Static_assert(sizeof(place_index_entry_t) == 16, "place index entry is 16 bytes");
+
+typedef struct {
+    const char *name;       // Points into mapped flash
+    char country[3];
+    place_kind_t kind;
+    uint32_t distance_m;
+} place_result_t;
+
+typedef struct {
+    uint32_t places;
+    uint32_t lookups;
+    uint32_t found;
+    uint32_t last_lookup_us;
+} place_index_stats_t;
+
+// Map the "places" partition; ESP_ERR_NOT_FOUND if absent or not flashed,
+// ESP_ERR_INVALID_SIZE / _STATE if the image is truncated or inconsistent
+esp_err_t place_index_init(void);
+
+// Nearest place, preferring larger places over closer small ones
+bool place_index_lookup(int32_t lat_e7, int32_t lon_e7, place_result_t *out);
+
+void place_index_get_stats(place_index_stats_t *out);
+
+#endif // PLACE_INDEX_H
@@ -0,0 +1,104 @@
+/**
+ * Time Discipline (PPS PLL/FLL)
+ *
+ * Second-order loop: a proportional phase term pulls the offset towards
+ * zero while an integral term learns the crystal's frequency error, so
+ * corrections are applied as adjtime() slews instead of clock steps.
+ * Syquens B.V. - 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "time_discipline.h"
+
+void td_init(td_context_t *td) {
+    memset(td, 0, sizeof(*td));
+    td->state = TD_STATE_UNLOCKED;
+}
+
+td_result_t td_update(td_context_t *td, int64_t offset_us, int64_t pps_us) {
+    td_result_t res = { TD_ACTION_NONE, 0 };
+
+    int64_t interval_us = td->last_pps_us ? pps_us - td->last_pps_us : 1000000;
+    td->last_pps_us = pps_us;
+    td->samples++;
+
+    // First sample or large error: step and restart acquisition
+    if (td->state == TD_STATE_UNLOCKED || llabs(offset_us) > TD_STEP_THRESHOLD_US) {
+        td->state = TD_STATE_ACQUIRING;
+        td->good_samples = 0;
+        td->last_offset_us = 0;
+        td->steps++;
+        res.action = TD_ACTION_STEP;
+        res.correction_us = -offset_us;
+        return res;
+    }
+
+    uint32_t delta = (uint32_t)llabs(offset_us - td->last_offset_us);
+    td->jitter_us += ((int32_t)delta - (int32_t)td->jitter_us) / 8;
+    td->last_offset_us = (int32_t)offset_us;
+
+    // Integral term: offset accumulated per second of interval -> ppb
+    int64_t seconds = (interval_us + 500000) / 1000000;
+    if (seconds < 1) seconds = 1;
+    int64_t freq = td->freq_ppb + (offset_us * 1000 / seconds) / (1 << TD_FREQ_SHIFT);
+    if (freq > TD_FREQ_MAX_PPB) freq = TD_FREQ_MAX_PPB;
+    if (freq < -TD_FREQ_MAX_PPB) freq = -TD_FREQ_MAX_PPB;
+    td->freq_ppb = (int32_t)freq;
+
+    if (llabs(offset_us) < TD_LOCK_THRESHOLD_US) {
+        if (td->good_samples < TD_LOCK_SAMPLES) td->good_samples++;
+    } else {
+        td->good_samples = 0;
+    }
+    td->state = td->good_samples >= TD_LOCK_SAMPLES ? TD_STATE_LOCKED : TD_STATE_ACQUIRING;
+
+    // Remove a fraction of the phase error plus the expected drift until the next edge
+    res.action = TD_ACTION_SLEW;
+    res.correction_us = -(offset_us / (1 << TD_PHASE_SHIFT)) - (int64_t)td->freq_ppb / 1000;
+    return res;
+}
+
+td_result_t td_tick(td_context_t *td, int64_t now_us) {
+    td_result_t res = { TD_ACTION_NONE, 0 };
+    if (td->state == TD_STATE_UNLOCKED) return res;
+
+    int64_t since_pps = now_us - td->last_pps_us;
+
+    if (td->state == TD_STATE_HOLDOVER) {
+        if (since_pps > TD_HOLDOVER_MAX_US) {
+            td->state = TD_STATE_UNLOCKED;
+            td->good_samples = 0;
+            return res;
+        }
+        // Keep compensating the learned frequency error (~1 tick per second)
+        res.action = TD_ACTION_SLEW;
+        res.correction_us = -(int64_t)td->freq_ppb / 1000;
+    } else if (since_pps > TD_PPS_TIMEOUT_US) {
+        td->state = td->state == TD_STATE_LOCKED ? TD_STATE_HOLDOVER : TD_STATE_UNLOCKED;
+        td->good_samples = 0;
+    }
+    return res;
+}
+
+uint32_t td_dispersion_us(const td_context_t *td, int64_t now_us) {
+    uint32_t disp = td->jitter_us + (uint32_t)abs(td->last_offset_us);
+    if (td->state == TD_STATE_HOLDOVER) {
+        // Free-running since the last edge: add the assumed drift
+        disp += (uint32_t)((now_us - td->last_pps_us) * TD_HOLDOVER_DRIFT_PPB / 1000000000LL);
+    }
+    return disp;
+}
+
+int64_t td_utc_to_unix(int year, int month, int day, int hour, int minute, int second) {
+    // Days from civil (H. Hinnant), valid for the full proleptic Gregorian range
+    int y = year - (month <= 2);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = (int64_t)era * 146097 + doe - 719468;
+
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
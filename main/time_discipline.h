@@ -0,0 +1,60 @@
+/**
+ * Time Discipline (PPS PLL/FLL)
+ *
+ * Steers the system clock towards GPS PPS edges labelled by RMC time.
+ * Pure control logic - no hardware access, so it can run anywhere.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef TIME_DISCIPLINE_H
+#define TIME_DISCIPLINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    TD_STATE_UNLOCKED = 0,   // No usable PPS yet
+    TD_STATE_ACQUIRING,      // Slewing in, offset not yet stable
+    TD_STATE_LOCKED,         // Offset within TD_LOCK_THRESHOLD_US
+    TD_STATE_HOLDOVER,       // PPS lost, running on last frequency estimate
+} td_state_t;
+
+typedef enum {
+    TD_ACTION_NONE = 0,
+    TD_ACTION_STEP,          // Offset too large: step the clock
+    TD_ACTION_SLEW,          // Slew by correction_us (adjtime)
+} td_action_t;
+
+typedef struct {
+    td_state_t state;
+    int32_t freq_ppb;        // Estimated clock frequency error (integral term)
+    int32_t last_offset_us;
+    uint32_t jitter_us;      // Smoothed |offset change| between samples
+    uint8_t good_samples;    // Consecutive samples within lock threshold
+    uint32_t samples;
+    uint32_t steps;
+    int64_t last_pps_us;     // Monotonic time of last processed edge
+} td_context_t;
+
+typedef struct {
+    td_action_t action;
+    int64_t correction_us;   // Amount to add to the system clock
+} td_result_t;
+
+void td_init(td_context_t *td);
+
+// Feed one PPS sample. offset_us = system time at the edge minus the
+// true UTC of that edge; pps_us = monotonic (esp_timer) time of the edge.
+td_result_t td_update(td_context_t *td, int64_t offset_us, int64_t pps_us);
+
+// Per-second housekeeping without a PPS sample (loss detection).
+// Returns a frequency-only slew while in holdover.
+td_result_t td_tick(td_context_t *td, int64_t now_us);
+
+// Estimated clock error for NTP root dispersion
+uint32_t td_dispersion_us(const td_context_t *td, int64_t now_us);
+
+// UTC calendar time to Unix seconds (no timezone, proleptic Gregorian)
+int64_t td_utc_to_unix(int year, int month, int day, int hour, int minute, int second);
+
+#endif // TIME_DISCIPLINE_H
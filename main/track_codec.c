@@ -0,0 +1,162 @@
+/**
+ * Track Codec - compact binary encoding for batches of track records
+ *
+ * Points are delta-encoded against their predecessor, so slowly moving
+ * fixed-point values shrink to one or two varint bytes each.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "track_codec.h"
+
+static inline void put_le(uint8_t *p, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        p[i] = v >> (8 * i);
+    }
+}
+
+static inline uint32_t get_le(const uint8_t *p, int bytes) {
+    uint32_t v = 0;
+    for (int i = 0; i < bytes; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+static size_t put_uvar(uint8_t *p, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (v & 0x7F) | 0x80;
+        v >>= 7;
+    }
+    p[n++] = v;
+    return n;
+}
+
+static inline size_t put_svar(uint8_t *p, int32_t v) {
+    return put_uvar(p, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+// Returns bytes consumed, 0 on truncated or overlong input
+static size_t get_uvar(const uint8_t *p, size_t len, uint32_t *v) {
+    uint32_t result = 0;
+    for (size_t n = 0; n < len && n < 5; n++) {
+        result |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            *v = result;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static inline size_t get_svar(const uint8_t *p, size_t len, int32_t *v) {
+    uint32_t u;
+    size_t n = get_uvar(p, len, &u);
+    *v = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+    return n;
+}
+
+size_t track_codec_encode(const track_record_t *recs, int count, uint8_t *out, size_t out_size) {
+    if (count < 1 || count > 255 || out_size < TRACK_CODEC_HEADER_SIZE) return 0;
+
+    const track_record_t *first = &recs[0];
+    out[0] = TRACK_CODEC_VERSION;
+    out[1] = (uint8_t)count;
+    put_le(&out[2], first->time, 4);
+    put_le(&out[6], first->millis, 2);
+    put_le(&out[8], (uint32_t)first->lat_e7, 4);
+    put_le(&out[12], (uint32_t)first->lon_e7, 4);
+    put_le(&out[16], (uint32_t)first->alt_dm, 4);
+
+    size_t pos = TRACK_CODEC_HEADER_SIZE;
+    const track_record_t *prev = first;
+    for (int i = 0; i < count; i++) {
+        const track_record_t *r = &recs[i];
+        if (out_size - pos < TRACK_CODEC_POINT_MAX) return 0;
+
+        int64_t dt_ms = ((int64_t)r->time - prev->time) * 1000 + r->millis - prev->millis;
+        if (dt_ms < 0 || dt_ms >= UINT32_MAX) {
+            // Time went backwards (or jumped beyond the varint): restart from absolute values
+            out[pos++] = 0;
+            put_le(&out[pos], r->time, 4);
+            put_le(&out[pos + 4], r->millis, 2);
+            put_le(&out[pos + 6], (uint32_t)r->lat_e7, 4);
+            put_le(&out[pos + 10], (uint32_t)r->lon_e7, 4);
+            put_le(&out[pos + 14], (uint32_t)r->alt_dm, 4);
+            pos += 18;
+        } else {
+            // Deltas wrap modulo 2^32, so any pair (e.g. across the antimeridian) round-trips
+            pos += put_uvar(&out[pos], (uint32_t)dt_ms + 1);
+            pos += put_svar(&out[pos], (int32_t)((uint32_t)r->lat_e7 - (uint32_t)prev->lat_e7));
+            pos += put_svar(&out[pos], (int32_t)((uint32_t)r->lon_e7 - (uint32_t)prev->lon_e7));
+            pos += put_svar(&out[pos], (int32_t)((uint32_t)r->alt_dm - (uint32_t)prev->alt_dm));
+        }
+        pos += put_uvar(&out[pos], r->speed_ckn);
+        pos += put_uvar(&out[pos], r->hdop_c);
+        out[pos++] = r->sats;
+        out[pos++] = r->fix_type;
+        prev = r;
+    }
+    return pos;
+}
+
+int track_codec_decode(const uint8_t *in, size_t len, track_record_t *out, int max) {
+    if (len < TRACK_CODEC_HEADER_SIZE || in[0] != TRACK_CODEC_VERSION) return -1;
+
+    int count = in[1];
+    if (count > max) return -1;
+
+    track_record_t cur;
+    memset(&cur, 0, sizeof(cur));
+    cur.time = get_le(&in[2], 4);
+    cur.millis = get_le(&in[6], 2);
+    cur.lat_e7 = (int32_t)get_le(&in[8], 4);
+    cur.lon_e7 = (int32_t)get_le(&in[12], 4);
+    cur.alt_dm = (int32_t)get_le(&in[16], 4);
+
+    size_t pos = TRACK_CODEC_HEADER_SIZE;
+    for (int i = 0; i < count; i++) {
+        uint32_t dt_ms, speed, hdop;
+        int32_t dlat, dlon, dalt;
+        size_t n;
+
+        if (!(n = get_uvar(&in[pos], len - pos, &dt_ms))) return -1;
+        pos += n;
+        if (dt_ms == 0) {
+            if (len - pos < 18) return -1;
+            cur.time = get_le(&in[pos], 4);
+            cur.millis = get_le(&in[pos + 4], 2);
+            cur.lat_e7 = (int32_t)get_le(&in[pos + 6], 4);
+            cur.lon_e7 = (int32_t)get_le(&in[pos + 10], 4);
+            cur.alt_dm = (int32_t)get_le(&in[pos + 14], 4);
+            pos += 18;
+        } else {
+            if (!(n = get_svar(&in[pos], len - pos, &dlat))) return -1;
+            pos += n;
+            if (!(n = get_svar(&in[pos], len - pos, &dlon))) return -1;
+            pos += n;
+            if (!(n = get_svar(&in[pos], len - pos, &dalt))) return -1;
+            pos += n;
+
+            uint64_t ms = cur.millis + (uint64_t)(dt_ms - 1);
+            cur.time += (uint32_t)(ms / 1000);
+            cur.millis = ms % 1000;
+            cur.lat_e7 = (int32_t)((uint32_t)cur.lat_e7 + (uint32_t)dlat);
+            cur.lon_e7 = (int32_t)((uint32_t)cur.lon_e7 + (uint32_t)dlon);
+            cur.alt_dm = (int32_t)((uint32_t)cur.alt_dm + (uint32_t)dalt);
+        }
+        if (!(n = get_uvar(&in[pos], len - pos, &speed))) return -1;
+        pos += n;
+        if (!(n = get_uvar(&in[pos], len - pos, &hdop))) return -1;
+        pos += n;
+        if (len - pos < 2) return -1;
+
+        cur.speed_ckn = speed;
+        cur.hdop_c = hdop;
+        cur.sats = in[pos++];
+        cur.fix_type = in[pos++];
+        out[i] = cur;
+    }
+    return pos == len ? count : -1;
+}
@@ -0,0 +1,50 @@
+/**
+ * Track Codec - compact binary encoding for batches of track records
+ *
+ * Layout (all multi-byte header fields little-endian):
+ *
+ *   u8   version        TRACK_CODEC_VERSION
+ *   u8   count          Number of points (1..255)
+ *   u32  time           First point, Unix seconds
+ *   u16  millis
+ *   i32  lat_e7         Degrees * 1e7
+ *   i32  lon_e7
+ *   i32  alt_dm         Decimetres
+ *   -- then for every point (the first one included, with zero deltas) --
+ *   uvar dt_ms + 1      Milliseconds since the previous point, plus one;
+ *                       0 marks a keyframe (below)
+ *   svar dlat, dlon     Change in lat_e7 / lon_e7, modulo 2^32
+ *   svar dalt           Change in alt_dm, modulo 2^32
+ *   uvar speed_ckn      Speed over ground, 0.01 knot
+ *   uvar hdop_c         HDOP * 100
+ *   u8   sats
+ *   u8   fix_type
+ *
+ * A point whose time runs backwards (receiver reset, RTC step) is written
+ * as a keyframe: the 0 marker, then u32 time, u16 millis and i32 lat, lon,
+ * alt as absolute values in place of the deltas; the points after it are
+ * deltas against it again.
+ *
+ * uvar is an unsigned LEB128 varint, svar a zigzag-encoded LEB128 varint.
+ * A 1 Hz point typically costs 10-12 bytes instead of ~90 bytes of JSON.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef TRACK_CODEC_H
+#define TRACK_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tracklog.h"
+
+#define TRACK_CODEC_VERSION     2
+#define TRACK_CODEC_HEADER_SIZE 20
+#define TRACK_CODEC_POINT_MAX   30      // Worst-case bytes per point
+
+// Encode count records into out. Returns bytes written, 0 if out is too small.
+size_t track_codec_encode(const track_record_t *recs, int count, uint8_t *out, size_t out_size);
+
+// Decode a batch. Returns the number of records, or -1 on a malformed payload.
+int track_codec_decode(const uint8_t *in, size_t len, track_record_t *out, int max);
+
+#endif // TRACK_CODEC_H
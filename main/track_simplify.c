@@ -0,0 +1,159 @@
+/**
+ * Track Simplification (online thresholds + bounded-window Douglas-Peucker)
+ *
+ * Positions are projected onto a local flat plane around the window's
+ * anchor point; at window sizes of a few kilometres the error of that
+ * approximation is far below GPS noise.
+ * Syquens B.V. - 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#include "track_simplify.h"
+
+#define TS_EARTH_RADIUS_M   6371000.0f
+#define TS_E7_TO_RAD        ((float)M_PI / 180.0f / 1e7f)
+
+typedef struct {
+    float x;
+    float y;
+} ts_point_t;
+
+static ts_point_t project(const track_record_t *r, const track_record_t *origin, float cos_lat) {
+    ts_point_t p = {
+        (float)(r->lon_e7 - origin->lon_e7) * TS_E7_TO_RAD * cos_lat * TS_EARTH_RADIUS_M,
+        (float)(r->lat_e7 - origin->lat_e7) * TS_E7_TO_RAD * TS_EARTH_RADIUS_M,
+    };
+    return p;
+}
+
+static float distance_m(const track_record_t *a, const track_record_t *b) {
+    ts_point_t p = project(b, a, cosf(a->lat_e7 * TS_E7_TO_RAD));
+    return sqrtf(p.x * p.x + p.y * p.y);
+}
+
+static float bearing_deg(const track_record_t *from, const track_record_t *to) {
+    ts_point_t p = project(to, from, cosf(from->lat_e7 * TS_E7_TO_RAD));
+    return atan2f(p.x, p.y) * 180.0f / (float)M_PI;
+}
+
+// Distance from p to segment a-b
+static float segment_distance(ts_point_t p, ts_point_t a, ts_point_t b) {
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float len2 = dx * dx + dy * dy;
+    float t = len2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0;
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    float ex = a.x + t * dx - p.x, ey = a.y + t * dy - p.y;
+    return sqrtf(ex * ex + ey * ey);
+}
+
+// Douglas-Peucker over win[0..last], iterative with an explicit stack
+static void douglas_peucker(const ts_context_t *ts, int last, bool *keep) {
+    ts_point_t pts[TS_WINDOW_MAX];
+    float cos_lat = cosf(ts->win[0].lat_e7 * TS_E7_TO_RAD);
+    for (int i = 0; i <= last; i++) {
+        pts[i] = project(&ts->win[i], &ts->win[0], cos_lat);
+        keep[i] = false;
+    }
+    keep[0] = keep[last] = true;
+
+    struct { uint8_t first, last; } stack[TS_WINDOW_MAX];
+    int sp = 0;
+    stack[sp].first = 0;
+    stack[sp++].last = last;
+
+    while (sp > 0) {
+        sp--;
+        int a = stack[sp].first, b = stack[sp].last;
+        float worst = 0;
+        int worst_idx = -1;
+        for (int i = a + 1; i < b; i++) {
+            float d = segment_distance(pts[i], pts[a], pts[b]);
+            if (d > worst) {
+                worst = d;
+                worst_idx = i;
+            }
+        }
+        if (worst_idx >= 0 && worst > ts->cfg.max_deviation_m) {
+            keep[worst_idx] = true;
+            stack[sp].first = a;
+            stack[sp++].last = worst_idx;
+            stack[sp].first = worst_idx;
+            stack[sp++].last = b;
+        }
+    }
+}
+
+// Simplify win[0..end], emit the kept points after the anchor, and make
+// win[end] the new anchor followed by any points buffered after it
+static int emit_through(ts_context_t *ts, int end, track_record_t *out) {
+    bool keep[TS_WINDOW_MAX];
+    douglas_peucker(ts, end, keep);
+
+    int n = 0;
+    for (int i = 1; i <= end; i++) {
+        if (keep[i]) out[n++] = ts->win[i];
+    }
+
+    int remaining = ts->count - end;
+    memmove(&ts->win[0], &ts->win[end], remaining * sizeof(track_record_t));
+    ts->count = remaining;
+
+    ts->last_out_time = ts->win[0].time;
+    ts->points_out += n;
+    return n;
+}
+
+void ts_init(ts_context_t *ts, const ts_config_t *cfg) {
+    memset(ts, 0, sizeof(*ts));
+    ts->cfg = *cfg;
+    if (ts->cfg.window < 3) ts->cfg.window = 3;
+    if (ts->cfg.window > TS_WINDOW_MAX) ts->cfg.window = TS_WINDOW_MAX;
+}
+
+int ts_push(ts_context_t *ts, const track_record_t *in, track_record_t *out) {
+    ts->points_in++;
+
+    // First point of a track is always kept
+    if (ts->count == 0) {
+        ts->win[ts->count++] = *in;
+        ts->last_out_time = in->time;
+        ts->points_out++;
+        out[0] = *in;
+        return 1;
+    }
+
+    bool heartbeat = ts->cfg.max_interval_s && in->time - ts->last_out_time >= ts->cfg.max_interval_s;
+
+    // Parked or crawling: drop jitter unless a heartbeat is due
+    const track_record_t *prev = &ts->win[ts->count - 1];
+    if (!heartbeat && distance_m(prev, in) < ts->cfg.min_distance_m) {
+        return 0;
+    }
+
+    ts->win[ts->count++] = *in;
+
+    if (heartbeat || ts->count >= ts->cfg.window) {
+        return emit_through(ts, ts->count - 1, out);
+    }
+
+    // Sharp turn at the previous point: cut the window at the corner
+    if (ts->cfg.heading_deg > 0 && ts->count >= 3) {
+        const track_record_t *a = &ts->win[ts->count - 3];
+        const track_record_t *b = &ts->win[ts->count - 2];
+        float turn = fabsf(bearing_deg(b, in) - bearing_deg(a, b));
+        if (turn > 180.0f) turn = 360.0f - turn;
+        if (turn >= ts->cfg.heading_deg) {
+            return emit_through(ts, ts->count - 2, out);
+        }
+    }
+    return 0;
+}
+
+int ts_flush(ts_context_t *ts, track_record_t *out) {
+    int n = ts->count > 1 ? emit_through(ts, ts->count - 1, out) : 0;
+    ts->count = 0;
+    return n;
+}
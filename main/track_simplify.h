@@ -0,0 +1,46 @@
+/**
+ * Track Simplification (online thresholds + bounded-window Douglas-Peucker)
+ *
+ * Sits between the GPS parser and the track log. Jitter while parked is
+ * dropped by a minimum-distance gate, and sharp turns and the heartbeat
+ * interval force a point out. Everything else is buffered and reduced by
+ * Douglas-Peucker, so every buffered point that is dropped lies within
+ * max_deviation_m of the emitted polyline. Pure logic - no hardware access.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef TRACK_SIMPLIFY_H
+#define TRACK_SIMPLIFY_H
+
+#include <stdint.h>
+#include "tracklog.h"
+
+#define TS_WINDOW_MAX   64
+
+typedef struct {
+    float min_distance_m;    // Ignore fixes closer than this to the previous one
+    float max_deviation_m;   // Douglas-Peucker error bound
+    float heading_deg;       // Turn that forces the corner point out (0 = off)
+    uint32_t max_interval_s; // Emit at least one point this often (0 = off)
+    uint8_t window;          // Points buffered before simplifying (3..TS_WINDOW_MAX)
+} ts_config_t;
+
+typedef struct {
+    ts_config_t cfg;
+    track_record_t win[TS_WINDOW_MAX];  // win[0] is the last emitted point
+    int count;
+    uint32_t last_out_time;
+    uint32_t points_in;
+    uint32_t points_out;
+} ts_context_t;
+
+void ts_init(ts_context_t *ts, const ts_config_t *cfg);
+
+// Feed one fix. Points that survive simplification are written to out
+// (room for TS_WINDOW_MAX records). Returns the number written.
+int ts_push(ts_context_t *ts, const track_record_t *in, track_record_t *out);
+
+// Emit everything still buffered (e.g. on fix loss) and restart the track
+int ts_flush(ts_context_t *ts, track_record_t *out);
+
+#endif // TRACK_SIMPLIFY_H
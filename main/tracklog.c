@@ -0,0 +1,320 @@
+/**
+ * Track Log - store-and-forward ring buffer in flash
+ *
+ * Layout: the partition is a ring of 4 KB sectors. Slot 0 of each sector
+ * holds a header with a monotonically increasing sector sequence number,
+ * slots 1..127 hold track records. Records are only ever appended, in
+ * whole 256-byte flash pages where possible; the writer task buffers a
+ * page in RAM so gps_task never waits on flash. A sector is erased just
+ * before it is reused, so wear is spread evenly across the partition.
+ *
+ * Publishing clears the record's "sent" word (1 -> 0 bit writes only), so
+ * the drain position survives reboots without any extra metadata.
+ * Syquens B.V. - 2026
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "config.h"
+#include "tracklog.h"
+
+static const char *TAG = "TRACKLOG";
+
+#define TL_SECTOR_SIZE      4096
+#define TL_PAGE_SIZE        256
+#define TL_SLOTS_PER_SECTOR (TL_SECTOR_SIZE / TRACKLOG_RECORD_SIZE)
+#define TL_MAGIC            0x314B5254   // "TRK1"
+#define TL_CRC_LEN          24           // Bytes covered by track_record_t.crc
+#define TL_EMPTY            0xFFFFFFFF
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint8_t reserved[TRACKLOG_RECORD_SIZE - 8];
+} tl_header_t;
+
+static const esp_partition_t *s_part = NULL;
+static uint32_t s_sectors = 0;
+static SemaphoreHandle_t s_lock = NULL;
+static QueueHandle_t s_queue = NULL;
+
+static uint32_t s_head_off = 0;     // Next free record slot on flash
+static uint32_t s_head_seq = 0;     // Sequence number of the head sector
+static uint32_t s_drain_off = 0;    // Oldest unsent slot (valid if pending > 0)
+static uint32_t s_generation = 0;   // Bumped when unsent records are overwritten
+
+// Page buffer: records destined for s_head_off onwards, all in one flash page
+static track_record_t s_page_buf[TL_PAGE_SIZE / TRACKLOG_RECORD_SIZE];
+static int s_page_count = 0;
+
+static uint32_t s_peek_generation = 0;
+static tracklog_stats_t s_stats = {0};
+
+static uint16_t crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static bool record_valid(const track_record_t *rec) {
+    return rec->time != TL_EMPTY && rec->crc == crc16((const uint8_t *)rec, TL_CRC_LEN);
+}
+
+// A record still to be published; torn and already-sent slots are skipped
+static bool record_unsent(const track_record_t *rec) {
+    return rec->sent != 0 && record_valid(rec);
+}
+
+static inline uint32_t sector_of(uint32_t off) {
+    return off / TL_SECTOR_SIZE;
+}
+
+// Next record slot in ring order, skipping sector headers
+static uint32_t next_slot(uint32_t off) {
+    off += TRACKLOG_RECORD_SIZE;
+    if (off % TL_SECTOR_SIZE == 0) {
+        uint32_t sector = (sector_of(off)) % s_sectors;
+        off = sector * TL_SECTOR_SIZE + TRACKLOG_RECORD_SIZE;
+    }
+    return off;
+}
+
+// Erase a sector and make it the new head. Caller holds s_lock.
+static esp_err_t open_sector(uint32_t sector) {
+    uint32_t base = sector * TL_SECTOR_SIZE;
+
+    // Reclaiming the oldest sector: unsent records in it are lost
+    if (s_stats.pending && sector_of(s_drain_off) == sector) {
+        uint32_t lost = (base + TL_SECTOR_SIZE - s_drain_off) / TRACKLOG_RECORD_SIZE;
+        if (lost > s_stats.pending) lost = s_stats.pending;
+        s_stats.pending -= lost;
+        s_stats.overwritten += lost;
+        s_drain_off = ((sector + 1) % s_sectors) * TL_SECTOR_SIZE + TRACKLOG_RECORD_SIZE;
+        s_generation++;
+    }
+
+    esp_err_t err = esp_partition_erase_range(s_part, base, TL_SECTOR_SIZE);
+    if (err != ESP_OK) return err;
+    s_stats.sector_erases++;
+
+    tl_header_t hdr;
+    memset(&hdr, 0xFF, sizeof(hdr));
+    hdr.magic = TL_MAGIC;
+    hdr.seq = ++s_head_seq;
+    err = esp_partition_write(s_part, base, &hdr, sizeof(hdr));
+
+    s_head_off = base + TRACKLOG_RECORD_SIZE;
+    return err;
+}
+
+static void flush_page(void) {
+    if (s_page_count == 0) return;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    size_t bytes = s_page_count * TRACKLOG_RECORD_SIZE;
+    if (esp_partition_write(s_part, s_head_off, s_page_buf, bytes) == ESP_OK) {
+        if (s_stats.pending == 0) {
+            s_drain_off = s_head_off;
+        }
+        s_stats.pending += s_page_count;
+        s_stats.appended += s_page_count;
+        s_stats.page_writes++;
+    } else {
+        ESP_LOGE(TAG, "Flash write failed at 0x%lx", (unsigned long)s_head_off);
+    }
+
+    s_head_off += bytes;
+    if (s_head_off % TL_SECTOR_SIZE == 0) {
+        open_sector(sector_of(s_head_off) % s_sectors);
+    }
+    s_page_count = 0;
+
+    xSemaphoreGive(s_lock);
+}
+
+static void tracklog_task(void *pvParameters) {
+    track_record_t rec;
+
+    while (1) {
+        if (xQueueReceive(s_queue, &rec, pdMS_TO_TICKS(TRACKLOG_FLUSH_MS)) != pdTRUE) {
+            flush_page();  // Idle: commit a partial page
+            continue;
+        }
+
+        s_page_buf[s_page_count++] = rec;
+
+        // Flush when the buffered records reach the end of the flash page
+        uint32_t end = s_head_off + s_page_count * TRACKLOG_RECORD_SIZE;
+        if (end % TL_PAGE_SIZE == 0) {
+            flush_page();
+        }
+    }
+}
+
+bool tracklog_append(const track_record_t *rec) {
+    if (!s_queue) return false;
+
+    track_record_t r = *rec;
+    r.reserved = 0xFFFF;
+    r.sent = TL_EMPTY;
+    r.crc = crc16((const uint8_t *)&r, TL_CRC_LEN);
+
+    if (xQueueSend(s_queue, &r, 0) != pdTRUE) {
+        s_stats.queue_drops++;
+        return false;
+    }
+    return true;
+}
+
+int tracklog_peek_unsent(track_record_t *out, int max) {
+    if (!s_part) return 0;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int n = 0;
+    uint32_t off = s_drain_off;
+    while (n < (int)s_stats.pending && n < max && off != s_head_off) {
+        if (esp_partition_read(s_part, off, &out[n], TRACKLOG_RECORD_SIZE) == ESP_OK &&
+            record_unsent(&out[n])) {
+            n++;
+        }
+        off = next_slot(off);
+    }
+    s_peek_generation = s_generation;
+    xSemaphoreGive(s_lock);
+    return n;
+}
+
+esp_err_t tracklog_mark_sent(int count) {
+    if (!s_part) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (s_peek_generation != s_generation) {
+        // Records were overwritten since the peek; drain position already moved
+        xSemaphoreGive(s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Torn slots passed on the way are cleared too, so recovery never
+    // mistakes one for the drain position
+    static const uint32_t sent = 0;
+    int marked = 0;
+    while (marked < count && s_stats.pending && s_drain_off != s_head_off) {
+        track_record_t rec;
+        esp_partition_read(s_part, s_drain_off, &rec, TRACKLOG_RECORD_SIZE);
+        if (rec.time != TL_EMPTY && rec.sent != 0) {
+            esp_partition_write(s_part, s_drain_off + offsetof(track_record_t, sent), &sent, sizeof(sent));
+            if (record_valid(&rec)) {
+                marked++;
+                s_stats.pending--;
+            }
+        }
+        s_drain_off = next_slot(s_drain_off);
+    }
+    s_stats.sent += marked;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
+
+void tracklog_get_stats(tracklog_stats_t *out) {
+    if (s_lock) xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out = s_stats;
+    if (s_lock) xSemaphoreGive(s_lock);
+}
+
+// Rebuild head/drain positions from flash after boot
+static esp_err_t recover(void) {
+    // Find the newest sector; sectors without a valid header are unused
+    int32_t head_sector = -1;
+    for (uint32_t i = 0; i < s_sectors; i++) {
+        tl_header_t hdr;
+        if (esp_partition_read(s_part, i * TL_SECTOR_SIZE, &hdr, sizeof(hdr)) != ESP_OK) continue;
+        if (hdr.magic == TL_MAGIC && (head_sector < 0 || hdr.seq > s_head_seq)) {
+            head_sector = i;
+            s_head_seq = hdr.seq;
+        }
+    }
+
+    if (head_sector < 0) {
+        ESP_LOGI(TAG, "Empty log, formatting sector 0");
+        s_head_seq = 0;
+        return open_sector(0);
+    }
+
+    // Walk all sectors oldest -> newest: first unsent record is the drain
+    // position, the first empty slot in the head sector is the write position
+    s_head_off = 0;
+    for (uint32_t n = 1; n <= s_sectors; n++) {
+        uint32_t sector = (head_sector + n) % s_sectors;
+        uint32_t base = sector * TL_SECTOR_SIZE;
+
+        tl_header_t hdr;
+        esp_partition_read(s_part, base, &hdr, sizeof(hdr));
+        if (hdr.magic != TL_MAGIC) continue;
+
+        // Fast path: last slot already published -> whole sector was drained
+        track_record_t last;
+        esp_partition_read(s_part, base + TL_SECTOR_SIZE - TRACKLOG_RECORD_SIZE, &last, sizeof(last));
+        if (sector != (uint32_t)head_sector && record_valid(&last) && last.sent == 0) continue;
+
+        for (uint32_t slot = 1; slot < TL_SLOTS_PER_SECTOR; slot++) {
+            uint32_t off = base + slot * TRACKLOG_RECORD_SIZE;
+            track_record_t rec;
+            esp_partition_read(s_part, off, &rec, sizeof(rec));
+
+            if (rec.time == TL_EMPTY) {
+                if (sector == (uint32_t)head_sector) {
+                    s_head_off = off;
+                    break;
+                }
+                continue;
+            }
+            if (record_unsent(&rec)) {
+                if (s_stats.pending == 0) s_drain_off = off;
+                s_stats.pending++;
+            }
+        }
+    }
+
+    // Head sector full: move on to the next one
+    if (s_head_off == 0) {
+        return open_sector((head_sector + 1) % s_sectors);
+    }
+    return ESP_OK;
+}
+
+esp_err_t tracklog_init(void) {
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, TRACKLOG_PARTITION_SUBTYPE,
+                                      TRACKLOG_PARTITION_LABEL);
+    if (!s_part) {
+        ESP_LOGW(TAG, "No '%s' partition - track logging disabled", TRACKLOG_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_sectors = s_part->size / TL_SECTOR_SIZE;
+    s_lock = xSemaphoreCreateMutex();
+
+    esp_err_t err = recover();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Recovery failed: %s", esp_err_to_name(err));
+        s_part = NULL;
+        return err;
+    }
+
+    s_queue = xQueueCreate(TRACKLOG_QUEUE_LEN, sizeof(track_record_t));
+    xTaskCreate(tracklog_task, "tracklog", TRACKLOG_TASK_STACK, NULL, TRACKLOG_TASK_PRIORITY, NULL);
+
+    ESP_LOGI(TAG, "Track log: %lu sectors, %lu unsent records",
+             (unsigned long)s_sectors, (unsigned long)s_stats.pending);
+    return ESP_OK;
+}
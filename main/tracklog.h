@@ -0,0 +1,59 @@
+/**
+ * Track Log - store-and-forward ring buffer in flash
+ *
+ * Fixed 32-byte records appended to the "tracklog" data partition
+ * Syquens B.V. - 2026
+ */
+
+#ifndef TRACKLOG_H
+#define TRACKLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define TRACKLOG_RECORD_SIZE    32
+
+// One logged fix. Layout is the on-flash format - do not reorder.
+typedef struct __attribute__((packed)) {
+    uint32_t time;          // Unix seconds (UTC)
+    int32_t lat_e7;         // Degrees * 1e7
+    int32_t lon_e7;
+    int32_t alt_dm;         // Altitude, decimetres
+    uint16_t millis;
+    uint16_t speed_ckn;     // Speed over ground, 0.01 knot
+    uint16_t hdop_c;        // HDOP * 100
+    uint8_t sats;
+    uint8_t fix_type;
+    uint16_t crc;           // CRC-16 over the bytes before this field
+    uint16_t reserved;      // 0xFFFF
+    uint32_t sent;          // 0xFFFFFFFF until published, then 0
+} track_record_t;
+
+_Static_assert(sizeof(track_record_t) == TRACKLOG_RECORD_SIZE, "track record must be 32 bytes");
+
+typedef struct {
+    uint32_t appended;      // Records written to flash
+    uint32_t queue_drops;   // Records lost because the writer queue was full
+    uint32_t overwritten;   // Unsent records lost to ring wrap-around
+    uint32_t sent;          // Records marked as published
+    uint32_t pending;       // Unsent records currently in flash
+    uint32_t page_writes;
+    uint32_t sector_erases;
+} tracklog_stats_t;
+
+// Mount the partition, recover head/drain positions and start the writer task
+esp_err_t tracklog_init(void);
+
+// Queue a record for writing. Never blocks; safe to call from gps_task.
+bool tracklog_append(const track_record_t *rec);
+
+// Read up to max of the oldest unsent records. Returns the count read.
+int tracklog_peek_unsent(track_record_t *out, int max);
+
+// Mark the first count records returned by tracklog_peek_unsent as sent
+esp_err_t tracklog_mark_sent(int count);
+
+void tracklog_get_stats(tracklog_stats_t *out);
+
+#endif // TRACKLOG_H
@@ -0,0 +1,328 @@
+/**
+ * u-blox UBX Protocol - frame codec and receiver configuration
+ *
+ * The configuration sequence has no clock of its own: waits are bounded
+ * by the port read timeout and by the number of bytes the link can carry
+ * in that time, since the receiver streams continuously.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "ubx.h"
+
+enum {
+    ST_SYNC1 = 0,
+    ST_SYNC2,
+    ST_CLASS,
+    ST_ID,
+    ST_LEN1,
+    ST_LEN2,
+    ST_PAYLOAD,
+    ST_CK_A,
+    ST_CK_B,
+};
+
+typedef enum {
+    ACK_OK = 0,
+    ACK_NAK,
+    ACK_TIMEOUT,
+} ack_t;
+
+#define UBX_SETTLE_MS       100     // Receiver applies a new port rate after this
+
+static inline void checksum(ubx_parser_t *p, uint8_t byte) {
+    p->ck_a += byte;
+    p->ck_b += p->ck_a;
+}
+
+void ubx_parser_reset(ubx_parser_t *p) {
+    memset(p, 0, sizeof(*p));
+}
+
+bool ubx_parse_byte(ubx_parser_t *p, uint8_t byte) {
+    switch (p->state) {
+    case ST_SYNC1:
+        if (byte == UBX_SYNC1) p->state = ST_SYNC2;
+        return false;
+    case ST_SYNC2:
+        p->state = byte == UBX_SYNC2 ? ST_CLASS : (byte == UBX_SYNC1 ? ST_SYNC2 : ST_SYNC1);
+        return false;
+    case ST_CLASS:
+        p->ck_a = p->ck_b = 0;
+        checksum(p, byte);
+        p->cls = byte;
+        p->state = ST_ID;
+        return false;
+    case ST_ID:
+        checksum(p, byte);
+        p->id = byte;
+        p->state = ST_LEN1;
+        return false;
+    case ST_LEN1:
+        checksum(p, byte);
+        p->len = byte;
+        p->state = ST_LEN2;
+        return false;
+    case ST_LEN2:
+        checksum(p, byte);
+        p->len |= (uint16_t)byte << 8;
+        p->pos = 0;
+        if (p->len > UBX_MAX_PAYLOAD) {
+            // Too long for us, or a false sync: hunt for the next frame
+            // right away instead of swallowing up to 64 KB of stream
+            p->oversized++;
+            p->state = ST_SYNC1;
+            return false;
+        }
+        p->state = p->len ? ST_PAYLOAD : ST_CK_A;
+        return false;
+    case ST_PAYLOAD:
+        checksum(p, byte);
+        p->payload[p->pos] = byte;
+        if (++p->pos == p->len) p->state = ST_CK_A;
+        return false;
+    case ST_CK_A:
+        p->state = byte == p->ck_a ? ST_CK_B : ST_SYNC1;
+        if (p->state == ST_SYNC1) p->checksum_errors++;
+        return false;
+    case ST_CK_B:
+        p->state = ST_SYNC1;
+        if (byte != p->ck_b) {
+            p->checksum_errors++;
+            return false;
+        }
+        p->frames++;
+        return true;
+    default:
+        p->state = ST_SYNC1;
+        return false;
+    }
+}
+
+size_t ubx_parse(ubx_parser_t *p, const uint8_t *data, size_t len, bool *frame) {
+    size_t i = 0;
+    *frame = false;
+    while (i < len) {
+        if (p->state != ST_PAYLOAD) {
+            if (ubx_parse_byte(p, data[i++])) {
+                *frame = true;
+                break;
+            }
+            continue;
+        }
+
+        // Payload: tight checksum/copy loop instead of the per-byte switch
+        size_t run = len - i;
+        if (run > (size_t)(p->len - p->pos)) run = p->len - p->pos;
+        uint8_t ck_a = p->ck_a, ck_b = p->ck_b;
+        for (size_t k = 0; k < run; k++) {
+            ck_a += data[i + k];
+            ck_b += ck_a;
+        }
+        p->ck_a = ck_a;
+        p->ck_b = ck_b;
+        memcpy(&p->payload[p->pos], &data[i], run);
+        p->pos += run;
+        i += run;
+        if (p->pos == p->len) p->state = ST_CK_A;
+    }
+    return i;
+}
+
+size_t ubx_build(uint8_t cls, uint8_t id, const void *payload, uint16_t len,
+                 uint8_t *out, size_t size) {
+    if (size < (size_t)len + UBX_OVERHEAD) return 0;
+
+    out[0] = UBX_SYNC1;
+    out[1] = UBX_SYNC2;
+    out[2] = cls;
+    out[3] = id;
+    out[4] = (uint8_t)len;
+    out[5] = (uint8_t)(len >> 8);
+    if (len) memcpy(&out[6], payload, len);
+
+    uint8_t ck_a = 0, ck_b = 0;
+    for (size_t i = 2; i < (size_t)len + 6; i++) {
+        ck_a += out[i];
+        ck_b += ck_a;
+    }
+    out[len + 6] = ck_a;
+    out[len + 7] = ck_b;
+    return (size_t)len + UBX_OVERHEAD;
+}
+
+bool ubx_decode_nav_pvt(const ubx_parser_t *p, ubx_nav_pvt_t *out) {
+    if (p->cls != UBX_CLASS_NAV || p->id != UBX_NAV_PVT || p->len < sizeof(*out)) return false;
+    memcpy(out, p->payload, sizeof(*out));  // Both ends are little-endian
+    return true;
+}
+
+bool ubx_decode_nav_timeutc(const ubx_parser_t *p, ubx_nav_timeutc_t *out) {
+    if (p->cls != UBX_CLASS_NAV || p->id != UBX_NAV_TIMEUTC || p->len < sizeof(*out)) return false;
+    memcpy(out, p->payload, sizeof(*out));
+    return true;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+// Bytes the link carries in ms at baud (10 bits per byte, 8N1)
+static uint32_t link_bytes(uint32_t baud, uint32_t ms) {
+    return baud / 10 * ms / 1000;
+}
+
+// Read until the ACK/NAK for cls/id arrives, the port goes quiet for
+// timeout_ms, or about timeout_ms worth of other traffic has passed
+static ack_t wait_ack(const hal_uart_t *uart, uint32_t baud, uint32_t timeout_ms,
+                      uint8_t cls, uint8_t id) {
+    ubx_parser_t p;
+    ubx_parser_reset(&p);
+    uint32_t budget = link_bytes(baud, timeout_ms);
+    uint8_t buf[UBX_OVERHEAD + 2];  // One ACK frame
+
+    while (budget) {
+        size_t want = budget < sizeof(buf) ? budget : sizeof(buf);
+        int n = uart->read(uart->ctx, buf, want, timeout_ms);
+        if (n <= 0) break;
+        budget = (uint32_t)n < budget ? budget - n : 0;
+
+        for (int i = 0; i < n; i++) {
+            if (ubx_parse_byte(&p, buf[i]) && p.cls == UBX_CLASS_ACK && p.len == 2 &&
+                p.payload[0] == cls && p.payload[1] == id) {
+                return p.id == UBX_ACK_ACK ? ACK_OK : ACK_NAK;
+            }
+        }
+    }
+    return ACK_TIMEOUT;
+}
+
+// Discard input for about ms (lets the receiver finish a rate change)
+static void settle(const hal_uart_t *uart, uint32_t baud, uint32_t ms) {
+    uint32_t budget = link_bytes(baud, ms);
+    uint8_t buf[32];
+    while (budget) {
+        int n = uart->read(uart->ctx, buf, budget < sizeof(buf) ? budget : sizeof(buf), ms);
+        if (n <= 0) break;
+        budget = (uint32_t)n < budget ? budget - n : 0;
+    }
+}
+
+// Send a CFG message and wait for its ACK; res may be NULL (probes)
+static ack_t send_cfg(const hal_uart_t *uart, const ubx_config_t *cfg, uint32_t baud,
+                      uint8_t id, const uint8_t *payload, uint16_t len, ubx_config_result_t *res) {
+    uint8_t frame[UBX_OVERHEAD + 20];
+    size_t n = ubx_build(UBX_CLASS_CFG, id, payload, len, frame, sizeof(frame));
+    if (n == 0 || uart->write(uart->ctx, frame, n) != ESP_OK) return ACK_TIMEOUT;
+
+    ack_t ack = wait_ack(uart, baud, cfg->ack_timeout_ms, UBX_CLASS_CFG, id);
+    if (res) {
+        if (ack == ACK_OK) res->acks++;
+        else if (ack == ACK_NAK) res->naks++;
+        else res->timeouts++;
+    }
+    return ack;
+}
+
+static ack_t set_nmea_rate(const hal_uart_t *uart, const ubx_config_t *cfg, uint32_t baud,
+                           uint8_t nmea_id, uint8_t rate, ubx_config_result_t *res) {
+    const uint8_t msg[3] = { UBX_CLASS_NMEA, nmea_id, rate };  // Rate on the current port
+    return send_cfg(uart, cfg, baud, UBX_CFG_MSG, msg, sizeof(msg), res);
+}
+
+// Any answer proves the receiver speaks UBX at this rate. Muting GSV
+// doubles as the probe: it is idempotent and wanted anyway.
+static bool probe(const hal_uart_t *uart, const ubx_config_t *cfg, uint32_t baud) {
+    uart->set_baud(uart->ctx, baud);
+    return set_nmea_rate(uart, cfg, baud, NMEA_ID_GSV, 0, NULL) != ACK_TIMEOUT;
+}
+
+// CFG-PRT for UART1: 8N1 at baud, UBX+NMEA both ways. The receiver
+// switches after replying, so the ACK is often garbled; not checked.
+// False if the frame was not sent: the receiver is still on link_baud.
+static bool set_port_baud(const hal_uart_t *uart, uint32_t link_baud, uint32_t new_baud) {
+    uint8_t prt[20] = {0};
+    prt[0] = 1;                     // Port ID: UART1
+    put_u32(&prt[4], 0x000008D0);   // mode: 8 data bits, no parity, 1 stop bit
+    put_u32(&prt[8], new_baud);
+    put_u16(&prt[12], 0x0003);      // inProtoMask: UBX | NMEA
+    put_u16(&prt[14], 0x0003);      // outProtoMask: UBX | NMEA
+
+    uint8_t frame[UBX_OVERHEAD + sizeof(prt)];
+    size_t n = ubx_build(UBX_CLASS_CFG, UBX_CFG_PRT, prt, sizeof(prt), frame, sizeof(frame));
+    if (n == 0 || uart->write(uart->ctx, frame, n) != ESP_OK) return false;
+    settle(uart, link_baud, UBX_SETTLE_MS);
+    return true;
+}
+
+esp_err_t ubx_set_msg_rate(const hal_uart_t *uart, uint8_t cls, uint8_t id, uint8_t rate) {
+    const uint8_t msg[3] = { cls, id, rate };
+    uint8_t frame[UBX_OVERHEAD + sizeof(msg)];
+    size_t n = ubx_build(UBX_CLASS_CFG, UBX_CFG_MSG, msg, sizeof(msg), frame, sizeof(frame));
+    if (n == 0) return ESP_ERR_INVALID_SIZE;
+    return uart->write(uart->ctx, frame, n);
+}
+
+bool ubx_configure(const hal_uart_t *uart, const ubx_config_t *cfg, ubx_config_result_t *res) {
+    memset(res, 0, sizeof(*res));
+
+    // Warm restart: the receiver may still be on the target rate
+    uint32_t baud = cfg->baud;
+    bool found = probe(uart, cfg, baud);
+
+    if (!found && cfg->fallback_baud != cfg->baud) {
+        baud = cfg->fallback_baud;
+        found = probe(uart, cfg, baud);
+
+        // If CFG-PRT did not go out the receiver stays on the fallback
+        if (found && set_port_baud(uart, baud, cfg->baud)) {
+            if (probe(uart, cfg, cfg->baud)) {
+                baud = cfg->baud;
+            } else {
+                // New rate not confirmed: put both ends back on the fallback
+                set_port_baud(uart, cfg->baud, cfg->fallback_baud);
+                found = probe(uart, cfg, baud);
+            }
+        }
+    }
+
+    res->responding = found;
+    res->baud = baud;
+    if (!found) {
+        uart->set_baud(uart->ctx, cfg->fallback_baud);
+        res->baud = cfg->fallback_baud;
+        return false;
+    }
+
+    // Only RMC and GGA are parsed; everything else just costs UART time
+    static const uint8_t muted[] = { NMEA_ID_GLL, NMEA_ID_GSA, NMEA_ID_GSV, NMEA_ID_VTG };
+    for (size_t i = 0; i < sizeof(muted); i++) {
+        set_nmea_rate(uart, cfg, baud, muted[i], 0, res);
+    }
+
+    // NAV-PVT replaces RMC + GGA. Older receivers NAK it, which is not an
+    // error. Some ACK it and never send one, so RMC and GGA stay on until
+    // the caller has decoded a frame (ubx_set_msg_rate).
+    if (cfg->nav_pvt) {
+        const uint8_t msg[3] = { UBX_CLASS_NAV, UBX_NAV_PVT, 1 };
+        if (send_cfg(uart, cfg, baud, UBX_CFG_MSG, msg, sizeof(msg), NULL) == ACK_OK) {
+            res->nav_pvt = true;
+        }
+    }
+
+    uint8_t rate[6];
+    put_u16(&rate[0], cfg->meas_rate_ms);
+    put_u16(&rate[2], 1);           // navRate: one solution per measurement
+    put_u16(&rate[4], 1);           // timeRef: GPS time
+    if (send_cfg(uart, cfg, baud, UBX_CFG_RATE, rate, sizeof(rate), res) == ACK_OK) {
+        res->meas_rate_ms = cfg->meas_rate_ms;
+    }
+
+    return res->naks == 0 && res->timeouts == 0;
+}
@@ -0,0 +1,169 @@
+/**
+ * u-blox UBX Protocol - frame codec and receiver configuration
+ *
+ * Frame: 0xB5 0x62, class, id, u16 length (LE), payload, Fletcher-8 CK_A/CK_B
+ * over class..payload. Configuration messages (CFG-*) are answered with
+ * ACK-ACK or ACK-NAK carrying the class/id they refer to.
+ *
+ * NAV-PVT (protocol 15+, u-blox 7/8 and later) delivers a complete fix per
+ * epoch; the NEO-6M NAKs it and stays on NMEA.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef UBX_H
+#define UBX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hal.h"
+
+#define UBX_SYNC1           0xB5
+#define UBX_SYNC2           0x62
+#define UBX_OVERHEAD        8       // Sync, class, id, length, checksum
+#define UBX_MAX_PAYLOAD     100     // Largest message we parse (NAV-PVT is 92)
+
+#define UBX_CLASS_NAV       0x01
+#define UBX_CLASS_ACK       0x05
+#define UBX_CLASS_CFG       0x06
+#define UBX_CLASS_NMEA      0xF0
+
+#define UBX_ACK_NAK         0x00
+#define UBX_ACK_ACK         0x01
+#define UBX_CFG_PRT         0x00
+#define UBX_CFG_MSG         0x01
+#define UBX_CFG_RATE        0x08
+#define UBX_NAV_PVT         0x07
+#define UBX_NAV_TIMEUTC     0x21
+
+// Standard NMEA sentences, as message ids in UBX_CLASS_NMEA
+#define NMEA_ID_GGA         0x00
+#define NMEA_ID_GLL         0x01
+#define NMEA_ID_GSA         0x02
+#define NMEA_ID_GSV         0x03
+#define NMEA_ID_RMC         0x04
+#define NMEA_ID_VTG         0x05
+
+// NAV-PVT payload. Little-endian wire layout, decoded by copying.
+typedef struct __attribute__((packed)) {
+    uint32_t itow;          // GPS time of week, ms
+    uint16_t year;          // UTC
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;          // UBX_PVT_VALID_*
+    uint32_t t_acc;         // Time accuracy, ns
+    int32_t nano;           // Correction to the fields above, ns (may be negative)
+    uint8_t fix_type;       // 0 none, 1 DR, 2 2D, 3 3D, 4 GNSS+DR, 5 time only
+    uint8_t flags;          // UBX_PVT_FLAGS_*
+    uint8_t flags2;
+    uint8_t num_sv;
+    int32_t lon;            // Degrees * 1e7
+    int32_t lat;
+    int32_t height;         // Above ellipsoid, mm
+    int32_t h_msl;          // Above mean sea level, mm
+    uint32_t h_acc;         // mm
+    uint32_t v_acc;
+    int32_t vel_n;          // mm/s
+    int32_t vel_e;
+    int32_t vel_d;
+    int32_t g_speed;        // Ground speed, mm/s
+    int32_t head_mot;       // Heading of motion, degrees * 1e5
+    uint32_t s_acc;         // Speed accuracy, mm/s
+    uint32_t head_acc;      // Degrees * 1e5
+    uint16_t p_dop;         // * 0.01
+    uint8_t reserved1[6];
+    int32_t head_veh;
+    int16_t mag_dec;
+    uint16_t mag_acc;
+} ubx_nav_pvt_t;
+
+_Static_assert(sizeof(ubx_nav_pvt_t) == 92, "NAV-PVT payload is 92 bytes");
+
+#define UBX_PVT_VALID_DATE      0x01
+#define UBX_PVT_VALID_TIME      0x02
+#define UBX_PVT_FLAGS_FIX_OK    0x01
+#define UBX_PVT_FLAGS_DIFF      0x02
+
+// NAV-TIMEUTC payload
+typedef struct __attribute__((packed)) {
+    uint32_t itow;
+    uint32_t t_acc;         // ns
+    int32_t nano;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;          // UBX_TIMEUTC_VALID_UTC when the fields are UTC
+} ubx_nav_timeutc_t;
+
+_Static_assert(sizeof(ubx_nav_timeutc_t) == 20, "NAV-TIMEUTC payload is 20 bytes");
+
+#define UBX_TIMEUTC_VALID_UTC   0x04
+
+// Streaming frame parser; NMEA and noise between frames are skipped
+typedef struct {
+    uint8_t state;
+    uint8_t cls;
+    uint8_t id;
+    uint16_t len;
+    uint16_t pos;
+    uint8_t ck_a;
+    uint8_t ck_b;
+    uint8_t payload[UBX_MAX_PAYLOAD];
+    uint32_t frames;        // Valid frames received
+    uint32_t checksum_errors;
+    uint32_t oversized;     // Lengths above UBX_MAX_PAYLOAD (dropped, parser resyncs)
+} ubx_parser_t;
+
+void ubx_parser_reset(ubx_parser_t *p);
+
+// Feed one byte; true when a complete, checksum-valid frame is in p
+bool ubx_parse_byte(ubx_parser_t *p, uint8_t byte);
+
+// Feed a buffer, stopping right after a complete frame (*frame = true).
+// Payload runs are copied in bulk. Returns the number of bytes consumed.
+size_t ubx_parse(ubx_parser_t *p, const uint8_t *data, size_t len, bool *frame);
+
+// Build a frame into out; returns its length, 0 if it does not fit
+size_t ubx_build(uint8_t cls, uint8_t id, const void *payload, uint16_t len,
+                 uint8_t *out, size_t size);
+
+// Decode the frame in p; false if it is not that message or is truncated
+bool ubx_decode_nav_pvt(const ubx_parser_t *p, ubx_nav_pvt_t *out);
+bool ubx_decode_nav_timeutc(const ubx_parser_t *p, ubx_nav_timeutc_t *out);
+
+typedef struct {
+    uint32_t baud;          // Link rate to switch to
+    uint32_t fallback_baud; // Receiver power-up rate
+    uint16_t meas_rate_ms;  // Navigation epoch, e.g. 200 for 5 Hz
+    uint32_t ack_timeout_ms;
+    bool nav_pvt;           // Switch to NAV-PVT output if the receiver supports it
+} ubx_config_t;
+
+typedef struct {
+    bool responding;        // Receiver answered UBX at some baud rate
+    uint32_t baud;          // Rate the link ended up on
+    uint16_t meas_rate_ms;  // Acknowledged epoch, 0 if unchanged
+    bool nav_pvt;           // NAV-PVT enabled; RMC/GGA still on
+    uint8_t acks;
+    uint8_t naks;
+    uint8_t timeouts;
+} ubx_config_result_t;
+
+// Find the receiver (target rate first, then fallback), move it to
+// cfg->baud, mute the NMEA sentences the firmware does not parse and set
+// the navigation rate. RMC and GGA stay on even when NAV-PVT is accepted.
+// If the new baud rate cannot be confirmed the link is put back on
+// fallback_baud. Leaves the port at res->baud.
+bool ubx_configure(const hal_uart_t *uart, const ubx_config_t *cfg, ubx_config_result_t *res);
+
+// CFG-MSG without waiting for the ACK, for use once the GPS task reads the
+// port (the ACK arrives with the data and is skipped there)
+esp_err_t ubx_set_msg_rate(const hal_uart_t *uart, uint8_t cls, uint8_t id, uint8_t rate);
+
+#endif // UBX_H
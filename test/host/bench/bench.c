@@ -0,0 +1,120 @@
+/**
+ * Host benchmark runner - see bench.h
+ *
+ *   bench [--quick] [group ...]
+ *
+ * Without group names every group runs.
+ * Syquens B.V. - 2026
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+static const struct {
+    const char *name;
+    void (*run)(bench_t *b);
+} s_groups[] = {
+    { "hal", bench_hal },
+    { "nmea", bench_nmea },
+    { "codec", bench_codec },
+    { "simplify", bench_simplify },
+    { "kalman", bench_kalman },
+    { "ubx", bench_ubx },
+    { "gps_rx", bench_gps_rx },
+    { "ntp", bench_ntp },
+    { "oled", bench_oled },
+};
+
+#define GROUP_COUNT (sizeof(s_groups) / sizeof(s_groups[0]))
+
+static uint32_t s_lat_ns[BENCH_MAX_CALLS];
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Latency in a fixed-width column: ns, us or ms
+static void fmt_ns(char *buf, size_t size, uint32_t ns) {
+    if (ns < 10000) snprintf(buf, size, "%u ns", ns);
+    else if (ns < 10000000) snprintf(buf, size, "%.1f us", ns / 1e3);
+    else snprintf(buf, size, "%.1f ms", ns / 1e6);
+}
+
+void bench_measure(bench_t *b, const char *stage, bench_fn_t fn, void *arg, uint32_t items, uint32_t bytes) {
+    uint64_t budget_ns = b->quick ? 0 : (uint64_t)BENCH_TIME_MS * 1000000ULL;
+    int min_calls = b->quick ? 3 : 10;
+
+    fn(arg);  // Warm-up: caches, lazy init
+
+    int calls = 0;
+    uint64_t start = bench_now_ns(), end = start;
+    while (calls < BENCH_MAX_CALLS && (calls < min_calls || end - start < budget_ns)) {
+        uint64_t t0 = bench_now_ns();
+        fn(arg);
+        end = bench_now_ns();
+        uint64_t dt = end - t0;
+        s_lat_ns[calls++] = dt > UINT32_MAX ? UINT32_MAX : (uint32_t)dt;
+    }
+
+    double secs = (end - start) / 1e9;
+    qsort(s_lat_ns, calls, sizeof(s_lat_ns[0]), cmp_u32);
+    char p50[16], p99[16], max[16];
+    fmt_ns(p50, sizeof(p50), s_lat_ns[calls / 2]);
+    fmt_ns(p99, sizeof(p99), s_lat_ns[(calls * 99) / 100]);
+    fmt_ns(max, sizeof(max), s_lat_ns[calls - 1]);
+
+    printf("  %-28s %12.0f items/s", stage, secs > 0 ? (double)items * calls / secs : 0);
+    if (bytes) {
+        printf(" %8.2f MB/s", secs > 0 ? (double)bytes * calls / secs / 1e6 : 0);
+    } else {
+        printf(" %13s", "");
+    }
+    printf("   p50 %-9s p99 %-9s max %s\n", p50, p99, max);
+}
+
+void bench_note(bench_t *b, const char *stage, const char *fmt, ...) {
+    (void)b;
+    va_list ap;
+    va_start(ap, fmt);
+    printf("  %-28s ", stage);
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+}
+
+int main(int argc, char **argv) {
+    bench_t b = {0};
+    const char *only[GROUP_COUNT + 1];
+    int only_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            b.quick = true;
+        } else if (only_count < (int)GROUP_COUNT) {
+            only[only_count++] = argv[i];
+        }
+    }
+
+    for (size_t g = 0; g < GROUP_COUNT; g++) {
+        bool selected = only_count == 0;
+        for (int i = 0; i < only_count; i++) {
+            if (strcmp(only[i], s_groups[g].name) == 0) selected = true;
+        }
+        if (!selected) continue;
+
+        printf("[%s]\n", s_groups[g].name);
+        s_groups[g].run(&b);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+/**
+ * Host benchmark runner
+ *
+ * Each group times its stages with bench_measure: the stage function is
+ * called repeatedly (for BENCH_TIME_MS, or a few calls with --quick) and
+ * the report gives items/s, MB/s and per-call latency percentiles.
+ * Figures that are not timings (ratios, errors, drops) go out through
+ * bench_note so they land in the same table.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BENCH_TIME_MS   300
+#define BENCH_MAX_CALLS 200000
+
+typedef struct {
+    bool quick;
+} bench_t;
+
+typedef void (*bench_fn_t)(void *arg);
+
+// Time fn(arg); each call handles items items and bytes input bytes (0 = n/a)
+void bench_measure(bench_t *b, const char *stage, bench_fn_t fn, void *arg, uint32_t items, uint32_t bytes);
+
+// One line of free-form results for the stage
+void bench_note(bench_t *b, const char *stage, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+// Monotonic nanoseconds
+uint64_t bench_now_ns(void);
+
+// Groups, one per bench_*.c
+void bench_hal(bench_t *b);
+void bench_nmea(bench_t *b);
+void bench_codec(bench_t *b);
+void bench_simplify(bench_t *b);
+void bench_kalman(bench_t *b);
+void bench_ubx(bench_t *b);
+void bench_gps_rx(bench_t *b);
+void bench_ntp(bench_t *b);
+void bench_oled(bench_t *b);
+
+#endif // BENCH_H
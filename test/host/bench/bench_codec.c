@@ -0,0 +1,61 @@
+/**
+ * Track codec benchmarks over the recorded drive
+ *
+ * Encodes the drive in TRACKLOG_DRAIN_BATCH batches, as the drain task
+ * does, and reports the wire size against the flash record and JSON.
+ * Syquens B.V. - 2026
+ */
+
+#include "config.h"
+#include "track_codec.h"
+#include "drive.h"
+#include "bench.h"
+
+#define JSON_POINT_BYTES 90     // One fix as the old JSON track message
+
+typedef struct {
+    uint8_t data[OUTBOX_SLOT_SIZE];
+    size_t len;
+} batch_t;
+
+static batch_t *s_batches;
+static int s_batch_count;
+static volatile int s_sink;
+
+static void run_encode(void *arg) {
+    for (int i = 0; i < s_batch_count; i++) {
+        batch_t *bt = &s_batches[i];
+        bt->len = track_codec_encode(&drive_recs[i * TRACKLOG_DRAIN_BATCH], TRACKLOG_DRAIN_BATCH,
+                                     bt->data, sizeof(bt->data));
+    }
+}
+
+static void run_decode(void *arg) {
+    track_record_t out[TRACKLOG_DRAIN_BATCH];
+    int total = 0;
+    for (int i = 0; i < s_batch_count; i++) {
+        total += track_codec_decode(s_batches[i].data, s_batches[i].len, out, TRACKLOG_DRAIN_BATCH);
+    }
+    s_sink = total;
+}
+
+void bench_codec(bench_t *b) {
+    int count = drive_load();
+    s_batch_count = count / TRACKLOG_DRAIN_BATCH;
+    s_batches = calloc(s_batch_count, sizeof(*s_batches));
+    int points = s_batch_count * TRACKLOG_DRAIN_BATCH;
+
+    run_encode(NULL);
+    size_t wire = 0;
+    for (int i = 0; i < s_batch_count; i++) {
+        wire += s_batches[i].len;
+    }
+
+    bench_measure(b, "codec_encode", run_encode, NULL, points, points * sizeof(track_record_t));
+    bench_measure(b, "codec_decode", run_decode, NULL, points, wire);
+    bench_note(b, "codec_size", "%.1f B/point in batches of %d: %.1fx smaller than flash, %.1fx than JSON",
+               (double)wire / points, TRACKLOG_DRAIN_BATCH,
+               (double)points * sizeof(track_record_t) / wire,
+               (double)points * JSON_POINT_BYTES / wire);
+    free(s_batches);
+}
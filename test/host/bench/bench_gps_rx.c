@@ -0,0 +1,60 @@
+/**
+ * UART ingestion: the recorded drive replayed through the fake IDF UART
+ * driver into gps_rx, on a simulated clock
+ *
+ *   replay_*      sentences/s the GPS task can split out of the driver's
+ *                 ring (driver model included), per task wake-up interval
+ *   lost_*        lines delivered and lost when the task wakes late or
+ *                 stalls; the simulated clock makes these exact
+ * Syquens B.V. - 2026
+ */
+
+#include "gps_rx.h"
+#include "uart_replay.h"
+#include "testdata.h"
+#include "bench.h"
+
+static char *s_log;
+static size_t s_log_len;
+static size_t s_line_count;
+static gps_rx_t s_rx;
+static uint32_t s_delivered;
+
+static void on_line(const char *line, size_t len) {
+    s_delivered++;
+}
+
+static void run_replay(void *arg) {
+    s_delivered = 0;
+    uart_replay(&s_rx, arg, (const uint8_t *)s_log, s_log_len, on_line, NULL);
+}
+
+static void note_losses(bench_t *b, const char *stage, const replay_cfg_t *cfg) {
+    run_replay((void *)cfg);
+    fake_uart_driver_stats_t st;
+    fake_uart_driver_get_stats(REPLAY_PORT, &st);
+    // Overflows whose event was lost too are invisible to gps_rx.dropped
+    bench_note(b, stage, "%u of %zu lines, %zu lost (%u counted), %u bytes and %u events lost",
+               s_delivered, s_line_count, s_line_count - s_delivered, s_rx.dropped,
+               st.lost_bytes, st.events_lost);
+}
+
+void bench_gps_rx(bench_t *b) {
+    s_log = test_read_file("nmea_drive.log", &s_log_len);
+    test_line_t *lines = test_split_lines(s_log, s_log_len, &s_line_count);
+
+    replay_cfg_t every_burst = { .baud = 115200 };
+    replay_cfg_t wake_10ms = { .baud = 115200, .service_ms = 10 };
+    replay_cfg_t wake_100ms = { .baud = 115200, .service_ms = 100 };
+    replay_cfg_t stalls = { .baud = 115200, .service_ms = 10, .stall_every_ms = 5000, .stall_ms = 250 };
+
+    bench_measure(b, "replay_every_burst", run_replay, &every_burst, s_line_count, s_log_len);
+    bench_measure(b, "replay_wake_10ms", run_replay, &wake_10ms, s_line_count, s_log_len);
+    bench_measure(b, "replay_wake_100ms", run_replay, &wake_100ms, s_line_count, s_log_len);
+
+    note_losses(b, "lost_wake_100ms", &wake_100ms);
+    note_losses(b, "lost_stall_250ms_5s", &stalls);
+
+    free(lines);
+    free(s_log);
+}
@@ -0,0 +1,32 @@
+/**
+ * HAL benchmarks: driver calls through the I2C seam into the device models
+ *
+ * Measures the driver side of a transaction (register formatting, BCD)
+ * with a zero-cost bus, i.e. the floor under the real I2C transfer time.
+ * Syquens B.V. - 2026
+ */
+
+#include "ds3231.h"
+#include "fakes.h"
+#include "bench.h"
+
+static void rtc_get(void *arg) {
+    ds3231_time_t *t = arg;
+    ds3231_get_time(t);
+}
+
+static void rtc_set(void *arg) {
+    ds3231_set_time(arg);
+}
+
+void bench_hal(bench_t *b) {
+    static fake_ds3231_t rtc;
+    static hal_i2c_dev_t dev;
+    fake_ds3231_init(&rtc, &dev);
+    ds3231_init(&dev);
+
+    ds3231_time_t t = { 2026, 10, 16, 12, 34, 56 };
+    bench_measure(b, "ds3231_set_time", rtc_set, &t, 1, 0);
+    bench_measure(b, "ds3231_get_time", rtc_get, &t, 1, 0);
+    bench_note(b, "ds3231 bus", "%u transactions", rtc.transactions);
+}
@@ -0,0 +1,45 @@
+/**
+ * Position filter benchmark: the recorded drive through kf_update, with
+ * the RMS error of the raw fixes and of the estimate against the truth
+ * Syquens B.V. - 2026
+ */
+
+#include "kalman.h"
+#include "drive.h"
+#include "bench.h"
+
+static drive_truth_t *s_truth;
+static double s_raw_sq, s_est_sq;
+
+static void run_replay(void *arg) {
+    bool score = arg != NULL;
+    kf_context_t kf;
+    kf_init(&kf);
+    s_raw_sq = s_est_sq = 0;
+
+    for (int i = 0; i < drive_count; i++) {
+        const track_record_t *r = &drive_recs[i];
+        int64_t now_us = (int64_t)(r->time - drive_recs[0].time) * 1000000 + r->millis * 1000;
+        kf_update(&kf, now_us, r->lat_e7, r->lon_e7, r->hdop_c / 100.0f,
+                  r->speed_ckn / 100.0f * 0.514444f, drive_course[i] >= 0 ? drive_course[i] : 0);
+        kf_output_t est;
+        kf_get_output(&kf, &est);
+        if (score) {
+            double raw = drive_error_m(r->lat_e7, r->lon_e7, &s_truth[i]);
+            double filtered = drive_error_m(est.lat_e7, est.lon_e7, &s_truth[i]);
+            s_raw_sq += raw * raw;
+            s_est_sq += filtered * filtered;
+        }
+    }
+}
+
+void bench_kalman(bench_t *b) {
+    int n = drive_load(), n_truth;
+    s_truth = drive_truth_load(&n_truth);
+
+    bench_measure(b, "kalman_update", run_replay, NULL, n, 0);
+    run_replay(s_truth);
+    bench_note(b, "kalman_rms", "raw %.2f m, filtered %.2f m over %d epochs",
+               sqrt(s_raw_sq / n), sqrt(s_est_sq / n), n);
+    free(s_truth);
+}
@@ -0,0 +1,84 @@
+/**
+ * NMEA benchmarks over the recorded drive (data/nmea_drive.log)
+ *
+ *   nmea_tokenize   field split plus checksum, no dispatch
+ *   nmea_dispatch   tokenize, checksum/talker check and table lookup
+ *   nmea_decode     dispatch with RMC/GGA handlers converting every field
+ * Syquens B.V. - 2026
+ */
+
+#include "nmea.h"
+#include "testdata.h"
+#include "bench.h"
+
+static test_line_t *s_lines;
+static size_t s_count;
+static volatile int32_t s_sink;
+
+static void run_tokenize(void *arg) {
+    nmea_sentence_t s;
+    int ok = 0;
+    for (size_t i = 0; i < s_count; i++) {
+        ok += nmea_tokenize(s_lines[i].ptr, s_lines[i].len, &s) && s.checksum_ok;
+    }
+    s_sink = ok;
+}
+
+static void on_rmc(const nmea_sentence_t *s) {
+    int h, m, sec, ms, day, month, year;
+    int32_t lat, lon, speed, course = 0;
+    nmea_parse_time(&s->fields[1], &h, &m, &sec, &ms);
+    nmea_parse_coord(&s->fields[3], &s->fields[4], &lat);
+    nmea_parse_coord(&s->fields[5], &s->fields[6], &lon);
+    nmea_parse_fixed(&s->fields[7], 3, &speed);
+    nmea_parse_fixed(&s->fields[8], 2, &course);
+    nmea_parse_date(&s->fields[9], &day, &month, &year);
+    s_sink = lat ^ lon ^ speed ^ course ^ sec ^ day;
+}
+
+static void on_gga(const nmea_sentence_t *s) {
+    uint32_t fix, sats;
+    int32_t lat, lon, hdop, alt;
+    nmea_parse_coord(&s->fields[2], &s->fields[3], &lat);
+    nmea_parse_coord(&s->fields[4], &s->fields[5], &lon);
+    nmea_parse_uint(&s->fields[6], &fix);
+    nmea_parse_uint(&s->fields[7], &sats);
+    nmea_parse_fixed(&s->fields[8], 2, &hdop);
+    nmea_parse_fixed(&s->fields[9], 1, &alt);
+    s_sink = lat ^ lon ^ hdop ^ alt ^ (int32_t)(fix + sats);
+}
+
+static void on_other(const nmea_sentence_t *s) {
+}
+
+static const nmea_handler_t s_lookup_table[] = {
+    { NMEA_TYPE('R', 'M', 'C'), on_other },
+    { NMEA_TYPE('G', 'G', 'A'), on_other },
+};
+
+static const nmea_handler_t s_decode_table[] = {
+    { NMEA_TYPE('R', 'M', 'C'), on_rmc },
+    { NMEA_TYPE('G', 'G', 'A'), on_gga },
+};
+
+static void run_dispatch(void *arg) {
+    const nmea_handler_t *table = arg;
+    nmea_stats_t stats = {0};
+    for (size_t i = 0; i < s_count; i++) {
+        nmea_dispatch(s_lines[i].ptr, s_lines[i].len, table, 2, &stats);
+    }
+    s_sink = stats.accepted;
+}
+
+void bench_nmea(bench_t *b) {
+    size_t len;
+    char *buf = test_read_file("nmea_drive.log", &len);
+    s_lines = test_split_lines(buf, len, &s_count);
+
+    bench_measure(b, "nmea_tokenize", run_tokenize, NULL, s_count, len);
+    bench_measure(b, "nmea_dispatch", run_dispatch, (void *)s_lookup_table, s_count, len);
+    bench_measure(b, "nmea_decode", run_dispatch, (void *)s_decode_table, s_count, len);
+
+    free(s_lines);
+    free(buf);
+}
@@ -0,0 +1,105 @@
+/**
+ * NTP server load generator: the firmware's server task on loopback
+ *
+ *   request_rtt     one request, wait for the reply; the latency columns
+ *                   are the client-observed round trip
+ *   load_*_per_s    open loop: requests paced at a fixed rate from one
+ *                   socket, replies matched by the echoed origin stamp.
+ *                   Reports latency percentiles, jitter (mean change in
+ *                   latency between consecutive replies, as in RFC 3550),
+ *                   server hold time (transmit - receive) and losses.
+ * Syquens B.V. - 2026
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ntp_server.h"
+#include "ntp_client.h"
+#include "bench.h"
+
+static int s_sock;
+
+static void run_rtt(void *arg) {
+    ntp_reply_t r;
+    ntp_client_send(s_sock, 4, 6, bench_now_ns());
+    ntp_client_recv(s_sock, &r);
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void drain(uint32_t *lat_ns, uint32_t *hold_ns, uint32_t *got) {
+    ntp_reply_t r;
+    uint8_t pkt[NTP_CLIENT_PACKET_SIZE];
+    while (recv(s_sock, pkt, sizeof(pkt), MSG_DONTWAIT | MSG_PEEK) == sizeof(pkt) &&
+           ntp_client_recv(s_sock, &r)) {
+        uint64_t now = bench_now_ns();
+        lat_ns[*got] = (uint32_t)(now - r.origin);
+        hold_ns[*got] = (uint32_t)((ntp_client_ts_us(r.transmit) - ntp_client_ts_us(r.receive)) * 1000);
+        (*got)++;
+    }
+}
+
+static void run_load(bench_t *b, const char *stage, uint32_t rate, uint32_t seconds_x10) {
+    uint32_t count = rate * seconds_x10 / 10;
+    uint32_t *lat_ns = calloc(count, sizeof(uint32_t));
+    uint32_t *hold_ns = calloc(count, sizeof(uint32_t));
+    uint32_t got = 0;
+    uint64_t period_ns = 1000000000ULL / rate;
+    uint64_t start = bench_now_ns();
+
+    for (uint32_t sent = 0; sent < count; sent++) {
+        uint64_t due = start + sent * period_ns;
+        while (bench_now_ns() < due) {
+            drain(lat_ns, hold_ns, &got);
+        }
+        ntp_client_send(s_sock, 4, 6, bench_now_ns());
+    }
+    // Stragglers get 100 ms
+    uint64_t deadline = bench_now_ns() + 100000000ULL;
+    while (got < count && bench_now_ns() < deadline) {
+        drain(lat_ns, hold_ns, &got);
+    }
+
+    double jitter_ns = 0;
+    for (uint32_t i = 1; i < got; i++) {
+        jitter_ns += fabs((double)lat_ns[i] - (double)lat_ns[i - 1]);
+    }
+    jitter_ns = got > 1 ? jitter_ns / (got - 1) : 0;
+
+    if (got > 0) {
+        qsort(lat_ns, got, sizeof(uint32_t), cmp_u32);
+        qsort(hold_ns, got, sizeof(uint32_t), cmp_u32);
+        bench_note(b, stage, "%u/%u answered, latency p50 %.1f us p99 %.1f us max %.1f us, "
+                   "jitter %.1f us, hold p99 %.1f us",
+                   got, count, lat_ns[got / 2] / 1e3, lat_ns[got * 99 / 100] / 1e3, lat_ns[got - 1] / 1e3,
+                   jitter_ns / 1e3, hold_ns[got * 99 / 100] / 1e3);
+    } else {
+        bench_note(b, stage, "0/%u answered", count);
+    }
+    free(lat_ns);
+    free(hold_ns);
+}
+
+void bench_ntp(bench_t *b) {
+    if (ntp_server_start() != ESP_OK) {
+        bench_note(b, "start", "cannot bind UDP %d", NTP_SERVER_PORT);
+        return;
+    }
+    struct timeval ref;
+    gettimeofday(&ref, NULL);
+    ntp_server_set_reference(NTP_STRATUM_GPS, NTP_REFID('P', 'P', 'S', 0), &ref, 1000);
+    s_sock = ntp_client_open(100);
+
+    bench_measure(b, "request_rtt", run_rtt, NULL, 1, NTP_CLIENT_PACKET_SIZE);
+
+    // The fleet polls at most a few hundred times per second
+    uint32_t tenths = b->quick ? 1 : 20;
+    run_load(b, "load_200_per_s", 200, tenths);
+    run_load(b, "load_1000_per_s", 1000, tenths);
+    run_load(b, "load_5000_per_s", 5000, tenths);
+    close(s_sock);
+}
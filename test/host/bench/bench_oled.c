@@ -0,0 +1,134 @@
+/**
+ * OLED frame render: the display_task frame drawn two ways
+ *
+ *   frame_reference   the original renderer, kept here for comparison:
+ *                     oled_set_pixel per glyph pixel with bounds checks
+ *                     and read-modify-write, and both scrolling lines
+ *                     redrawn character by character every frame
+ *   frame_blit        oled.c: whole glyph columns ORed into the page(s),
+ *                     glyphs clipped up front, tickers copied out of a
+ *                     pre-rendered strip
+ *   *_unaligned       status lines at y = 2 and 9 (two-page shifts)
+ * Render only; oled_update and the bus are not included.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "oled.h"
+#include "bench.h"
+
+#define REF_PAGES   (DISPLAY_HEIGHT / 8)
+
+static const char *s_line4 = "52.090737 5.121420 12:34:56 SAT:9  ";
+static const char *s_line5 = "Oudegracht Utrecht Nederland  ";
+
+static oled_ticker_t s_ticker4, s_ticker5;
+static int s_scroll;
+static const int *s_rows;          // y of the three status lines
+
+static const int s_rows_aligned[3] = { 0, 8, 16 };
+static const int s_rows_unaligned[3] = { 2, 9, 16 };  // Adjacent, not overlapping
+
+// ---- Reference per-pixel renderer --------------------------------------
+
+static uint8_t s_ref_buffer[DISPLAY_WIDTH * REF_PAGES];
+static uint8_t s_ref_font[64][5];   // Same glyphs, read back from oled.c
+
+static void ref_set_pixel(int x, int y, bool on) {
+    if (x < 0 || x >= DISPLAY_WIDTH || y < 0 || y >= DISPLAY_HEIGHT) return;
+    if (on) {
+        s_ref_buffer[x + (y / 8) * DISPLAY_WIDTH] |= (1 << (y % 8));
+    } else {
+        s_ref_buffer[x + (y / 8) * DISPLAY_WIDTH] &= ~(1 << (y % 8));
+    }
+}
+
+static void ref_draw_char(int x, int y, char c) {
+    if (c < 32 || c > 95) c = 32;
+    const uint8_t *glyph = s_ref_font[c - 32];
+    for (int i = 0; i < 5; i++) {
+        uint8_t line = glyph[i];
+        for (int j = 0; j < 7; j++) {
+            ref_set_pixel(x + i, y + j, line & (1 << j));
+        }
+    }
+}
+
+static void ref_draw_string(int x, int y, const char *str) {
+    for (; *str; str++, x += 6) {
+        ref_draw_char(x, y, *str);
+    }
+}
+
+// Scrolling line: every character drawn at its scrolled x, wrapping once
+static void ref_draw_scrolling(int y, const char *str, int pos) {
+    int width = (int)strlen(str) * 6;
+    ref_draw_string(-pos, y, str);
+    if (width - pos < DISPLAY_WIDTH) ref_draw_string(width - pos, y, str);
+}
+
+static void ref_frame(void *arg) {
+    memset(s_ref_buffer, 0, sizeof(s_ref_buffer));
+    ref_draw_string(0, s_rows[0], "GPS FIX OK");
+    ref_draw_string(0, s_rows[1], "RTC SYNC");
+    ref_draw_string(0, s_rows[2], "WIFI");
+    ref_draw_string(30, s_rows[2], "---");
+    ref_draw_string(48, s_rows[2], "NTP");
+    ref_draw_scrolling(24, s_line4, s_scroll % ((int)strlen(s_line4) * 6));
+    ref_draw_scrolling(32, s_line5, s_scroll % ((int)strlen(s_line5) * 6));
+    s_scroll += 2;
+}
+
+// ---- Current renderer ---------------------------------------------------
+
+static void blit_frame(void *arg) {
+    oled_clear();
+    oled_draw_string(0, s_rows[0], "GPS FIX OK");
+    oled_draw_string(0, s_rows[1], "RTC SYNC");
+    oled_draw_string(0, s_rows[2], "WIFI");
+    oled_draw_string(30, s_rows[2], "---");
+    oled_draw_string(48, s_rows[2], "NTP");
+    oled_ticker_render(&s_ticker4, 3);
+    oled_ticker_render(&s_ticker5, 4);
+}
+
+static void load_font(void) {
+    for (int c = 0; c < 64; c++) {
+        oled_clear();
+        oled_draw_char(0, 0, (char)(32 + c));
+        memcpy(s_ref_font[c], oled_framebuffer(), 5);
+    }
+}
+
+static void setup(const int *rows) {
+    s_rows = rows;
+    s_scroll = 0;
+    memset(&s_ticker4, 0, sizeof(s_ticker4));
+    memset(&s_ticker5, 0, sizeof(s_ticker5));
+    oled_ticker_set_text(&s_ticker4, s_line4);
+    oled_ticker_set_text(&s_ticker5, s_line5);
+}
+
+// Both renderers must produce the same frame (scroll positions aligned)
+static bool frames_match(void) {
+    setup(s_rows);
+    ref_frame(NULL);
+    blit_frame(NULL);
+    return memcmp(s_ref_buffer, oled_framebuffer(), sizeof(s_ref_buffer)) == 0;
+}
+
+void bench_oled(bench_t *b) {
+    load_font();
+
+    setup(s_rows_aligned);
+    bench_measure(b, "frame_reference", ref_frame, NULL, 1, 0);
+    setup(s_rows_aligned);
+    bench_measure(b, "frame_blit", blit_frame, NULL, 1, 0);
+    bench_note(b, "frame_match", "%s", frames_match() ? "identical" : "DIFFERENT");
+
+    setup(s_rows_unaligned);
+    bench_measure(b, "frame_reference_unaligned", ref_frame, NULL, 1, 0);
+    setup(s_rows_unaligned);
+    bench_measure(b, "frame_blit_unaligned", blit_frame, NULL, 1, 0);
+    bench_note(b, "frame_match_unaligned", "%s", frames_match() ? "identical" : "DIFFERENT");
+}
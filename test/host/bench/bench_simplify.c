@@ -0,0 +1,46 @@
+/**
+ * Track simplifier benchmarks over the recorded drive
+ *
+ * Compression against the Douglas-Peucker tolerance, with the deviation
+ * actually measured on the output, and the cost per input point.
+ * Syquens B.V. - 2026
+ */
+
+#include "track_simplify.h"
+#include "drive.h"
+#include "bench.h"
+
+static track_record_t s_out[1024];
+static ts_context_t s_ts;
+static int s_out_count;
+
+static void run_simplify(void *arg) {
+    const ts_config_t *cfg = arg;
+    ts_init(&s_ts, cfg);
+    int n = 0;
+    for (int i = 0; i < drive_count; i++) {
+        n += ts_push(&s_ts, &drive_recs[i], &s_out[n]);
+    }
+    n += ts_flush(&s_ts, &s_out[n]);
+    s_out_count = n;
+}
+
+void bench_simplify(bench_t *b) {
+    int n = drive_load();
+    const float tolerances[] = { 0.5f, 1, 2, 5, 10, 20, 50 };
+
+    for (size_t t = 0; t < sizeof(tolerances) / sizeof(tolerances[0]); t++) {
+        ts_config_t cfg = { .max_deviation_m = tolerances[t], .window = TS_WINDOW_MAX };
+        run_simplify(&cfg);
+        char stage[32];
+        snprintf(stage, sizeof(stage), "simplify_tol_%gm", tolerances[t]);
+        bench_note(b, stage, "%4d of %d points, ratio %5.1f:1, max deviation %.2f m",
+                   s_out_count, n, (double)n / s_out_count,
+                   drive_max_deviation(drive_recs, n, s_out, s_out_count));
+    }
+
+    ts_config_t cfg = { .max_deviation_m = 5, .window = TS_WINDOW_MAX };
+    bench_measure(b, "simplify_window_64", run_simplify, &cfg, n, 0);
+    cfg.window = 16;
+    bench_measure(b, "simplify_window_16", run_simplify, &cfg, n, 0);
+}
@@ -0,0 +1,100 @@
+/**
+ * NAV-PVT vs NMEA: cost of one navigation epoch through each path
+ *
+ *   epoch_nmea_rmc_gga  the two sentences left on after configuration,
+ *                       tokenized, checked and converted field by field
+ *   epoch_ubx_nav_pvt   one binary frame: checksum, copy, integer fields
+ * Syquens B.V. - 2026
+ */
+
+#include "nmea.h"
+#include "ubx.h"
+#include "testdata.h"
+#include "bench.h"
+
+static test_line_t *s_lines;        // RMC and GGA lines only
+static size_t s_line_count;
+static size_t s_nmea_bytes;
+static uint8_t *s_ubx;
+static size_t s_ubx_len;
+static int s_epochs;
+static volatile int32_t s_sink;
+
+static void on_rmc(const nmea_sentence_t *s) {
+    int h, m, sec, ms, day, month, year;
+    int32_t lat, lon, speed, course = 0;
+    nmea_parse_time(&s->fields[1], &h, &m, &sec, &ms);
+    nmea_parse_coord(&s->fields[3], &s->fields[4], &lat);
+    nmea_parse_coord(&s->fields[5], &s->fields[6], &lon);
+    nmea_parse_fixed(&s->fields[7], 3, &speed);
+    nmea_parse_fixed(&s->fields[8], 2, &course);
+    nmea_parse_date(&s->fields[9], &day, &month, &year);
+    s_sink = lat ^ lon ^ speed ^ course ^ sec ^ day;
+}
+
+static void on_gga(const nmea_sentence_t *s) {
+    uint32_t fix, sats;
+    int32_t hdop, alt;
+    nmea_parse_uint(&s->fields[6], &fix);
+    nmea_parse_uint(&s->fields[7], &sats);
+    nmea_parse_fixed(&s->fields[8], 2, &hdop);
+    nmea_parse_fixed(&s->fields[9], 1, &alt);
+    s_sink = hdop ^ alt ^ (int32_t)(fix + sats);
+}
+
+static const nmea_handler_t s_table[] = {
+    { NMEA_TYPE('R', 'M', 'C'), on_rmc },
+    { NMEA_TYPE('G', 'G', 'A'), on_gga },
+};
+
+static void run_nmea(void *arg) {
+    for (size_t i = 0; i < s_line_count; i++) {
+        nmea_dispatch(s_lines[i].ptr, s_lines[i].len, s_table, 2, NULL);
+    }
+}
+
+static void run_ubx(void *arg) {
+    ubx_parser_t p;
+    ubx_parser_reset(&p);
+    const uint8_t *d = s_ubx;
+    size_t left = s_ubx_len;
+    while (left > 0) {
+        bool frame;
+        size_t used = ubx_parse(&p, d, left, &frame);
+        d += used;
+        left -= used;
+        ubx_nav_pvt_t pvt;
+        if (frame && ubx_decode_nav_pvt(&p, &pvt)) {
+            // The same conversions parse_ubx_nav_pvt makes
+            float speed_knots = pvt.g_speed / 514.444f;
+            float course = pvt.head_mot / 1e5f;
+            float hdop = pvt.p_dop / 100.0f;
+            s_sink = pvt.lat ^ pvt.lon ^ (int32_t)(speed_knots + course + hdop) ^ pvt.sec;
+        }
+    }
+}
+
+void bench_ubx(bench_t *b) {
+    size_t len, count;
+    char *log = test_read_file("nmea_drive.log", &len);
+    test_line_t *all = test_split_lines(log, len, &count);
+    s_lines = malloc(count * sizeof(*s_lines));
+    for (size_t i = 0; i < count; i++) {
+        if (all[i].len > 6 && (memcmp(all[i].ptr + 3, "RMC", 3) == 0 || memcmp(all[i].ptr + 3, "GGA", 3) == 0)) {
+            s_lines[s_line_count++] = all[i];
+            s_nmea_bytes += all[i].len;
+        }
+    }
+    s_epochs = s_line_count / 2;
+    s_ubx = (uint8_t *)test_read_file("nav_pvt_drive.ubx", &s_ubx_len);
+
+    bench_measure(b, "epoch_nmea_rmc_gga", run_nmea, NULL, s_epochs, s_nmea_bytes);
+    bench_measure(b, "epoch_ubx_nav_pvt", run_ubx, NULL, s_epochs, s_ubx_len);
+    bench_note(b, "epoch_bytes", "NMEA RMC+GGA %.0f B, NAV-PVT %.0f B per epoch",
+               (double)s_nmea_bytes / s_epochs, (double)s_ubx_len / s_epochs);
+
+    free(s_ubx);
+    free(s_lines);
+    free(all);
+    free(log);
+}
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Synthesized GNSS drive for the host tests and benchmarks
+
+Writes the sentence mix a u-blox M8 emits at 1 Hz (RMC, VTG, GGA, GSA,
+GSV, GLL) along a deterministic route, with position noise on top of the
+true track. The output is committed; rerun only to change the scenario:
+
+    python3 gen_nmea.py            # writes nmea_drive.log, nmea_drive_truth.csv
+                                   # and nav_pvt_drive.ubx
+
+The truth file holds the noise-free position, speed and course of every
+epoch, for scoring the position filter. The .ubx file carries the same
+epochs as UBX NAV-PVT frames (what the receiver sends once NAV-PVT is
+enabled), with a boot banner and a stray NMEA line mixed in as on the
+real link.
+
+Syquens B.V. - 2026
+"""
+
+import math
+import random
+import struct
+
+START_LAT = 52.0907
+START_LON = 5.1214
+EPOCHS = 600
+SEED = 2026
+
+EARTH_R = 6371000.0
+
+
+def checksum(body):
+    c = 0
+    for ch in body.encode():
+        c ^= ch
+    return "%02X" % c
+
+
+def sentence(body):
+    return "$%s*%s\r\n" % (body, checksum(body))
+
+
+def ubx_frame(cls, msg_id, payload):
+    body = struct.pack("<BBH", cls, msg_id, len(payload)) + payload
+    ck_a = ck_b = 0
+    for b in body:
+        ck_a = (ck_a + b) & 0xFF
+        ck_b = (ck_b + ck_a) & 0xFF
+    return b"\xb5\x62" + body + bytes([ck_a, ck_b])
+
+
+def nav_pvt(t, lat, lon, alt, speed, course, sats):
+    """NAV-PVT payload (92 bytes) for 2026-01-16 10:15:00 + t UTC"""
+    hh, rem = divmod(10 * 3600 + 15 * 60 + t, 3600)
+    mm, ss = divmod(rem, 60)
+    itow = (5 * 86400 + 10 * 3600 + 15 * 60 + t + 18) * 1000   # Friday, GPS - UTC = 18 s
+    vel_n = speed * math.cos(math.radians(course))
+    vel_e = speed * math.sin(math.radians(course))
+    return struct.pack("<IHBBBBBBIiBBBBiiiiIIiiiiiIIH6sihH",
+                       itow, 2026, 1, 16, hh, mm, ss, 0x07, 25, -3210,
+                       3, 0x01, 0xEA, sats,
+                       round(lon * 1e7), round(lat * 1e7),
+                       round((alt + 46.4) * 1000), round(alt * 1000), 2100, 3400,
+                       round(vel_n * 1000), round(vel_e * 1000), 40,
+                       round(speed * 1000), round(course * 1e5) if speed > 0.5 else 0,
+                       310, 1280000, 171, bytes(6), 0, 0, 0)
+
+
+def ddmm(value, lat):
+    hemi = ("N" if value >= 0 else "S") if lat else ("E" if value >= 0 else "W")
+    value = abs(value)
+    deg = int(value)
+    minutes = (value - deg) * 60
+    if lat:
+        return "%02d%08.5f" % (deg, minutes), hemi
+    return "%03d%08.5f" % (deg, minutes), hemi
+
+
+def route():
+    """True position, speed (m/s) and course per second"""
+    rng = random.Random(SEED)
+    lat, lon = START_LAT, START_LON
+    course, speed = 45.0, 0.0
+    for t in range(EPOCHS):
+        # Stop at the start, accelerate, cruise with bends, brake at the end
+        if t < 20:
+            target = 0.0
+        elif t < EPOCHS - 40:
+            target = 13.9 if (t // 120) % 2 == 0 else 22.2
+        else:
+            target = 0.0
+        speed += max(-2.5, min(1.5, target - speed))
+        if 20 < t < EPOCHS - 40 and (t // 45) % 3 == 1:
+            course = (course + rng.uniform(1.0, 3.0)) % 360
+        yield t, lat, lon, speed, course
+        d = speed / EARTH_R
+        lat += math.degrees(d * math.cos(math.radians(course)))
+        lon += math.degrees(d * math.sin(math.radians(course)) / math.cos(math.radians(lat)))
+
+
+def main():
+    rng = random.Random(SEED + 1)
+    bias_n = bias_e = 0.0
+    lines = []
+    truth = ["t,lat,lon,speed_mps,course_deg\n"]
+    ubx = [b"$GNTXT,01,01,02,u-blox AG - www.u-blox.com*4E\r\n"]
+    for t, lat, lon, speed, course in route():
+        truth.append("%d,%.9f,%.9f,%.3f,%.2f\n" % (t, lat, lon, speed, course))
+        # Correlated error like a real receiver: slow bias plus white noise
+        bias_n = 0.98 * bias_n + rng.gauss(0, 0.3)
+        bias_e = 0.98 * bias_e + rng.gauss(0, 0.3)
+        n = bias_n + rng.gauss(0, 1.2)
+        e = bias_e + rng.gauss(0, 1.2)
+        mlat = lat + math.degrees(n / EARTH_R)
+        mlon = lon + math.degrees(e / (EARTH_R * math.cos(math.radians(lat))))
+        alt = 4.2 + rng.gauss(0, 0.8)
+
+        hh, rem = divmod(10 * 3600 + 15 * 60 + t, 3600)
+        mm, ss = divmod(rem, 60)
+        utc = "%02d%02d%02d.00" % (hh, mm, ss)
+        la, ns = ddmm(mlat, True)
+        lo, ew = ddmm(mlon, False)
+        knots = speed * 1.943844 + abs(rng.gauss(0, 0.05))
+        cog = ("%.2f" % course) if speed > 0.5 else ""
+        sats = 9 + (t // 97) % 4
+
+        lines.append(sentence("GNRMC,%s,A,%s,%s,%s,%s,%.3f,%s,160126,,,A" % (utc, la, ns, lo, ew, knots, cog)))
+        lines.append(sentence("GNVTG,%s,T,,M,%.3f,N,%.3f,K,A" % (cog, knots, knots * 1.852)))
+        lines.append(sentence("GNGGA,%s,%s,%s,%s,%s,1,%02d,0.92,%.1f,M,46.4,M,," % (utc, la, ns, lo, ew, sats, alt)))
+        prns = ",".join("%02d" % p for p in [2, 5, 12, 13, 15, 18, 20, 24, 25, 29, 31, 32][:sats]) + "," * (12 - sats)
+        lines.append(sentence("GNGSA,A,3,%s,1.71,0.92,1.44" % prns))
+        views = [(2, 66, 281, 41), (5, 21, 145, 33), (12, 71, 90, 44), (13, 29, 218, 36),
+                 (15, 33, 301, 38), (18, 8, 40, 22), (20, 18, 180, 29), (24, 40, 63, 40),
+                 (25, 55, 120, 43), (29, 12, 327, 25), (31, 10, 250, 21)]
+        for i in range(0, len(views), 4):
+            chunk = views[i:i + 4]
+            fields = ",".join("%02d,%02d,%03d,%02d" % (p, el, az, max(0, snr + rng.randint(-2, 2)))
+                              for p, el, az, snr in chunk)
+            lines.append(sentence("GPGSV,3,%d,11,%s" % (i // 4 + 1, fields)))
+        lines.append(sentence("GNGLL,%s,%s,%s,%s,%s,A,A" % (la, ns, lo, ew, utc)))
+
+        ubx.append(ubx_frame(0x01, 0x07, nav_pvt(t, mlat, mlon, alt, speed, course, sats)))
+        if t == EPOCHS // 2:
+            ubx.append(b"$GNTXT,01,01,01,ANTSTATUS=OK*26\r\n")
+
+    with open("nmea_drive.log", "w", newline="") as f:
+        f.writelines(lines)
+    with open("nmea_drive_truth.csv", "w", newline="") as f:
+        f.writelines(truth)
+    with open("nav_pvt_drive.ubx", "wb") as f:
+        f.writelines(ubx)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,146 @@
+/**
+ * Recorded drive as track records, for the codec and simplifier tests
+ *
+ * Decodes data/nmea_drive.log with the firmware tokenizer: RMC gives
+ * time, position, speed and course; the GGA of the same epoch adds
+ * altitude, HDOP and satellites. data/nmea_drive_truth.csv holds the
+ * noise-free track the log was generated from, one row per epoch.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef DRIVE_H
+#define DRIVE_H
+
+#include <math.h>
+#include "nmea.h"
+#include "tracklog.h"
+#include "testdata.h"
+
+static track_record_t *drive_recs;
+static float *drive_course;     // Degrees, -1 when RMC left it empty
+static int drive_count;
+
+typedef struct {
+    double lat, lon;            // Degrees
+    double speed_mps;
+    double course_deg;
+} drive_truth_t;
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+static inline int64_t drive_days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static inline void drive_on_rmc(const nmea_sentence_t *s) {
+    int h, m, sec, ms, day, month, year;
+    int32_t lat = 0, lon = 0, speed_mkn = 0;
+    if (nmea_field_char(&s->fields[2]) != 'A') return;
+    if (!nmea_parse_time(&s->fields[1], &h, &m, &sec, &ms) ||
+        !nmea_parse_date(&s->fields[9], &day, &month, &year)) return;
+
+    track_record_t *r = &drive_recs[drive_count++];
+    memset(r, 0, sizeof(*r));
+    r->time = (uint32_t)(drive_days_from_civil(year, month, day) * 86400 + h * 3600 + m * 60 + sec);
+    r->millis = ms;
+    nmea_parse_coord(&s->fields[3], &s->fields[4], &lat);
+    nmea_parse_coord(&s->fields[5], &s->fields[6], &lon);
+    r->lat_e7 = lat;
+    r->lon_e7 = lon;
+    nmea_parse_fixed(&s->fields[7], 3, &speed_mkn);
+    int32_t course_cd;
+    drive_course[drive_count - 1] = nmea_parse_fixed(&s->fields[8], 2, &course_cd) ? course_cd / 100.0f : -1;
+    r->speed_ckn = (uint16_t)(speed_mkn / 10);
+    r->fix_type = 3;
+}
+
+static inline void drive_on_gga(const nmea_sentence_t *s) {
+    if (drive_count == 0) return;
+    track_record_t *r = &drive_recs[drive_count - 1];
+    int32_t alt_dm = 0, hdop_c = 0;
+    uint32_t sats = 0;
+    nmea_parse_fixed(&s->fields[9], 1, &alt_dm);
+    nmea_parse_fixed(&s->fields[8], 2, &hdop_c);
+    nmea_parse_uint(&s->fields[7], &sats);
+    r->alt_dm = alt_dm;
+    r->hdop_c = (uint16_t)hdop_c;
+    r->sats = (uint8_t)sats;
+}
+
+// Load the drive once; returns the record count
+static inline int drive_load(void) {
+    if (drive_recs) return drive_count;
+
+    static const nmea_handler_t table[] = {
+        { NMEA_TYPE('R', 'M', 'C'), drive_on_rmc },
+        { NMEA_TYPE('G', 'G', 'A'), drive_on_gga },
+    };
+    size_t len, count;
+    char *buf = test_read_file("nmea_drive.log", &len);
+    test_line_t *lines = test_split_lines(buf, len, &count);
+    drive_recs = calloc(count, sizeof(*drive_recs));
+    drive_course = calloc(count, sizeof(*drive_course));
+    for (size_t i = 0; i < count; i++) {
+        nmea_dispatch(lines[i].ptr, lines[i].len, table, 2, NULL);
+    }
+    free(lines);
+    free(buf);
+    return drive_count;
+}
+
+// Ground truth per epoch, index-aligned with drive_recs; returns the rows
+static inline drive_truth_t *drive_truth_load(int *count) {
+    size_t len, n;
+    char *buf = test_read_file("nmea_drive_truth.csv", &len);
+    test_line_t *lines = test_split_lines(buf, len, &n);
+    drive_truth_t *truth = calloc(n, sizeof(*truth));
+    int rows = 0;
+    for (size_t i = 1; i < n; i++) {    // Skip the header
+        int t;
+        drive_truth_t *r = &truth[rows];
+        if (sscanf(lines[i].ptr, "%d,%lf,%lf,%lf,%lf", &t, &r->lat, &r->lon, &r->speed_mps, &r->course_deg) == 5) {
+            rows++;
+        }
+    }
+    free(lines);
+    free(buf);
+    *count = rows;
+    return truth;
+}
+
+// Horizontal distance in metres between an e7 position and a truth row
+static inline double drive_error_m(int32_t lat_e7, int32_t lon_e7, const drive_truth_t *t) {
+    double dn = (lat_e7 / 1e7 - t->lat) * M_PI / 180.0 * 6371000.0;
+    double de = (lon_e7 / 1e7 - t->lon) * M_PI / 180.0 * 6371000.0 * cos(t->lat * M_PI / 180.0);
+    return hypot(dn, de);
+}
+
+// Largest distance (m) from a point of in[] to the segment of out[] that
+// spans its time. out[] must be a time-ordered subset of in[] that keeps
+// both ends. Local flat projection in double precision.
+static inline double drive_max_deviation(const track_record_t *in, int n_in,
+                                         const track_record_t *out, int n_out) {
+    const double k = 6371000.0 * M_PI / 180.0 / 1e7;
+    double cos_lat = cos(in[0].lat_e7 * M_PI / 180.0 / 1e7);
+    double worst = 0;
+    int seg = 0;
+    for (int i = 0; i < n_in; i++) {
+        while (seg + 1 < n_out - 1 && out[seg + 1].time <= in[i].time) seg++;
+        const track_record_t *a = &out[seg], *b = &out[seg + 1 < n_out ? seg + 1 : seg];
+        double ax = (a->lon_e7 - in[0].lon_e7) * k * cos_lat, ay = (a->lat_e7 - in[0].lat_e7) * k;
+        double bx = (b->lon_e7 - in[0].lon_e7) * k * cos_lat, by = (b->lat_e7 - in[0].lat_e7) * k;
+        double px = (in[i].lon_e7 - in[0].lon_e7) * k * cos_lat, py = (in[i].lat_e7 - in[0].lat_e7) * k;
+        double dx = bx - ax, dy = by - ay, len2 = dx * dx + dy * dy;
+        double t = len2 > 0 ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0;
+        t = t < 0 ? 0 : t > 1 ? 1 : t;
+        double d = hypot(ax + t * dx - px, ay + t * dy - py);
+        if (d > worst) worst = d;
+    }
+    return worst;
+}
+
+#endif // DRIVE_H
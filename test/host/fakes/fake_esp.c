@@ -0,0 +1,75 @@
+/**
+ * Fake ESP-IDF system services - error names, esp_timer clock, heap figures
+ *
+ * esp_timer_get_time() follows CLOCK_MONOTONIC until a test takes over
+ * the clock with fake_time_set(); from then on time only moves when the
+ * test advances it, which makes timeouts and rate limits deterministic.
+ * Syquens B.V. - 2026
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "fakes.h"
+
+int fake_log_enabled = 0;
+
+static bool s_time_fake = false;
+static int64_t s_time_us = 0;
+
+__attribute__((constructor)) static void fake_log_init(void) {
+    fake_log_enabled = getenv("FAKE_LOG") != NULL;
+}
+
+const char *esp_err_to_name(esp_err_t code) {
+    switch (code) {
+    case ESP_OK:                        return "ESP_OK";
+    case ESP_FAIL:                      return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:                return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:           return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:         return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:          return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:             return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:         return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:               return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:      return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC:           return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_NVS_NOT_FOUND:         return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_NOT_ENOUGH_SPACE:  return "ESP_ERR_NVS_NOT_ENOUGH_SPACE";
+    default:                            return "UNKNOWN_ERROR";
+    }
+}
+
+int64_t esp_timer_get_time(void) {
+    if (s_time_fake) return __atomic_load_n(&s_time_us, __ATOMIC_RELAXED);
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void fake_time_set(int64_t us) {
+    __atomic_store_n(&s_time_us, us, __ATOMIC_RELAXED);
+    s_time_fake = true;
+}
+
+void fake_time_advance(int64_t us) {
+    __atomic_add_fetch(&s_time_us, us, __ATOMIC_RELAXED);
+}
+
+uint32_t esp_get_free_heap_size(void) {
+    return 0;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void) {
+    return 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    (void)caps;
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * Fake flash partitions - NOR semantics over a host file
+ *
+ * Erase sets whole 4 KB sectors to 0xFF and writes can only clear bits
+ * (the stored byte is ANDed with the new one), as on the SPI flash. Every
+ * operation is written through to the backing file, so a child process
+ * killed mid-run leaves exactly the flash image a power cut would.
+ *
+ * Power-cut injection: fake_flash_cut_after(n) lets n more operations
+ * complete, performs half of the next one and then _exit()s the process.
+ * Syquens B.V. - 2026
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_partition.h"
+#include "fakes.h"
+
+#define FLASH_SECTOR_SIZE   4096
+#define FLASH_MAX_PARTS     4
+
+typedef struct {
+    esp_partition_t part;
+    uint8_t *mem;
+    int fd;
+} flash_part_t;
+
+static flash_part_t s_parts[FLASH_MAX_PARTS];
+static int s_part_count = 0;
+static long s_cut_after = -1;
+static fake_flash_stats_t s_stats;
+
+static flash_part_t *lookup(const esp_partition_t *part) {
+    for (int i = 0; i < s_part_count; i++) {
+        if (&s_parts[i].part == part) return &s_parts[i];
+    }
+    return NULL;
+}
+
+static void persist(flash_part_t *p, size_t off, size_t len) {
+    if (p->fd >= 0 && pwrite(p->fd, p->mem + off, len, (off_t)off) != (ssize_t)len) {
+        abort();
+    }
+}
+
+// Counts one operation; true if it is the one the power cut interrupts
+static bool cut_now(void) {
+    if (s_cut_after < 0) return false;
+    return s_cut_after-- == 0;
+}
+
+static void power_off(void) {
+    _exit(FAKE_FLASH_CUT_EXIT);
+}
+
+const esp_partition_t *fake_flash_add(const char *label, esp_partition_subtype_t subtype, uint32_t size,
+                                      const char *path) {
+    if (s_part_count == FLASH_MAX_PARTS) return NULL;
+    flash_part_t *p = &s_parts[s_part_count++];
+    memset(p, 0, sizeof(*p));
+    p->part.type = ESP_PARTITION_TYPE_DATA;
+    p->part.subtype = subtype;
+    p->part.size = size;
+    p->part.erase_size = FLASH_SECTOR_SIZE;
+    strncpy(p->part.label, label, sizeof(p->part.label) - 1);
+    p->mem = malloc(size);
+    memset(p->mem, 0xFF, size);
+    p->fd = -1;
+
+    if (path) {
+        p->fd = open(path, O_RDWR | O_CREAT, 0644);
+        ssize_t got = p->fd >= 0 ? pread(p->fd, p->mem, size, 0) : -1;
+        if (got < (ssize_t)size) {
+            // New image (or a short one): the rest reads as erased
+            memset(p->mem + (got > 0 ? got : 0), 0xFF, size - (got > 0 ? got : 0));
+            persist(p, 0, size);
+        }
+    }
+    return &p->part;
+}
+
+uint8_t *fake_flash_data(const esp_partition_t *part) {
+    flash_part_t *p = lookup(part);
+    return p ? p->mem : NULL;
+}
+
+void fake_flash_cut_after(long ops) {
+    s_cut_after = ops;
+}
+
+void fake_flash_get_stats(fake_flash_stats_t *out) {
+    *out = s_stats;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label) {
+    for (int i = 0; i < s_part_count; i++) {
+        const esp_partition_t *part = &s_parts[i].part;
+        if (part->type == type && part->subtype == subtype && (!label || strcmp(part->label, label) == 0)) {
+            return part;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t off, void *dst, size_t len) {
+    flash_part_t *p = lookup(part);
+    if (!p) return ESP_ERR_INVALID_ARG;
+    if (off > part->size || len > part->size - off) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, p->mem + off, len);
+    s_stats.reads++;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t off, const void *src, size_t len) {
+    flash_part_t *p = lookup(part);
+    if (!p) return ESP_ERR_INVALID_ARG;
+    if (off > part->size || len > part->size - off) return ESP_ERR_INVALID_SIZE;
+
+    bool cut = cut_now();
+    size_t n = cut ? len / 2 : len;
+    const uint8_t *b = src;
+    for (size_t i = 0; i < n; i++) {
+        p->mem[off + i] &= b[i];
+    }
+    persist(p, off, n);
+    if (cut) power_off();
+    s_stats.writes++;
+    s_stats.bytes_written += len;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t off, size_t len) {
+    flash_part_t *p = lookup(part);
+    if (!p) return ESP_ERR_INVALID_ARG;
+    if (off % FLASH_SECTOR_SIZE || len % FLASH_SECTOR_SIZE) return ESP_ERR_INVALID_ARG;
+    if (off > part->size || len > part->size - off) return ESP_ERR_INVALID_SIZE;
+
+    bool cut = cut_now();
+    size_t n = cut ? len / 2 : len;
+    memset(p->mem + off, 0xFF, n);
+    persist(p, off, n);
+    if (cut) power_off();
+    s_stats.erases += len / FLASH_SECTOR_SIZE;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *part, size_t off, size_t len,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle) {
+    (void)memory;
+    flash_part_t *p = lookup(part);
+    if (!p) return ESP_ERR_INVALID_ARG;
+    if (off > part->size || len > part->size - off) return ESP_ERR_INVALID_SIZE;
+    *out_ptr = p->mem + off;
+    *out_handle = 0;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) {
+    (void)handle;
+}
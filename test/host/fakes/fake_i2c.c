@@ -0,0 +1,219 @@
+/**
+ * Fake I2C devices - in-memory SSD1306 and DS3231 register models
+ *
+ * Each model is bound to a hal_i2c_dev_t, so oled.c and ds3231.c run
+ * against it unchanged. Both count bus traffic and can be told to fail
+ * transactions (fault.skip succeed first, then fault.fail fail) without
+ * applying them, like a NACKed transfer.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "fakes.h"
+
+static bool fault_hit(fake_i2c_fault_t *f) {
+    if (f->skip > 0) {
+        f->skip--;
+        return false;
+    }
+    if (f->fail > 0) {
+        f->fail--;
+        return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// SSD1306
+// ---------------------------------------------------------------------------
+
+// Argument bytes following each multi-byte command
+static int ssd1306_args(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void ssd1306_command(fake_ssd1306_t *d, uint8_t byte) {
+    if (d->argc == 0) {
+        d->cmd = byte;
+        d->argn = 0;
+        d->argc = ssd1306_args(byte);
+        if (d->argc) return;
+    } else {
+        d->args[d->argn++] = byte;
+        if (d->argn < d->argc) return;
+        d->argc = 0;
+    }
+
+    switch (d->cmd) {
+    case 0x20: d->addr_mode = d->args[0] & 0x03; break;
+    case 0x21:
+        d->col_start = d->args[0] & 0x7F;
+        d->col_end = d->args[1] & 0x7F;
+        d->col = d->col_start;
+        break;
+    case 0x22:
+        d->page_start = d->args[0] & 0x07;
+        d->page_end = d->args[1] & 0x07;
+        d->page = d->page_start;
+        break;
+    case 0xAE: d->display_on = false; break;
+    case 0xAF: d->display_on = true; break;
+    default:
+        if (d->cmd >= 0xB0 && d->cmd <= 0xB7) {
+            d->page = d->cmd & 0x07;
+        } else if (d->cmd <= 0x0F) {
+            d->col = (d->col & 0xF0) | d->cmd;
+        } else if (d->cmd >= 0x10 && d->cmd <= 0x1F) {
+            d->col = (d->col & 0x0F) | ((d->cmd & 0x0F) << 4);
+        }
+        break;
+    }
+    d->commands++;
+}
+
+static void ssd1306_data(fake_ssd1306_t *d, uint8_t byte) {
+    d->ram[d->page][d->col] = byte;
+    d->data_bytes++;
+
+    if (d->addr_mode == 2) {
+        // Page addressing: the column wraps within the page
+        d->col = (d->col + 1) & 0x7F;
+        return;
+    }
+    if (d->col < d->col_end) {
+        d->col++;
+        return;
+    }
+    d->col = d->col_start;
+    d->page = d->page < d->page_end ? d->page + 1 : d->page_start;
+}
+
+static esp_err_t ssd1306_write(void *ctx, const uint8_t *data, size_t len) {
+    fake_ssd1306_t *d = ctx;
+    d->transactions++;
+    d->bus_bytes += len + 1;  // Plus the address byte
+    if (fault_hit(&d->fault)) return ESP_FAIL;
+
+    size_t i = 0;
+    while (i < len) {
+        uint8_t control = data[i++];
+        bool single = control & 0x80;  // Co: one byte, then another control byte
+        bool is_data = control & 0x40;
+        size_t end = single ? (i < len ? i + 1 : i) : len;
+        for (; i < end; i++) {
+            if (is_data) ssd1306_data(d, data[i]);
+            else ssd1306_command(d, data[i]);
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t ssd1306_write_read(void *ctx, const uint8_t *wr, size_t wr_len, uint8_t *rd, size_t rd_len) {
+    (void)ctx;
+    (void)wr;
+    (void)wr_len;
+    memset(rd, 0, rd_len);
+    return ESP_ERR_NOT_SUPPORTED;  // Write-only over I2C
+}
+
+void fake_ssd1306_init(fake_ssd1306_t *d, hal_i2c_dev_t *dev) {
+    memset(d, 0, sizeof(*d));
+    d->col_end = 127;
+    d->page_end = 7;
+    d->addr_mode = 2;  // Power-on default
+    dev->ctx = d;
+    dev->write = ssd1306_write;
+    dev->write_read = ssd1306_write_read;
+}
+
+// ---------------------------------------------------------------------------
+// DS3231
+// ---------------------------------------------------------------------------
+
+#define DS_REG_CONTROL  0x0E
+#define DS_REG_STATUS   0x0F
+#define DS_CONTROL_CONV 0x20
+#define DS_STATUS_OSF   0x80
+#define DS_STATUS_BSY   0x04
+
+static void ds3231_store(fake_ds3231_t *d, uint8_t reg, uint8_t val) {
+    if (reg == DS_REG_STATUS) {
+        // OSF can only be cleared; BSY is read-only
+        uint8_t osf = d->regs[reg] & val & DS_STATUS_OSF;
+        d->regs[reg] = osf | (d->regs[reg] & DS_STATUS_BSY) | (val & ~(DS_STATUS_OSF | DS_STATUS_BSY));
+        return;
+    }
+    if (reg == DS_REG_CONTROL && (val & DS_CONTROL_CONV)) {
+        if (d->regs[DS_REG_STATUS] & DS_STATUS_BSY) {
+            d->conv_while_busy++;  // Datasheet: check BSY before forcing a conversion
+        }
+        d->regs[DS_REG_STATUS] |= DS_STATUS_BSY;
+        d->busy_reads = d->conv_reads;
+        d->conversions++;
+    }
+    d->regs[reg] = val;
+}
+
+static uint8_t ds3231_load(fake_ds3231_t *d, uint8_t reg) {
+    uint8_t val = d->regs[reg];
+    if (reg == DS_REG_STATUS && (val & DS_STATUS_BSY)) {
+        // The conversion finishes after a few polls
+        if (d->busy_reads > 0) {
+            d->busy_reads--;
+        } else {
+            d->regs[DS_REG_STATUS] &= ~DS_STATUS_BSY;
+            d->regs[DS_REG_CONTROL] &= ~DS_CONTROL_CONV;
+        }
+    }
+    return val;
+}
+
+static esp_err_t ds3231_write(void *ctx, const uint8_t *data, size_t len) {
+    fake_ds3231_t *d = ctx;
+    d->transactions++;
+    if (fault_hit(&d->fault)) return ESP_FAIL;
+    if (len == 0) return ESP_OK;
+
+    d->ptr = data[0] % FAKE_DS3231_REGS;
+    for (size_t i = 1; i < len; i++) {
+        ds3231_store(d, d->ptr, data[i]);
+        d->ptr = (d->ptr + 1) % FAKE_DS3231_REGS;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t ds3231_write_read(void *ctx, const uint8_t *wr, size_t wr_len, uint8_t *rd, size_t rd_len) {
+    fake_ds3231_t *d = ctx;
+    d->transactions++;
+    if (fault_hit(&d->fault)) return ESP_FAIL;
+
+    if (wr_len) d->ptr = wr[0] % FAKE_DS3231_REGS;
+    for (size_t i = 0; i < rd_len; i++) {
+        rd[i] = ds3231_load(d, d->ptr);
+        d->ptr = (d->ptr + 1) % FAKE_DS3231_REGS;
+    }
+    return ESP_OK;
+}
+
+void fake_ds3231_init(fake_ds3231_t *d, hal_i2c_dev_t *dev) {
+    memset(d, 0, sizeof(*d));
+    d->regs[DS_REG_CONTROL] = 0x1C;              // Power-on: INTCN, RS2, RS1
+    d->regs[DS_REG_STATUS] = DS_STATUS_OSF | 0x08; // OSF and EN32kHz set at power-up
+    d->regs[0x11] = 25;                          // 25.00 C
+    d->conv_reads = 2;
+    dev->ctx = d;
+    dev->write = ds3231_write;
+    dev->write_read = ds3231_write_read;
+}
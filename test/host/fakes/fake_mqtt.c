@@ -0,0 +1,115 @@
+/**
+ * Fake MQTT - the esp-mqtt client and a broker, in one process
+ *
+ * Bound as the outbox transport. Like esp-mqtt, the client keeps every
+ * unacknowledged QoS 1 message and retransmits it with the same msg_id
+ * (DUP) while connected, deletes it once it expires (MQTT_EVENT_DELETED)
+ * and, with a clean session, forgets it on reconnect. The broker side
+ * fingerprints payloads so tests can count duplicate deliveries.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "fakes.h"
+
+static uint64_t fingerprint(const char *topic, const void *data, size_t len) {
+    uint64_t h = 1469598103934665603ULL;  // FNV-1a
+    for (const char *c = topic; *c; c++) h = (h ^ (uint8_t)*c) * 1099511628211ULL;
+    const uint8_t *b = data;
+    for (size_t i = 0; i < len; i++) h = (h ^ b[i]) * 1099511628211ULL;
+    return h;
+}
+
+static void broker_receive(fake_mqtt_t *m, uint64_t fp) {
+    m->received++;
+    for (uint32_t i = 0; i < m->seen_count; i++) {
+        if (m->seen[i] == fp) {
+            m->duplicates++;
+            return;
+        }
+    }
+    if (m->seen_count < FAKE_MQTT_SEEN) m->seen[m->seen_count++] = fp;
+    m->unique++;
+}
+
+static void drop_pending(fake_mqtt_t *m, int i) {
+    m->client_bytes -= m->pending[i].len;
+    m->pending[i] = m->pending[--m->pending_count];
+}
+
+int fake_mqtt_publish(void *ctx, const char *topic, const void *data, size_t len, int qos) {
+    fake_mqtt_t *m = ctx;
+    m->publishes++;
+    if (!m->connected && qos == 0) return -1;
+    if (m->client_bytes + len > m->limit || m->pending_count == FAKE_MQTT_PENDING) return -2;
+
+    int id = qos ? ++m->next_id : 0;
+    uint64_t fp = fingerprint(topic, data, len);
+    if (m->connected) broker_receive(m, fp);
+    if (qos == 0) return 0;
+
+    fake_mqtt_msg_t *p = &m->pending[m->pending_count++];
+    p->msg_id = id;
+    p->fp = fp;
+    p->len = len;
+    p->created_ms = m->now_ms;
+    p->first_ms = m->now_ms;
+    p->sent_ms = m->now_ms;
+    p->tx = m->connected ? 1 : 0;
+    m->client_bytes += len;
+    return id;
+}
+
+void fake_mqtt_init(fake_mqtt_t *m) {
+    memset(m, 0, sizeof(*m));
+    m->connected = true;
+    m->ack_delay_ms = 50;
+    m->retransmit_ms = 1000;
+    m->expire_ms = 30000;
+    m->limit = 8192;
+}
+
+void fake_mqtt_set_connected(fake_mqtt_t *m, bool connected) {
+    if (connected && !m->connected) {
+        m->reconnects++;
+        for (int i = m->pending_count - 1; i >= 0; i--) {
+            if (m->clean_session) {
+                drop_pending(m, i);
+            } else {
+                m->pending[i].resend = true;  // Resent on the next step
+            }
+        }
+    }
+    m->connected = connected;
+}
+
+void fake_mqtt_step(fake_mqtt_t *m, uint32_t now_ms) {
+    m->now_ms = now_ms;
+    for (int i = m->pending_count - 1; i >= 0; i--) {
+        fake_mqtt_msg_t *p = &m->pending[i];
+
+        if (now_ms - p->created_ms >= m->expire_ms) {
+            int id = p->msg_id;
+            drop_pending(m, i);
+            m->expired++;
+            if (m->on_deleted) m->on_deleted(id);
+            continue;
+        }
+        if (!m->connected) continue;
+
+        if (p->tx == 0 || p->resend || now_ms - p->sent_ms >= m->retransmit_ms) {
+            if (p->tx) m->client_resends++;
+            if (p->tx == 0 || p->resend) p->first_ms = now_ms;
+            broker_receive(m, p->fp);
+            p->tx++;
+            p->resend = false;
+            p->sent_ms = now_ms;
+        }
+        if (!m->stalled && now_ms - p->first_ms >= m->ack_delay_ms) {
+            int id = p->msg_id;
+            drop_pending(m, i);
+            m->acked++;
+            if (m->on_published) m->on_published(id);
+        }
+    }
+}
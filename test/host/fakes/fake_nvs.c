@@ -0,0 +1,257 @@
+/**
+ * Fake NVS - key/value store persisted to a host file
+ *
+ * Every set is written through to the file, as the real library writes
+ * flash on set. Space is accounted the way NVS does it: 32-byte entries,
+ * 126 per 4 KB page, one page kept free for garbage collection; a string
+ * or blob costs one header entry plus its data rounded up to entries,
+ * and a replaced value is only released after the new one was written.
+ * Syquens B.V. - 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nvs.h"
+#include "fakes.h"
+
+#define NVS_PAGE_SIZE       4096
+#define NVS_PAGE_ENTRIES    126
+#define NVS_ENTRY_SIZE      32
+#define NVS_KEY_MAX         15
+#define NVS_MAX_ITEMS       256
+#define NVS_MAX_HANDLES     16
+
+typedef enum { ITEM_NONE = 0, ITEM_U8, ITEM_U16, ITEM_STR, ITEM_BLOB, ITEM_NAMESPACE } item_type_t;
+
+typedef struct {
+    uint8_t type;
+    char ns[NVS_KEY_MAX + 1];
+    char key[NVS_KEY_MAX + 1];
+    uint32_t len;
+    uint8_t *data;
+} nvs_item_t;
+
+typedef struct {
+    bool open;
+    bool writable;
+    char ns[NVS_KEY_MAX + 1];
+} nvs_open_t;
+
+static nvs_item_t s_items[NVS_MAX_ITEMS];
+static nvs_open_t s_handles[NVS_MAX_HANDLES];
+static char s_path[256];
+static uint32_t s_budget = UINT32_MAX;
+static uint32_t s_used = 0;
+static fake_nvs_stats_t s_stats;
+
+static uint32_t item_entries(item_type_t type, uint32_t len) {
+    if (type == ITEM_STR || type == ITEM_BLOB) {
+        return 1 + (len + NVS_ENTRY_SIZE - 1) / NVS_ENTRY_SIZE;
+    }
+    return 1;
+}
+
+static nvs_item_t *find(const char *ns, const char *key, item_type_t type) {
+    for (int i = 0; i < NVS_MAX_ITEMS; i++) {
+        nvs_item_t *it = &s_items[i];
+        if (it->type == ITEM_NONE) continue;
+        if ((type == ITEM_NAMESPACE) != (it->type == ITEM_NAMESPACE)) continue;
+        if (strcmp(it->ns, ns) == 0 && strcmp(it->key, key) == 0) return it;
+    }
+    return NULL;
+}
+
+static void save(void) {
+    if (!s_path[0]) return;
+    FILE *f = fopen(s_path, "wb");
+    if (!f) return;
+    for (int i = 0; i < NVS_MAX_ITEMS; i++) {
+        const nvs_item_t *it = &s_items[i];
+        if (it->type == ITEM_NONE) continue;
+        fwrite(it, offsetof(nvs_item_t, data), 1, f);
+        fwrite(it->data, 1, it->len, f);
+    }
+    fclose(f);
+}
+
+static void clear(void) {
+    for (int i = 0; i < NVS_MAX_ITEMS; i++) {
+        free(s_items[i].data);
+    }
+    memset(s_items, 0, sizeof(s_items));
+    memset(s_handles, 0, sizeof(s_handles));
+    s_used = 0;
+}
+
+void fake_nvs_init(const char *path, size_t partition_size) {
+    clear();
+    memset(&s_stats, 0, sizeof(s_stats));
+    snprintf(s_path, sizeof(s_path), "%s", path ? path : "");
+    s_budget = partition_size ? (partition_size / NVS_PAGE_SIZE - 1) * NVS_PAGE_ENTRIES : UINT32_MAX;
+
+    FILE *f = path ? fopen(path, "rb") : NULL;
+    if (!f) return;
+    nvs_item_t hdr;
+    for (int i = 0; i < NVS_MAX_ITEMS && fread(&hdr, offsetof(nvs_item_t, data), 1, f) == 1; i++) {
+        hdr.data = malloc(hdr.len ? hdr.len : 1);
+        if (fread(hdr.data, 1, hdr.len, f) != hdr.len) {
+            free(hdr.data);
+            break;
+        }
+        s_items[i] = hdr;
+        s_used += item_entries(hdr.type, hdr.len);
+    }
+    fclose(f);
+}
+
+void fake_nvs_get_stats(fake_nvs_stats_t *out) {
+    *out = s_stats;
+    out->entries_used = s_used;
+    out->entries_total = s_budget;
+}
+
+static nvs_open_t *handle(nvs_handle_t h) {
+    return h >= 1 && h <= NVS_MAX_HANDLES && s_handles[h - 1].open ? &s_handles[h - 1] : NULL;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode, nvs_handle_t *out_handle) {
+    if (!name || strlen(name) > NVS_KEY_MAX) return ESP_ERR_NVS_INVALID_NAME;
+    if (!find(name, "", ITEM_NAMESPACE)) {
+        if (mode == NVS_READONLY) return ESP_ERR_NVS_NOT_FOUND;
+        if (s_used + 1 > s_budget) return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        for (int i = 0; i < NVS_MAX_ITEMS; i++) {
+            if (s_items[i].type != ITEM_NONE) continue;
+            s_items[i].type = ITEM_NAMESPACE;
+            snprintf(s_items[i].ns, sizeof(s_items[i].ns), "%s", name);
+            s_items[i].data = malloc(1);
+            s_used++;
+            save();
+            break;
+        }
+    }
+    for (int i = 0; i < NVS_MAX_HANDLES; i++) {
+        if (s_handles[i].open) continue;
+        s_handles[i].open = true;
+        s_handles[i].writable = mode == NVS_READWRITE;
+        snprintf(s_handles[i].ns, sizeof(s_handles[i].ns), "%s", name);
+        *out_handle = (nvs_handle_t)(i + 1);
+        return ESP_OK;
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t h) {
+    nvs_open_t *o = handle(h);
+    if (o) o->open = false;
+}
+
+esp_err_t nvs_commit(nvs_handle_t h) {
+    return handle(h) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+static esp_err_t set_item(nvs_handle_t h, const char *key, item_type_t type, const void *value, size_t len) {
+    nvs_open_t *o = handle(h);
+    if (!o) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!o->writable) return ESP_ERR_NVS_READ_ONLY;
+    if (!key || strlen(key) > NVS_KEY_MAX) return ESP_ERR_NVS_KEY_TOO_LONG;
+
+    s_stats.writes++;
+    nvs_item_t *old = find(o->ns, key, type);
+    if (old && old->type != type) return ESP_ERR_NVS_TYPE_MISMATCH;
+
+    // The new value is written before the old one is erased
+    uint32_t cost = item_entries(type, (uint32_t)len);
+    if (s_used + cost > s_budget) {
+        s_stats.no_space++;
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+
+    nvs_item_t *it = old;
+    if (!it) {
+        for (int i = 0; i < NVS_MAX_ITEMS && !it; i++) {
+            if (s_items[i].type == ITEM_NONE) it = &s_items[i];
+        }
+        if (!it) return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        it->type = type;
+        snprintf(it->ns, sizeof(it->ns), "%s", o->ns);
+        snprintf(it->key, sizeof(it->key), "%s", key);
+    } else {
+        s_used -= item_entries(type, old->len);
+        free(old->data);
+    }
+    it->data = malloc(len ? len : 1);
+    memcpy(it->data, value, len);
+    it->len = (uint32_t)len;
+    s_used += cost;
+    s_stats.bytes_written += len;
+    save();
+    return ESP_OK;
+}
+
+static esp_err_t get_item(nvs_handle_t h, const char *key, item_type_t type, void *out, size_t *len) {
+    nvs_open_t *o = handle(h);
+    if (!o) return ESP_ERR_NVS_INVALID_HANDLE;
+    nvs_item_t *it = find(o->ns, key, type);
+    if (!it) return ESP_ERR_NVS_NOT_FOUND;
+    if (it->type != type) return ESP_ERR_NVS_TYPE_MISMATCH;
+    if (!out) {
+        *len = it->len;
+        return ESP_OK;
+    }
+    if (*len < it->len) return ESP_ERR_NVS_INVALID_LENGTH;
+    memcpy(out, it->data, it->len);
+    *len = it->len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t h, const char *key) {
+    nvs_open_t *o = handle(h);
+    if (!o) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!o->writable) return ESP_ERR_NVS_READ_ONLY;
+    for (int i = 0; i < NVS_MAX_ITEMS; i++) {
+        nvs_item_t *it = &s_items[i];
+        if (it->type == ITEM_NONE || it->type == ITEM_NAMESPACE) continue;
+        if (strcmp(it->ns, o->ns) != 0 || strcmp(it->key, key) != 0) continue;
+        s_used -= item_entries(it->type, it->len);
+        free(it->data);
+        memset(it, 0, sizeof(*it));
+        save();
+        return ESP_OK;
+    }
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t h, const char *key, const void *value, size_t length) {
+    return set_item(h, key, ITEM_BLOB, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t h, const char *key, void *out_value, size_t *length) {
+    return get_item(h, key, ITEM_BLOB, out_value, length);
+}
+
+esp_err_t nvs_set_str(nvs_handle_t h, const char *key, const char *value) {
+    return set_item(h, key, ITEM_STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t h, const char *key, char *out_value, size_t *length) {
+    return get_item(h, key, ITEM_STR, out_value, length);
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t h, const char *key, uint8_t value) {
+    return set_item(h, key, ITEM_U8, &value, 1);
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t h, const char *key, uint8_t *out_value) {
+    size_t len = 1;
+    return get_item(h, key, ITEM_U8, out_value, &len);
+}
+
+esp_err_t nvs_set_u16(nvs_handle_t h, const char *key, uint16_t value) {
+    return set_item(h, key, ITEM_U16, &value, 2);
+}
+
+esp_err_t nvs_get_u16(nvs_handle_t h, const char *key, uint16_t *out_value) {
+    size_t len = 2;
+    return get_item(h, key, ITEM_U16, out_value, &len);
+}
@@ -0,0 +1,117 @@
+/**
+ * Fake UART - replayable byte source behind a hal_uart_t
+ *
+ * Reads return queued receiver replies first, then the replayed capture,
+ * at most chunk bytes per call (0 = no limit). An empty port returns 0 at
+ * once instead of waiting out the timeout. Writes are captured, and with
+ * the GNSS model enabled CFG frames are answered like a u-blox receiver:
+ * ACK-ACK (ACK-NAK for NAV-PVT on a receiver without it), nothing when the
+ * host is on the wrong baud rate, and CFG-PRT switches the receiver's rate.
+ * Syquens B.V. - 2026
+ */
+
+#include <string.h>
+#include "ubx.h"
+#include "fakes.h"
+
+static void queue_reply(fake_uart_t *u, const uint8_t *data, size_t len) {
+    if (u->reply_len + len > sizeof(u->reply)) return;
+    memcpy(u->reply + u->reply_len, data, len);
+    u->reply_len += len;
+}
+
+static void gnss_ack(fake_uart_t *u, uint8_t cls, uint8_t id, bool ack) {
+    uint8_t payload[2] = { cls, id };
+    uint8_t frame[UBX_OVERHEAD + 2];
+    size_t n = ubx_build(UBX_CLASS_ACK, ack ? UBX_ACK_ACK : UBX_ACK_NAK, payload, 2, frame, sizeof(frame));
+    queue_reply(u, frame, n);
+}
+
+static void gnss_frame(fake_uart_t *u, const ubx_parser_t *p) {
+    if (p->cls != UBX_CLASS_CFG) return;
+    u->cfg_frames++;
+
+    bool ack = true;
+    if (p->id == UBX_CFG_MSG && p->len >= 2 && p->payload[0] == UBX_CLASS_NAV &&
+        p->payload[1] == UBX_NAV_PVT) {
+        ack = u->gnss_nav_pvt;
+    }
+    gnss_ack(u, p->cls, p->id, ack);
+
+    if (p->id == UBX_CFG_PRT && p->len >= 12) {
+        u->gnss_baud = (uint32_t)p->payload[8] | (uint32_t)p->payload[9] << 8 |
+                       (uint32_t)p->payload[10] << 16 | (uint32_t)p->payload[11] << 24;
+    }
+}
+
+static esp_err_t uart_write(void *ctx, const uint8_t *data, size_t len) {
+    fake_uart_t *u = ctx;
+    u->writes++;
+    if (u->fail_writes > 0) {
+        u->fail_writes--;
+        return ESP_FAIL;
+    }
+    size_t room = sizeof(u->tx) - u->tx_len;
+    size_t n = len < room ? len : room;
+    memcpy(u->tx + u->tx_len, data, n);
+    u->tx_len += n;
+
+    // A receiver on another rate sees only framing errors
+    if (!u->gnss || u->baud != u->gnss_baud) return ESP_OK;
+    for (size_t i = 0; i < len; i++) {
+        if (ubx_parse_byte(&u->gnss_parser, data[i])) {
+            gnss_frame(u, &u->gnss_parser);
+        }
+    }
+    return ESP_OK;
+}
+
+static int uart_read(void *ctx, uint8_t *buf, size_t len, uint32_t timeout_ms) {
+    (void)timeout_ms;
+    fake_uart_t *u = ctx;
+    if (u->chunk && len > u->chunk) len = u->chunk;
+
+    size_t n = 0;
+    if (u->reply_pos < u->reply_len) {
+        size_t avail = u->reply_len - u->reply_pos;
+        n = len < avail ? len : avail;
+        memcpy(buf, u->reply + u->reply_pos, n);
+        u->reply_pos += n;
+        if (u->reply_pos == u->reply_len) u->reply_pos = u->reply_len = 0;
+    } else if (u->rx_pos < u->rx_len) {
+        size_t avail = u->rx_len - u->rx_pos;
+        n = len < avail ? len : avail;
+        memcpy(buf, u->rx + u->rx_pos, n);
+        u->rx_pos += n;
+    }
+    u->bytes_read += n;
+    return (int)n;
+}
+
+static esp_err_t uart_set_baud(void *ctx, uint32_t baud) {
+    fake_uart_t *u = ctx;
+    u->baud = baud;
+    u->reply_len = u->reply_pos = 0;  // The driver flushes input on a rate change
+    return ESP_OK;
+}
+
+void fake_uart_init(fake_uart_t *u, hal_uart_t *hal) {
+    memset(u, 0, sizeof(*u));
+    ubx_parser_reset(&u->gnss_parser);
+    hal->ctx = u;
+    hal->write = uart_write;
+    hal->read = uart_read;
+    hal->set_baud = uart_set_baud;
+}
+
+void fake_uart_replay(fake_uart_t *u, const uint8_t *data, size_t len) {
+    u->rx = data;
+    u->rx_len = len;
+    u->rx_pos = 0;
+}
+
+void fake_uart_gnss(fake_uart_t *u, uint32_t baud, bool nav_pvt) {
+    u->gnss = true;
+    u->gnss_baud = baud;
+    u->gnss_nav_pvt = nav_pvt;
+}
@@ -0,0 +1,154 @@
+/**
+ * Fake IDF UART driver - the receive side as gps_rx.c sees it
+ *
+ * fake_uart_driver_rx() plays the RX interrupt: each call is one FIFO
+ * burst copied into the ring buffer. Like the IDF driver it posts a
+ * UART_DATA event per burst and a UART_PATTERN_DET event per pattern
+ * character, records pattern positions relative to the read position
+ * (dropping them when the position queue is full), and on a full ring
+ * posts UART_BUFFER_FULL and loses input until the reader makes room or
+ * flushes. Events that do not fit the event queue are lost.
+ * Syquens B.V. - 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "driver/uart.h"
+#include "fakes.h"
+
+#define FAKE_UART_PORTS     3
+#define FAKE_PATTERN_MAX    256
+
+typedef struct {
+    bool installed;
+    uint8_t *ring;
+    size_t size;
+    size_t head;                // Read position
+    size_t used;
+    QueueHandle_t queue;
+    bool full;                  // UART_BUFFER_FULL posted, input dropped
+    char pattern;
+    bool pattern_on;
+    int pos[FAKE_PATTERN_MAX];  // Offsets from the read position, oldest first
+    int pos_count;
+    int pos_max;
+    fake_uart_driver_stats_t stats;
+} fake_port_t;
+
+static fake_port_t s_ports[FAKE_UART_PORTS];
+
+static void post(fake_port_t *p, uart_event_type_t type, size_t size) {
+    uart_event_t e = { .type = type, .size = size };
+    if (xQueueSendFromISR(p->queue, &e, NULL) != pdTRUE) {
+        p->stats.events_lost++;
+    }
+}
+
+esp_err_t uart_driver_install(uart_port_t port, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, QueueHandle_t *queue, int intr_flags) {
+    if (port < 0 || port >= FAKE_UART_PORTS) return ESP_ERR_INVALID_ARG;
+    fake_port_t *p = &s_ports[port];
+    if (p->installed) uart_driver_delete(port);
+    memset(p, 0, sizeof(*p));
+    p->installed = true;
+    p->ring = malloc(rx_buffer_size);
+    p->size = rx_buffer_size;
+    p->queue = xQueueCreate(queue_size, sizeof(uart_event_t));
+    if (queue) *queue = p->queue;
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t port) {
+    fake_port_t *p = &s_ports[port];
+    if (!p->installed) return ESP_ERR_INVALID_STATE;
+    free(p->ring);
+    vQueueDelete(p->queue);
+    memset(p, 0, sizeof(*p));
+    return ESP_OK;
+}
+
+int uart_read_bytes(uart_port_t port, void *buf, uint32_t length, TickType_t ticks) {
+    fake_port_t *p = &s_ports[port];
+    size_t n = length < p->used ? length : p->used;   // Never waits: the replay is single-threaded
+    for (size_t i = 0; i < n; i++) {
+        ((uint8_t *)buf)[i] = p->ring[(p->head + i) % p->size];
+    }
+    p->head = (p->head + n) % p->size;
+    p->used -= n;
+
+    // Positions stay relative to the read position
+    for (int i = 0; i < p->pos_count; i++) {
+        p->pos[i] -= (int)n;
+    }
+    if (n > 0) p->full = false;
+    return (int)n;
+}
+
+esp_err_t uart_flush_input(uart_port_t port) {
+    fake_port_t *p = &s_ports[port];
+    p->head = p->used = 0;
+    p->pos_count = 0;
+    p->full = false;
+    p->stats.flushes++;
+    return ESP_OK;
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t port, size_t *size) {
+    *size = s_ports[port].used;
+    return ESP_OK;
+}
+
+esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t port, char pattern_chr, uint8_t chr_num,
+                                            int chr_tout, int post_idle, int pre_idle) {
+    s_ports[port].pattern = pattern_chr;
+    s_ports[port].pattern_on = true;
+    return ESP_OK;
+}
+
+esp_err_t uart_pattern_queue_reset(uart_port_t port, int queue_length) {
+    fake_port_t *p = &s_ports[port];
+    p->pos_max = queue_length < FAKE_PATTERN_MAX ? queue_length : FAKE_PATTERN_MAX;
+    p->pos_count = 0;
+    return ESP_OK;
+}
+
+int uart_pattern_pop_pos(uart_port_t port) {
+    fake_port_t *p = &s_ports[port];
+    if (p->pos_count == 0) return -1;
+    int pos = p->pos[0];
+    memmove(&p->pos[0], &p->pos[1], (p->pos_count - 1) * sizeof(int));
+    p->pos_count--;
+    return pos;
+}
+
+void fake_uart_driver_rx(uart_port_t port, const void *data, size_t len) {
+    fake_port_t *p = &s_ports[port];
+    const uint8_t *d = data;
+    p->stats.rx_bytes += len;
+
+    if (p->full || p->size - p->used < len) {
+        if (!p->full) post(p, UART_BUFFER_FULL, 0);
+        p->full = true;
+        p->stats.lost_bytes += len;
+        return;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        p->ring[(p->head + p->used) % p->size] = d[i];
+        if (p->pattern_on && d[i] == (uint8_t)p->pattern) {
+            if (p->pos_count < p->pos_max) {
+                p->pos[p->pos_count++] = (int)p->used;
+            } else {
+                p->stats.positions_lost++;
+            }
+            post(p, UART_PATTERN_DET, 0);
+        }
+        p->used++;
+    }
+    if (p->used > p->stats.max_buffered) p->stats.max_buffered = p->used;
+    post(p, UART_DATA, len);
+}
+
+void fake_uart_driver_get_stats(uart_port_t port, fake_uart_driver_stats_t *out) {
+    *out = s_ports[port].stats;
+}
@@ -0,0 +1,211 @@
+/**
+ * Host fakes for the firmware modules
+ *
+ * Stand-ins for the hardware and IDF services the modules in main/ use:
+ * pthread FreeRTOS, a settable esp_timer clock, file-backed NVS and flash
+ * partitions, a replayable UART, SSD1306/DS3231 register models and an
+ * MQTT client/broker pair for the outbox.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef FAKES_H
+#define FAKES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+#include "hal.h"
+#include "ubx.h"
+
+// ---------------------------------------------------------------------------
+// Clock (fake_esp.c)
+// ---------------------------------------------------------------------------
+
+// Freeze esp_timer_get_time() at us; it then only moves with fake_time_advance
+void fake_time_set(int64_t us);
+void fake_time_advance(int64_t us);
+// Move xTaskGetTickCount() ahead of CLOCK_MONOTONIC by ms (fake_rtos.c)
+void fake_ticks_advance(uint32_t ms);
+
+// ---------------------------------------------------------------------------
+// NVS (fake_nvs.c)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t writes;
+    uint32_t no_space;          // Sets refused with ESP_ERR_NVS_NOT_ENOUGH_SPACE
+    uint32_t bytes_written;
+    uint32_t entries_used;      // 32-byte entries holding live data
+    uint32_t entries_total;     // Usable entries (all pages but one)
+} fake_nvs_stats_t;
+
+// Start over from the image in path (NULL: RAM only); partition_size 0 = unlimited
+void fake_nvs_init(const char *path, size_t partition_size);
+void fake_nvs_get_stats(fake_nvs_stats_t *out);
+
+// ---------------------------------------------------------------------------
+// Flash partitions (fake_flash.c)
+// ---------------------------------------------------------------------------
+
+#define FAKE_FLASH_CUT_EXIT     86      // Exit status of a process killed by a power cut
+
+typedef struct {
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t erases;            // Sectors
+    uint32_t bytes_written;
+} fake_flash_stats_t;
+
+// Register a data partition backed by path (NULL: RAM only), erased if new
+const esp_partition_t *fake_flash_add(const char *label, esp_partition_subtype_t subtype, uint32_t size,
+                                      const char *path);
+uint8_t *fake_flash_data(const esp_partition_t *part);
+// Power cut: ops more writes/erases complete, the next one is half done
+void fake_flash_cut_after(long ops);
+void fake_flash_get_stats(fake_flash_stats_t *out);
+
+// ---------------------------------------------------------------------------
+// IDF UART driver, receive side (fake_uart_driver.c, driver/uart.h stub)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t rx_bytes;          // Bytes that reached the RX interrupt
+    uint32_t lost_bytes;        // Dropped on a full ring buffer
+    uint32_t events_lost;       // Event queue full
+    uint32_t positions_lost;    // Pattern position queue full
+    uint32_t flushes;
+    size_t max_buffered;        // Ring buffer high-water mark
+} fake_uart_driver_stats_t;
+
+// One RX FIFO burst arriving on an installed port
+void fake_uart_driver_rx(int port, const void *data, size_t len);
+void fake_uart_driver_get_stats(int port, fake_uart_driver_stats_t *out);
+
+// ---------------------------------------------------------------------------
+// UART (fake_uart.c)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const uint8_t *rx;          // Replayed capture
+    size_t rx_len;
+    size_t rx_pos;
+    size_t chunk;               // Max bytes per read, 0 = unlimited
+    uint32_t baud;              // Host side rate (set_baud)
+    uint8_t reply[512];         // Receiver answers, read before the capture
+    size_t reply_len;
+    size_t reply_pos;
+    uint8_t tx[2048];           // Captured writes
+    size_t tx_len;
+    int fail_writes;            // Fail this many writes
+    uint32_t writes;
+    uint32_t bytes_read;
+    // GNSS receiver model
+    bool gnss;
+    bool gnss_nav_pvt;          // ACKs NAV-PVT (u-blox 8) or NAKs it (NEO-6M)
+    uint32_t gnss_baud;
+    uint32_t cfg_frames;
+    ubx_parser_t gnss_parser;
+} fake_uart_t;
+
+void fake_uart_init(fake_uart_t *u, hal_uart_t *hal);
+void fake_uart_replay(fake_uart_t *u, const uint8_t *data, size_t len);
+// Answer CFG messages like a u-blox receiver currently running at baud
+void fake_uart_gnss(fake_uart_t *u, uint32_t baud, bool nav_pvt);
+
+// ---------------------------------------------------------------------------
+// I2C devices (fake_i2c.c)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    int skip;                   // Transactions that still succeed
+    int fail;                   // Then this many fail
+} fake_i2c_fault_t;
+
+typedef struct {
+    uint8_t ram[8][128];        // GDDRAM, page-major
+    bool display_on;
+    uint8_t addr_mode;          // 0 horizontal, 1 vertical, 2 page
+    uint8_t col, col_start, col_end;
+    uint8_t page, page_start, page_end;
+    uint8_t cmd, args[6];
+    int argc, argn;
+    uint32_t transactions;
+    uint32_t bus_bytes;         // Including the address byte
+    uint32_t commands;
+    uint32_t data_bytes;
+    fake_i2c_fault_t fault;
+} fake_ssd1306_t;
+
+#define FAKE_DS3231_REGS    0x13
+
+typedef struct {
+    uint8_t regs[FAKE_DS3231_REGS];
+    uint8_t ptr;
+    int conv_reads;             // Status reads that still show BSY after CONV
+    int busy_reads;
+    uint32_t conversions;
+    uint32_t conv_while_busy;   // CONV written while BSY was set
+    uint32_t transactions;
+    fake_i2c_fault_t fault;
+} fake_ds3231_t;
+
+void fake_ssd1306_init(fake_ssd1306_t *d, hal_i2c_dev_t *dev);
+void fake_ds3231_init(fake_ds3231_t *d, hal_i2c_dev_t *dev);
+
+// ---------------------------------------------------------------------------
+// MQTT client + broker (fake_mqtt.c)
+// ---------------------------------------------------------------------------
+
+#define FAKE_MQTT_PENDING   64
+#define FAKE_MQTT_SEEN      4096
+
+typedef struct {
+    int msg_id;
+    uint64_t fp;
+    size_t len;
+    uint32_t created_ms;
+    uint32_t first_ms;          // First send on this connection; PUBACK ack_delay_ms later
+    uint32_t sent_ms;
+    uint16_t tx;                // Times sent to the broker
+    bool resend;
+} fake_mqtt_msg_t;
+
+typedef struct {
+    bool connected;
+    bool stalled;               // Broker withholds PUBACKs
+    bool clean_session;         // Reconnect discards the client's unacked messages
+    uint32_t ack_delay_ms;
+    uint32_t retransmit_ms;     // Client resend of an unacked QoS 1 message
+    uint32_t expire_ms;         // Client gives up and reports MQTT_EVENT_DELETED
+    size_t limit;               // Client outbox bytes; publish returns -2 beyond
+    void (*on_published)(int msg_id);
+    void (*on_deleted)(int msg_id);
+
+    uint32_t now_ms;
+    int next_id;
+    fake_mqtt_msg_t pending[FAKE_MQTT_PENDING];
+    int pending_count;
+    size_t client_bytes;
+    uint64_t seen[FAKE_MQTT_SEEN];
+    uint32_t seen_count;
+
+    uint32_t publishes;         // Calls from the outbox
+    uint32_t received;          // PUBLISH packets at the broker
+    uint32_t unique;
+    uint32_t duplicates;        // Payloads the broker had already received
+    uint32_t client_resends;
+    uint32_t acked;
+    uint32_t expired;
+    uint32_t reconnects;
+} fake_mqtt_t;
+
+void fake_mqtt_init(fake_mqtt_t *m);
+void fake_mqtt_set_connected(fake_mqtt_t *m, bool connected);
+// Advance the client and broker to now_ms: resends, PUBACKs, expiry
+void fake_mqtt_step(fake_mqtt_t *m, uint32_t now_ms);
+// outbox_transport_t.publish; ctx is the fake_mqtt_t
+int fake_mqtt_publish(void *ctx, const char *topic, const void *data, size_t len, int qos);
+
+#endif // FAKES_H
@@ -0,0 +1,96 @@
+/**
+ * Minimal NTP client for the host tests and the load generator: requests
+ * go to the firmware's server on loopback (NTP_SERVER_PORT, overridden
+ * for the host build so no privileges are needed).
+ * Syquens B.V. - 2026
+ */
+
+#ifndef NTP_CLIENT_H
+#define NTP_CLIENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "config.h"
+
+#define NTP_CLIENT_PACKET_SIZE  48
+#define NTP_CLIENT_UNIX_OFFSET  2208988800ULL
+
+typedef struct {
+    uint8_t li;
+    uint8_t version;
+    uint8_t mode;
+    uint8_t stratum;
+    uint8_t poll;
+    uint32_t root_dispersion;   // NTP short format (16.16 s)
+    uint32_t refid;
+    uint64_t origin;            // 32.32 timestamps, as on the wire
+    uint64_t receive;
+    uint64_t transmit;
+} ntp_reply_t;
+
+static inline uint32_t ntp_client_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint64_t ntp_client_be64(const uint8_t *p) {
+    return ((uint64_t)ntp_client_be32(p) << 32) | ntp_client_be32(p + 4);
+}
+
+// 32.32 NTP timestamp to Unix microseconds
+static inline int64_t ntp_client_ts_us(uint64_t ts) {
+    int64_t sec = (int64_t)(ts >> 32) - (int64_t)NTP_CLIENT_UNIX_OFFSET;
+    return sec * 1000000 + (int64_t)(((ts & 0xFFFFFFFFULL) * 1000000ULL) >> 32);
+}
+
+// UDP socket connected to the server; receives time out after timeout_ms
+static inline int ntp_client_open(uint32_t timeout_ms) {
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) return -1;
+    struct timeval tv = { .tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(NTP_SERVER_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// Client-mode request; the server echoes tag back as the origin timestamp
+static inline bool ntp_client_send(int sock, uint8_t version, uint8_t poll, uint64_t tag) {
+    uint8_t pkt[NTP_CLIENT_PACKET_SIZE] = {0};
+    pkt[0] = (version << 3) | 3;
+    pkt[2] = poll;
+    for (int i = 0; i < 8; i++) {
+        pkt[40 + i] = (uint8_t)(tag >> (56 - 8 * i));
+    }
+    return send(sock, pkt, sizeof(pkt), 0) == sizeof(pkt);
+}
+
+static inline bool ntp_client_recv(int sock, ntp_reply_t *out) {
+    uint8_t pkt[NTP_CLIENT_PACKET_SIZE];
+    if (recv(sock, pkt, sizeof(pkt), 0) != sizeof(pkt)) return false;
+    out->li = pkt[0] >> 6;
+    out->version = (pkt[0] >> 3) & 0x07;
+    out->mode = pkt[0] & 0x07;
+    out->stratum = pkt[1];
+    out->poll = pkt[2];
+    out->root_dispersion = ntp_client_be32(pkt + 8);
+    out->refid = ntp_client_be32(pkt + 12);
+    out->origin = ntp_client_be64(pkt + 24);
+    out->receive = ntp_client_be64(pkt + 32);
+    out->transmit = ntp_client_be64(pkt + 40);
+    return true;
+}
+
+#endif // NTP_CLIENT_H
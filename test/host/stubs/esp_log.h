@@ -0,0 +1,12 @@
+// Host stand-in: logs go to stderr, silenced unless FAKE_LOG is set
+#pragma once
+#include <stdio.h>
+
+extern int fake_log_enabled;
+
+#define ESP_LOG_(level, tag, fmt, ...) \
+    do { if (fake_log_enabled) fprintf(stderr, level " (%s) " fmt "\n", tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGE(tag, fmt, ...) ESP_LOG_("E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ESP_LOG_("W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ESP_LOG_("I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_LOG_("D", tag, fmt, ##__VA_ARGS__)
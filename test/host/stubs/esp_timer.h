@@ -0,0 +1,5 @@
+// Host stand-in: monotonic time, or the fake clock once fake_time_set() was called
+#pragma once
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
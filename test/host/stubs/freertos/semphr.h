@@ -0,0 +1,10 @@
+// Host stand-in: a mutex is a one-item queue, as in FreeRTOS
+#pragma once
+#include "freertos/queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+#define xSemaphoreTake(sem, ticks)  xQueueReceive((sem), NULL, (ticks))
+#define xSemaphoreGive(sem)         xQueueSend((sem), NULL, 0)
+#define vSemaphoreDelete(sem)       vQueueDelete(sem)
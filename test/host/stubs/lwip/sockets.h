@@ -0,0 +1,7 @@
+// Host stand-in: lwIP's BSD socket API is the POSIX one
+#pragma once
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
@@ -0,0 +1,9 @@
+// Host build: placeholder for the gitignored main/mqtt_credentials.h
+#ifndef MQTT_CREDENTIALS_H
+#define MQTT_CREDENTIALS_H
+
+#define MQTT_BROKER_URI     "mqtt://127.0.0.1:1883"
+#define MQTT_USER           "host"
+#define MQTT_PASSWORD       "host"
+
+#endif // MQTT_CREDENTIALS_H
@@ -0,0 +1,8 @@
+// Host build: placeholder for the gitignored main/wifi_credentials.h
+#ifndef WIFI_CREDENTIALS_H
+#define WIFI_CREDENTIALS_H
+
+#define WIFI_SSID "host"
+#define WIFI_PASSWORD "host"
+
+#endif // WIFI_CREDENTIALS_H
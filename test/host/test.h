@@ -0,0 +1,55 @@
+/**
+ * Minimal test runner for the host tests
+ *
+ * CHECK records a failure and carries on, so one run reports every broken
+ * expectation. Each test binary calls RUN for its cases and returns
+ * TEST_RESULT() from main; ctest treats a non-zero exit as a failure.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "testdata.h"
+
+static int test_failures = 0;
+static const char *test_current = "";
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: %s: CHECK(%s) failed\n", __FILE__, __LINE__, test_current, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) do { \
+        long long a_ = (long long)(a), b_ = (long long)(b); \
+        if (a_ != b_) { \
+            fprintf(stderr, "%s:%d: %s: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                    __FILE__, __LINE__, test_current, #a, #b, a_, b_); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_STR(a, b) do { \
+        const char *a_ = (a), *b_ = (b); \
+        if (strcmp(a_, b_) != 0) { \
+            fprintf(stderr, "%s:%d: %s: CHECK_STR(%s, %s) failed: \"%s\" != \"%s\"\n", \
+                    __FILE__, __LINE__, test_current, #a, #b, a_, b_); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define RUN(fn) do { \
+        test_current = #fn; \
+        int before_ = test_failures; \
+        fn(); \
+        printf("%-40s %s\n", #fn, test_failures == before_ ? "ok" : "FAILED"); \
+    } while (0)
+
+#define TEST_RESULT() (test_failures ? EXIT_FAILURE : EXIT_SUCCESS)
+
+#endif // TEST_H
@@ -0,0 +1,79 @@
+/**
+ * Test data access, shared by the tests and the benchmarks
+ *
+ * Recorded or synthesized inputs live in test/host/data (TEST_DATA_DIR);
+ * scratch files (NVS, flash images) go to the build tree (TEST_TMP_DIR).
+ * Syquens B.V. - 2026
+ */
+
+#ifndef TESTDATA_H
+#define TESTDATA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Whole file into a malloc'd buffer (NUL-terminated); aborts if missing
+static inline char *test_read_file(const char *name, size_t *len) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", TEST_DATA_DIR, name);
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "missing test data: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc(size + 1);
+    if (fread(buf, 1, size, f) != (size_t)size) {
+        fprintf(stderr, "short read: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    buf[size] = 0;
+    fclose(f);
+    if (len) *len = (size_t)size;
+    return buf;
+}
+
+// Scratch file path in the build tree, removed first
+static inline const char *test_tmp_path(const char *name) {
+    static char path[512];
+    snprintf(path, sizeof(path), "%s/%s", TEST_TMP_DIR, name);
+    remove(path);
+    return path;
+}
+
+// Line views into a text buffer (CR/LF kept, as the UART delivers them)
+typedef struct {
+    const char *ptr;
+    size_t len;
+} test_line_t;
+
+// Split buf into lines; returns a malloc'd array of *count views
+static inline test_line_t *test_split_lines(const char *buf, size_t len, size_t *count) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] == '\n') n++;
+    }
+    test_line_t *lines = malloc((n + 1) * sizeof(*lines));
+    size_t start = 0;
+    n = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] == '\n') {
+            lines[n].ptr = buf + start;
+            lines[n].len = i + 1 - start;
+            n++;
+            start = i + 1;
+        }
+    }
+    if (start < len) {
+        lines[n].ptr = buf + start;
+        lines[n].len = len - start;
+        n++;
+    }
+    *count = n;
+    return lines;
+}
+
+#endif // TESTDATA_H
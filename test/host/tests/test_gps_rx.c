@@ -0,0 +1,220 @@
+/**
+ * GNSS UART ingestion: the recorded drive replayed through the fake IDF
+ * UART driver into gps_rx, at the boot and configured baud rates, with a
+ * slow or stalled GPS task, garbage on the line and binary UBX output
+ * Syquens B.V. - 2026
+ */
+
+#include <math.h>
+#include "gps_rx.h"
+#include "nmea.h"
+#include "ubx.h"
+#include "uart_replay.h"
+#include "test.h"
+
+static test_line_t *s_expect;
+static size_t s_expect_count;
+static size_t s_next;           // Next expected line
+static uint32_t s_delivered;
+static uint32_t s_mismatched;   // Delivered lines that are not the next log line
+static uint32_t s_corrupt;      // ...and would pass the NMEA checksum
+
+// Delivered lines must be log lines, in order, whole; gaps are allowed
+static void on_line(const char *line, size_t len) {
+    s_delivered++;
+    for (size_t i = s_next; i < s_expect_count; i++) {
+        if (s_expect[i].len == len && memcmp(s_expect[i].ptr, line, len) == 0) {
+            s_next = i + 1;
+            return;
+        }
+    }
+    s_mismatched++;
+    nmea_sentence_t sentence;
+    if (nmea_tokenize(line, len, &sentence) && sentence.checksum_ok) s_corrupt++;
+}
+
+static ubx_parser_t s_ubx;
+static uint32_t s_frames;
+
+static void on_data(const uint8_t *data, size_t len) {
+    while (len > 0) {
+        bool frame;
+        size_t used = ubx_parse(&s_ubx, data, len, &frame);
+        data += used;
+        len -= used;
+        if (frame) s_frames++;
+    }
+}
+
+static gps_rx_t rx;
+static char *s_log;
+static size_t s_log_len;
+
+static void replay_log(const replay_cfg_t *cfg) {
+    s_next = 0;
+    s_delivered = s_mismatched = s_corrupt = 0;
+    uart_replay(&rx, cfg, (const uint8_t *)s_log, s_log_len, on_line, NULL);
+}
+
+static void test_keeps_up(void) {
+    const uint32_t bauds[] = { 9600, 115200, 460800 };
+    for (size_t i = 0; i < 3; i++) {
+        replay_cfg_t cfg = { .baud = bauds[i], .service_ms = 10 };
+        replay_log(&cfg);
+        CHECK_EQ(s_delivered, s_expect_count);
+        CHECK_EQ(s_mismatched, 0);
+        CHECK_EQ(rx.dropped, 0);
+    }
+}
+
+// Task wakes rarely: the event queue overflows, but every line still gets out
+static void test_event_queue_overflow(void) {
+    replay_cfg_t cfg = { .baud = 115200, .service_ms = 75 };
+    replay_log(&cfg);
+
+    fake_uart_driver_stats_t st;
+    fake_uart_driver_get_stats(REPLAY_PORT, &st);
+    CHECK(st.events_lost > 0);
+    CHECK_EQ(st.lost_bytes, 0);
+    CHECK_EQ(s_delivered, s_expect_count);
+    CHECK_EQ(s_mismatched, 0);
+    CHECK_EQ(rx.dropped, 0);
+}
+
+// Lost '\n' positions do not strand lines in the ring
+static void test_position_queue_overflow(void) {
+    QueueHandle_t queue;
+    uart_driver_install(REPLAY_PORT, GPS_BUFFER_SIZE, 0, GPS_EVENT_QUEUE_SIZE, &queue, 0);
+
+    // Same replay with a 4-entry position queue
+    s_next = 0;
+    s_delivered = s_mismatched = s_corrupt = 0;
+    memset(&rx, 0, sizeof(rx));
+    rx.port = REPLAY_PORT;
+    rx.queue = queue;
+    rx.on_line = on_line;
+    gps_rx_start(&rx);
+    uart_pattern_queue_reset(REPLAY_PORT, 4);
+
+    size_t sent = 0;
+    uart_event_t event;
+    uint32_t bursts = 0;
+    while (sent < s_log_len) {
+        size_t burst = s_log_len - sent < REPLAY_FIFO_BURST ? s_log_len - sent : REPLAY_FIFO_BURST;
+        fake_uart_driver_rx(REPLAY_PORT, s_log + sent, burst);
+        sent += burst;
+        if (++bursts % 6 == 0 || sent == s_log_len) {
+            while (xQueueReceive(queue, &event, 0) == pdTRUE) {
+                gps_rx_handle(&rx, &event);
+            }
+        }
+    }
+
+    fake_uart_driver_stats_t st;
+    fake_uart_driver_get_stats(REPLAY_PORT, &st);
+    CHECK(st.positions_lost > 0);
+    CHECK_EQ(s_delivered, s_expect_count);
+    CHECK_EQ(s_mismatched, 0);
+    CHECK_EQ(rx.dropped, 0);
+}
+
+// Task blocked longer than the ring lasts: lines are lost. The overflow
+// event is usually lost with them (the event queue is full too), so a line
+// may be spliced at the gap; the NMEA checksum must still reject it.
+static void test_stall_overruns(void) {
+    replay_cfg_t cfg = { .baud = 115200, .service_ms = 10, .stall_every_ms = 5000, .stall_ms = 250 };
+    replay_log(&cfg);
+
+    fake_uart_driver_stats_t st;
+    fake_uart_driver_get_stats(REPLAY_PORT, &st);
+    printf("  stalls: %u of %zu lines delivered, %u spliced, %u bytes lost\n",
+           s_delivered, s_expect_count, s_mismatched, st.lost_bytes);
+    CHECK(st.lost_bytes > 0);
+    CHECK(s_delivered < s_expect_count);
+    CHECK(s_delivered > s_expect_count * 9 / 10);
+    CHECK(s_mismatched <= 12);              // At most one per stall
+    CHECK_EQ(s_corrupt, 0);
+}
+
+// An overflow the task hears about: the cut line is dropped, the next is whole
+static void test_overflow_event_flushes(void) {
+    QueueHandle_t queue;
+    uart_driver_install(REPLAY_PORT, GPS_BUFFER_SIZE, 0, GPS_EVENT_QUEUE_SIZE, &queue, 0);
+    s_next = 0;
+    s_delivered = s_mismatched = s_corrupt = 0;
+    memset(&rx, 0, sizeof(rx));
+    rx.port = REPLAY_PORT;
+    rx.queue = queue;
+    rx.on_line = on_line;
+    gps_rx_start(&rx);
+
+    // A line and a half, then more than the ring holds
+    fake_uart_driver_rx(REPLAY_PORT, s_expect[0].ptr, s_expect[0].len + s_expect[1].len / 2);
+    fake_uart_driver_rx(REPLAY_PORT, s_expect[2].ptr, GPS_BUFFER_SIZE + 1);
+    fake_uart_driver_rx(REPLAY_PORT, s_expect[40].ptr, s_expect[40].len + s_expect[41].len);  // Ring still full
+
+    uart_event_t event;
+    while (xQueueReceive(queue, &event, 0) == pdTRUE) {
+        gps_rx_handle(&rx, &event);
+    }
+    fake_uart_driver_rx(REPLAY_PORT, s_expect[42].ptr, s_expect[42].len);
+    while (xQueueReceive(queue, &event, 0) == pdTRUE) {
+        gps_rx_handle(&rx, &event);
+    }
+
+    CHECK_EQ(rx.overruns, 1);
+    CHECK_EQ(rx.dropped, 2);                // The flush and the half line
+    CHECK_EQ(s_delivered, 2);               // Line 0 before, line 42 after
+    CHECK_EQ(s_next, 43);
+    CHECK_EQ(s_mismatched, 0);
+}
+
+static void test_garbage_and_long_lines(void) {
+    static char buf[8192];
+    size_t len = 0;
+    memcpy(buf, s_expect[0].ptr, s_expect[0].len);
+    len += s_expect[0].len;
+    for (int i = 0; i < 300; i++) {
+        buf[len++] = (char)(0x80 | (i & 0x3F));    // Noise, no '\n'
+    }
+    buf[len++] = '\n';
+    memcpy(buf + len, s_expect[1].ptr, s_expect[1].len);
+    len += s_expect[1].len;
+
+    s_next = 0;
+    s_delivered = s_mismatched = s_corrupt = 0;
+    replay_cfg_t cfg = { .baud = 115200 };
+    uart_replay(&rx, &cfg, (const uint8_t *)buf, len, on_line, NULL);
+    CHECK_EQ(s_delivered, 2);
+    CHECK_EQ(s_mismatched, 0);
+    CHECK_EQ(rx.dropped, 1);
+}
+
+static void test_binary_nav_pvt(void) {
+    size_t len;
+    char *ubx = test_read_file("nav_pvt_drive.ubx", &len);
+    ubx_parser_reset(&s_ubx);
+    s_frames = 0;
+
+    // Slow task: UART_DATA events are lost, the buffered bytes are not
+    replay_cfg_t cfg = { .baud = 115200, .service_ms = 50, .binary = true };
+    uart_replay(&rx, &cfg, (const uint8_t *)ubx, len, NULL, on_data);
+    CHECK_EQ(s_frames, 600);
+    CHECK_EQ(s_ubx.checksum_errors, 0);
+    CHECK_EQ(rx.dropped, 0);
+    free(ubx);
+}
+
+int main(void) {
+    s_log = test_read_file("nmea_drive.log", &s_log_len);
+    s_expect = test_split_lines(s_log, s_log_len, &s_expect_count);
+
+    RUN(test_keeps_up);
+    RUN(test_event_queue_overflow);
+    RUN(test_position_queue_overflow);
+    RUN(test_stall_overruns);
+    RUN(test_overflow_event_flushes);
+    RUN(test_garbage_and_long_lines);
+    RUN(test_binary_nav_pvt);
+    return TEST_RESULT();
+}
@@ -0,0 +1,171 @@
+/**
+ * OLED and DS3231 drivers against the SSD1306/DS3231 register models
+ * Syquens B.V. - 2026
+ */
+
+#include "ds3231.h"
+#include "oled.h"
+#include "fakes.h"
+#include "test.h"
+
+static fake_ssd1306_t panel;
+static hal_i2c_dev_t panel_dev;
+
+// Visible window of the panel RAM equals the frame buffer
+static bool panel_matches(void) {
+    const uint8_t *fb = oled_framebuffer();
+    for (int page = 0; page < OLED_PAGES; page++) {
+        if (memcmp(&panel.ram[page][OLED_X_OFFSET], &fb[page * DISPLAY_WIDTH], DISPLAY_WIDTH) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_oled_init_sequence(void) {
+    fake_ssd1306_init(&panel, &panel_dev);
+    oled_init(&panel_dev);
+    CHECK(panel.display_on);
+    CHECK_EQ(panel.addr_mode, 0);  // Horizontal addressing for windowed updates
+}
+
+static void test_oled_update_mirrors_framebuffer(void) {
+    fake_ssd1306_init(&panel, &panel_dev);
+    oled_init(&panel_dev);
+    oled_clear();
+    oled_draw_string(0, 0, "LAT 52.1");
+    oled_draw_string(3, 13, "LON 5.12");  // Not page aligned: spans two pages
+    oled_update();
+    CHECK(panel_matches());
+
+    // Nothing changed: no bus traffic
+    uint32_t before = panel.transactions;
+    oled_update();
+    CHECK_EQ(panel.transactions, before);
+
+    // One glyph changed: one page, only the changed columns
+    oled_draw_char(60, 32, '#');
+    uint32_t data_before = panel.data_bytes;
+    oled_update();
+    CHECK_EQ(panel.transactions, before + 1);
+    CHECK(panel.data_bytes - data_before <= 5);
+    CHECK(panel_matches());
+}
+
+// A page write that fails on the first frame is repainted on the next,
+// even though the frame buffer did not change
+static void test_oled_failed_page_repainted(void) {
+    fake_ssd1306_init(&panel, &panel_dev);
+    oled_init(&panel_dev);
+    memset(panel.ram, 0xA5, sizeof(panel.ram));     // Power-on garbage
+    oled_clear();
+    oled_draw_string(0, 0, "FIX 3D");
+
+    panel.fault.skip = 1;
+    panel.fault.fail = 1;                           // Page 1 write is lost
+    oled_update();
+    CHECK(!panel_matches());
+    oled_update();
+    CHECK(panel_matches());
+
+    uint32_t before = panel.transactions;
+    oled_update();
+    CHECK_EQ(panel.transactions, before);
+}
+
+static fake_ds3231_t rtc;
+static hal_i2c_dev_t rtc_dev;
+
+static void test_ds3231_time_round_trip(void) {
+    fake_ds3231_init(&rtc, &rtc_dev);
+    ds3231_init(&rtc_dev);
+
+    ds3231_time_t set = { 2026, 2, 28, 23, 59, 58 };
+    CHECK_EQ(ds3231_set_time(&set), ESP_OK);
+    CHECK_EQ(rtc.regs[0x00], 0x58);  // BCD seconds
+    CHECK_EQ(rtc.regs[0x03], 6);     // 2026-02-28 is a Saturday (1 = Monday)
+    CHECK_EQ(rtc.regs[0x06], 0x26);
+
+    ds3231_time_t got;
+    CHECK_EQ(ds3231_get_time(&got), ESP_OK);
+    CHECK_EQ(got.year, 2026);
+    CHECK_EQ(got.month, 2);
+    CHECK_EQ(got.day, 28);
+    CHECK_EQ(got.hour, 23);
+    CHECK_EQ(got.minute, 59);
+    CHECK_EQ(got.second, 58);
+}
+
+static void test_ds3231_bus_error(void) {
+    fake_ds3231_init(&rtc, &rtc_dev);
+    ds3231_init(&rtc_dev);
+
+    rtc.fault.fail = 1;
+    ds3231_time_t t;
+    CHECK(ds3231_get_time(&t) != ESP_OK);
+    CHECK(ds3231_set_time(&(ds3231_time_t){ 2026, 1, 1, 0, 0, 0 }) == ESP_OK);
+}
+
+// A failed status or control read is an error, never "oscillator OK" or
+// a control byte of 0x00
+static void test_ds3231_status_bus_error(void) {
+    fake_ds3231_init(&rtc, &rtc_dev);
+    ds3231_init(&rtc_dev);
+
+    bool stopped = false;
+    rtc.fault.fail = 1;
+    CHECK(ds3231_oscillator_stopped(&stopped) != ESP_OK);
+    CHECK_EQ(ds3231_oscillator_stopped(&stopped), ESP_OK);
+    CHECK(stopped);
+
+    // Time written, OSF read fails: reported, and the flag stays set
+    rtc.fault.skip = 1;
+    rtc.fault.fail = 1;
+    CHECK(ds3231_set_time(&(ds3231_time_t){ 2026, 1, 1, 0, 0, 0 }) != ESP_OK);
+    CHECK(rtc.regs[0x0F] & 0x80);
+    CHECK_EQ(ds3231_set_time(&(ds3231_time_t){ 2026, 1, 1, 0, 0, 0 }), ESP_OK);
+    CHECK_EQ(ds3231_oscillator_stopped(&stopped), ESP_OK);
+    CHECK(!stopped);
+
+    // Aging written, control read fails: control untouched, no conversion
+    rtc.fault.skip = 1;
+    rtc.fault.fail = 1;
+    CHECK(ds3231_set_aging_offset(-3) != ESP_OK);
+    CHECK_EQ(rtc.regs[0x0E], 0x1C);
+    CHECK_EQ(rtc.conversions, 0);
+}
+
+// CONV is only set once a running conversion has finished
+static void test_ds3231_aging_waits_for_bsy(void) {
+    fake_ds3231_init(&rtc, &rtc_dev);
+    ds3231_init(&rtc_dev);
+
+    CHECK_EQ(ds3231_set_aging_offset(5), ESP_OK);
+    CHECK_EQ(ds3231_set_aging_offset(-2), ESP_OK);     // First conversion still running
+    CHECK_EQ(rtc.conversions, 2);
+    CHECK_EQ(rtc.conv_while_busy, 0);
+    CHECK_EQ((int8_t)rtc.regs[0x10], -2);
+    CHECK_EQ(rtc.regs[0x0E] & 0x1C, 0x1C);              // INTCN and rate bits kept
+}
+
+static void test_ds3231_temperature(void) {
+    fake_ds3231_init(&rtc, &rtc_dev);
+    ds3231_init(&rtc_dev);
+    rtc.regs[0x11] = 0xE6;  // -25.75 C: two's complement MSB, quarter degrees in the LSB
+    rtc.regs[0x12] = 0x40;
+    float c = 0;
+    CHECK_EQ(ds3231_get_temperature(&c), ESP_OK);
+    CHECK(c == -25.75f);
+}
+
+int main(void) {
+    RUN(test_oled_init_sequence);
+    RUN(test_oled_update_mirrors_framebuffer);
+    RUN(test_oled_failed_page_repainted);
+    RUN(test_ds3231_time_round_trip);
+    RUN(test_ds3231_bus_error);
+    RUN(test_ds3231_status_bus_error);
+    RUN(test_ds3231_aging_waits_for_bsy);
+    RUN(test_ds3231_temperature);
+    return TEST_RESULT();
+}
@@ -0,0 +1,209 @@
+/**
+ * Streaming JSON extractor: captured geocoder responses fed whole, split
+ * at every offset and byte by byte; nested paths, arrays, escapes
+ * Syquens B.V. - 2026
+ */
+
+#include "json_extract.h"
+#include "test.h"
+
+// Same fields and buffer sizes as the geolocation lookup in main.c
+enum { F_ROAD, F_CITY, F_TOWN, F_VILLAGE, F_COUNTRY_CODE, F_COUNT };
+static char road[128], city[64], town[64], village[64], cc[16];
+static jx_field_t geo_fields[F_COUNT] = {
+    [F_ROAD]         = { "address.road", road, sizeof(road) },
+    [F_CITY]         = { "address.city", city, sizeof(city) },
+    [F_TOWN]         = { "address.town", town, sizeof(town) },
+    [F_VILLAGE]      = { "address.village", village, sizeof(village) },
+    [F_COUNTRY_CODE] = { "address.country_code", cc, sizeof(cc) },
+};
+static jx_parser_t jx;
+
+// Parse in two chunks split at 'at' (at == len: one chunk)
+static void parse_split(const char *doc, size_t len, size_t at) {
+    jx_init(&jx, geo_fields, F_COUNT);
+    jx_feed(&jx, doc, at);
+    jx_feed(&jx, doc + at, len - at);
+}
+
+static void check_utrecht(void) {
+    CHECK(jx_ok(&jx));
+    CHECK(geo_fields[F_ROAD].found);
+    CHECK_STR(road, "Oudegracht");
+    CHECK_STR(city, "Utrecht");
+    CHECK(!geo_fields[F_TOWN].found);
+    CHECK(!geo_fields[F_VILLAGE].found);
+    CHECK_STR(cc, "nl");
+}
+
+static void test_nominatim_every_split(void) {
+    size_t len;
+    char *doc = test_read_file("nominatim_utrecht.json", &len);
+
+    for (size_t at = 0; at <= len; at++) {
+        parse_split(doc, len, at);
+        check_utrecht();
+        if (test_failures) {
+            fprintf(stderr, "  split at %zu\n", at);
+            break;
+        }
+    }
+
+    // Byte by byte, as a slow TLS record stream would deliver it
+    jx_init(&jx, geo_fields, F_COUNT);
+    for (size_t i = 0; i < len; i++) {
+        jx_feed(&jx, doc + i, 1);
+    }
+    check_utrecht();
+    free(doc);
+}
+
+static void test_nominatim_village_utf8(void) {
+    size_t len;
+    char *doc = test_read_file("nominatim_village.json", &len);
+    for (size_t at = 0; at <= len; at += 7) {
+        parse_split(doc, len, at);
+        CHECK(jx_ok(&jx));
+        CHECK_STR(road, "Seestra\xc3\x9f" "e");
+        CHECK(!geo_fields[F_CITY].found);
+        CHECK_STR(village, "K\xc3\xb6rbecke");
+        CHECK_STR(cc, "de");
+    }
+    free(doc);
+}
+
+// BigDataCloud: flat fields, and name/isoCode repeated inside arrays
+static void test_bigdatacloud(void) {
+    char country[8], name[64], locality[64], iso[8];
+    jx_field_t fields[] = {
+        { "countryCode", country, sizeof(country) },
+        { "city", city, sizeof(city) },
+        { "locality", locality, sizeof(locality) },
+        { "localityInfo.administrative.name", name, sizeof(name) },
+        { "isoCode", iso, sizeof(iso) },
+    };
+    size_t len;
+    char *doc = test_read_file("bigdatacloud_utrecht.json", &len);
+
+    for (size_t at = 0; at <= len; at += 13) {
+        jx_init(&jx, fields, 5);
+        jx_feed(&jx, doc, at);
+        jx_feed(&jx, doc + at, len - at);
+        CHECK(jx_ok(&jx));
+        CHECK_STR(country, "NL");
+        CHECK_STR(city, "Utrecht");
+        CHECK_STR(locality, "Binnenstad");
+        CHECK(!fields[3].found);    // Inside an array: never matched
+        CHECK(!fields[4].found);    // Only nested isoCodes exist
+    }
+    free(doc);
+}
+
+static void test_nested_paths(void) {
+    static const char doc[] =
+        "{\"road\":\"top\",\"a\":{\"road\":\"one\",\"b\":{\"c\":{\"d\":-12.5e3,\"road\":\"three\"}},"
+        "\"list\":[{\"road\":\"in array\"},[1,2,{\"x\":1}]],\"t\":true,\"n\":null},\"z\":{}}";
+    char top[16], one[16], three[16], d[16], t[8], n[8], x[8];
+    jx_field_t fields[] = {
+        { "road", top, sizeof(top) },
+        { "a.road", one, sizeof(one) },
+        { "a.b.c.road", three, sizeof(three) },
+        { "a.b.c.d", d, sizeof(d) },
+        { "a.t", t, sizeof(t) },
+        { "a.n", n, sizeof(n) },
+        { "a.list.road", x, sizeof(x) },
+    };
+    size_t len = sizeof(doc) - 1;
+
+    for (size_t at = 0; at <= len; at++) {
+        jx_init(&jx, fields, 7);
+        jx_feed(&jx, doc, at);
+        jx_feed(&jx, doc + at, len - at);
+        CHECK(jx_ok(&jx));
+        CHECK_STR(top, "top");
+        CHECK_STR(one, "one");
+        CHECK_STR(three, "three");
+        CHECK_STR(d, "-12.5e3");
+        CHECK_STR(t, "true");
+        CHECK_STR(n, "null");
+        CHECK(!fields[6].found);
+    }
+}
+
+// Paths longer than JX_PATH_MAX stay capped however deep the nesting goes
+static void test_path_overflow(void) {
+    char doc[256];
+    char key[JX_KEY_MAX];
+    memset(key, 'a', JX_KEY_MAX - 1);
+    key[JX_KEY_MAX - 1] = 0;
+    int len = snprintf(doc, sizeof(doc),
+                       "{\"%s\":{\"%s\":{\"x\":{\"y\":{\"z\":1,\"road\":\"deep\"}}}},"
+                       "\"address\":{\"road\":\"after\"}}", key, key);
+
+    jx_init(&jx, geo_fields, F_COUNT);
+    size_t max_path = 0;
+    for (int i = 0; i < len; i++) {
+        jx_feed(&jx, doc + i, 1);
+        if (jx.path_len[jx.depth] > max_path) max_path = jx.path_len[jx.depth];
+    }
+    CHECK(jx_ok(&jx));
+    CHECK(max_path < JX_PATH_MAX);
+    CHECK_STR(road, "after");
+}
+
+static void test_escapes_split(void) {
+    // \u00f6, a surrogate pair (U+1F697) and simple escapes
+    static const char doc[] = "{\"address\":{\"road\":\"K\\u00f6ln \\ud83d\\ude97 \\\"A\\\\B\\/C\\\"\"}}";
+    size_t len = sizeof(doc) - 1;
+    for (size_t at = 0; at <= len; at++) {
+        parse_split(doc, len, at);
+        CHECK(jx_ok(&jx));
+        CHECK_STR(road, "K\xc3\xb6ln \xf0\x9f\x9a\x97 \"A\\B/C\"");
+    }
+}
+
+static void test_truncated_output(void) {
+    static const char doc[] = "{\"address\":{\"country_code\":\"this is longer than sixteen\"}}";
+    parse_split(doc, sizeof(doc) - 1, 20);
+    CHECK(jx_ok(&jx));
+    CHECK(geo_fields[F_COUNTRY_CODE].found);
+    CHECK_STR(cc, "this is longer ");
+}
+
+static void test_malformed(void) {
+    static const char *bad[] = {
+        "{\"address\" \"road\"}",
+        "{\"address\":{\"road\":\"x\"}}}",
+        "{\"a\":\"\\u00zz\"}",
+        "{\"a\":1 2}",
+        "{1:2}",
+        "[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]",    // Deeper than JX_MAX_DEPTH
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        jx_init(&jx, geo_fields, F_COUNT);
+        jx_feed(&jx, bad[i], strlen(bad[i]));
+        if (jx_ok(&jx)) {
+            fprintf(stderr, "  accepted: %s\n", bad[i]);
+            CHECK(!jx_ok(&jx));
+        }
+    }
+
+    // jx_reset clears the previous document's results
+    parse_split("{\"address\":{\"road\":\"x\"}}", 24, 24);
+    CHECK(geo_fields[F_ROAD].found);
+    jx_reset(&jx);
+    CHECK(!geo_fields[F_ROAD].found);
+    CHECK_STR(road, "");
+}
+
+int main(void) {
+    RUN(test_nominatim_every_split);
+    RUN(test_nominatim_village_utf8);
+    RUN(test_bigdatacloud);
+    RUN(test_nested_paths);
+    RUN(test_path_overflow);
+    RUN(test_escapes_split);
+    RUN(test_truncated_output);
+    RUN(test_malformed);
+    return TEST_RESULT();
+}
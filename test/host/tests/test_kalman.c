@@ -0,0 +1,107 @@
+/**
+ * Position filter: replay of the recorded drive, scored against the
+ * noise-free track it was generated from
+ * Syquens B.V. - 2026
+ */
+
+#include "config.h"
+#include "kalman.h"
+#include "drive.h"
+#include "test.h"
+
+#define OUTAGE_START    300     // Epochs without a fix: tunnel
+#define OUTAGE_LEN      10
+#define SETTLE          5       // Epochs before scoring starts
+
+typedef struct {
+    double raw_rms, est_rms;
+    double outage_max;          // Worst dead-reckoning error
+    double sigma_at_outage_end;
+    int dr_epochs;
+} replay_result_t;
+
+static replay_result_t replay(int outage_start, int outage_len) {
+    int n = drive_load(), n_truth;
+    drive_truth_t *truth = drive_truth_load(&n_truth);
+    CHECK_EQ(n_truth, n);
+
+    kf_context_t kf;
+    kf_init(&kf);
+    replay_result_t res = {0};
+    double raw_sq = 0, est_sq = 0;
+    int scored = 0;
+
+    for (int i = 0; i < n; i++) {
+        const track_record_t *r = &drive_recs[i];
+        int64_t now_us = (int64_t)(r->time - drive_recs[0].time) * 1000000 + r->millis * 1000;
+        bool outage = i >= outage_start && i < outage_start + outage_len;
+
+        if (outage) {
+            kf_predict(&kf, now_us);
+        } else {
+            float course = drive_course[i] >= 0 ? drive_course[i] : 0;
+            kf_update(&kf, now_us, r->lat_e7, r->lon_e7, r->hdop_c / 100.0f,
+                      r->speed_ckn / 100.0f * 0.514444f, course);
+        }
+
+        kf_output_t est;
+        kf_get_output(&kf, &est);
+        double est_err = drive_error_m(est.lat_e7, est.lon_e7, &truth[i]);
+        if (outage) {
+            res.dr_epochs += est.state == KF_STATE_DEAD_RECKONING;
+            if (est_err > res.outage_max) res.outage_max = est_err;
+            res.sigma_at_outage_end = est.sigma_m;
+        } else if (i >= SETTLE) {
+            double raw_err = drive_error_m(r->lat_e7, r->lon_e7, &truth[i]);
+            raw_sq += raw_err * raw_err;
+            est_sq += est_err * est_err;
+            scored++;
+        }
+    }
+    res.raw_rms = sqrt(raw_sq / scored);
+    res.est_rms = sqrt(est_sq / scored);
+    free(truth);
+    return res;
+}
+
+static void test_replay_rms(void) {
+    replay_result_t res = replay(OUTAGE_START, OUTAGE_LEN);
+    printf("  RMS error: raw %.2f m, filtered %.2f m; dead reckoning max %.2f m (sigma %.1f m)\n",
+           res.raw_rms, res.est_rms, res.outage_max, res.sigma_at_outage_end);
+
+    CHECK(res.est_rms < res.raw_rms);
+    CHECK(res.est_rms < 2.2);
+    // A 10 s tunnel at up to 80 km/h stays within a few metres on a gentle bend
+    CHECK_EQ(res.dr_epochs, OUTAGE_LEN);
+    CHECK(res.outage_max < 10);
+    CHECK(res.sigma_at_outage_end > res.outage_max / 3);
+}
+
+static void test_dead_reckoning_expires(void) {
+    kf_context_t kf;
+    kf_init(&kf);
+    kf_output_t out;
+
+    kf_predict(&kf, 0);
+    kf_get_output(&kf, &out);
+    CHECK_EQ(out.state, KF_STATE_NONE);     // Nothing to predict from
+
+    for (int i = 0; i < 5; i++) {
+        kf_update(&kf, i * 1000000LL, 520907000 + i * 1000, 51214000, 0.9f, 10.0f, 0);
+    }
+    kf_predict(&kf, 6000000);
+    kf_get_output(&kf, &out);
+    CHECK_EQ(out.state, KF_STATE_DEAD_RECKONING);
+    // Heading north at 10 m/s, about 0.9 e-4 deg per second
+    CHECK(out.lat_e7 > 520907000 + 4 * 1000);
+
+    kf_predict(&kf, 6000000 + (int64_t)KF_DR_MAX_MS * 1000);
+    kf_get_output(&kf, &out);
+    CHECK_EQ(out.state, KF_STATE_NONE);
+}
+
+int main(void) {
+    RUN(test_replay_rms);
+    RUN(test_dead_reckoning_expires);
+    return TEST_RESULT();
+}
@@ -0,0 +1,168 @@
+/**
+ * NMEA tokenizer: accept/reject table, field conversions, recorded drive
+ * Syquens B.V. - 2026
+ */
+
+#include "nmea.h"
+#include "test.h"
+
+static int s_handled;
+
+static void count_handler(const nmea_sentence_t *s) {
+    s_handled++;
+}
+
+static const nmea_handler_t s_table[] = {
+    { NMEA_TYPE('R', 'M', 'C'), count_handler },
+    { NMEA_TYPE('G', 'G', 'A'), count_handler },
+    { NMEA_TYPE('G', 'S', 'A'), count_handler },
+    { NMEA_TYPE('G', 'S', 'V'), count_handler },
+};
+
+#define TABLE_LEN (sizeof(s_table) / sizeof(s_table[0]))
+
+static const struct {
+    const char *what;
+    const char *line;
+    nmea_result_t result;
+    uint8_t fields;         // Expected field count when the line tokenizes
+} s_cases[] = {
+    { "good RMC",            "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A", NMEA_OK, 12 },
+    { "good GGA, CRLF",      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n", NMEA_OK, 15 },
+    { "no fix, empty fields", "$GNGGA,,,,,,0,00,99.99,,,,,,*56", NMEA_OK, 15 },
+    { "lower-case checksum", "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6a", NMEA_OK, 12 },
+    { "BeiDou talker",       "$BDGSA,A,1,,,,,,,,,,,,,99.99,99.99,99.99*21", NMEA_OK, 18 },
+    { "GLONASS, no sats",    "$GLGSV,1,1,00*65", NMEA_OK, 4 },
+    { "wrong checksum",      "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6B", NMEA_ERR_CHECKSUM, 12 },
+    { "corrupted body",      "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230395,003.1,W*6A", NMEA_ERR_CHECKSUM, 12 },
+    { "non-hex checksum",    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*4G", NMEA_ERR_CHECKSUM, 15 },
+    { "truncated in body",   "$GPRMC,123519,A,4807.0", NMEA_ERR_CHECKSUM, 4 },
+    { "truncated checksum",  "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*4", NMEA_ERR_CHECKSUM, 15 },
+    { "no checksum",         "$GPGLL,4916.45,N,12311.12,W,225444,A\r\n", NMEA_ERR_CHECKSUM, 7 },
+    { "proprietary PUBX",    "$PUBX,00,101500.00,5205.44271,N*62", NMEA_ERR_TALKER, 5 },
+    { "unknown talker QZ",   "$QZRMC,101500.00,V,,,,,,,160126,,,N*66", NMEA_ERR_TALKER, 13 },
+    { "unhandled ZDA",       "$GPZDA,101500.00,16,01,2026,00,00*63", NMEA_ERR_UNKNOWN_TYPE, 7 },
+    { "unhandled TXT",       "$GNTXT,01,01,02,u-blox AG - www.u-blox.com*4E", NMEA_ERR_UNKNOWN_TYPE, 5 },
+    { "missing '$'",         "GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A", NMEA_ERR_MALFORMED, 0 },
+    { "empty line",          "", NMEA_ERR_MALFORMED, 0 },
+    { "binary noise",        "\xb5\x62\x01\x07\x5c\x00", NMEA_ERR_MALFORMED, 0 },
+};
+
+static void test_dispatch_table(void) {
+    for (size_t i = 0; i < sizeof(s_cases) / sizeof(s_cases[0]); i++) {
+        const char *line = s_cases[i].line;
+        size_t len = strlen(line);
+        test_current = s_cases[i].what;
+
+        s_handled = 0;
+        nmea_stats_t stats = {0};
+        CHECK_EQ(nmea_dispatch(line, len, s_table, TABLE_LEN, &stats), s_cases[i].result);
+        CHECK_EQ(s_handled, s_cases[i].result == NMEA_OK);
+        CHECK_EQ(stats.accepted + stats.malformed + stats.checksum_errors +
+                 stats.unknown_talker + stats.unknown_type, 1);
+
+        nmea_sentence_t s;
+        if (nmea_tokenize(line, len, &s)) {
+            CHECK_EQ(s.count, s_cases[i].fields);
+        } else {
+            CHECK_EQ(s_cases[i].fields, 0);
+        }
+    }
+}
+
+static void test_field_views(void) {
+    const char *line = "$GNGGA,,,,,,0,00,99.99,,,,,,*56";
+    nmea_sentence_t s;
+    CHECK(nmea_tokenize(line, strlen(line), &s));
+    CHECK_EQ(s.talker, NMEA_TALKER_GN);
+    CHECK_EQ(s.fields[0].len, 5);
+    CHECK_EQ(s.fields[1].len, 0);           // Empty fields keep their index
+    CHECK_EQ(nmea_field_char(&s.fields[6]), '0');
+    CHECK_EQ(s.fields[8].len, 5);
+    CHECK(s.fields[8].ptr == line + 17);    // Views into the line, no copy
+}
+
+static nmea_field_t field(const char *text) {
+    return (nmea_field_t){ text, (uint8_t)strlen(text) };
+}
+
+static void test_conversions(void) {
+    int32_t v;
+    nmea_field_t n = field("N"), s = field("S"), e = field("E"), w = field("W");
+
+    CHECK(nmea_parse_coord(&(nmea_field_t){ "4807.038", 8 }, &n, &v));
+    CHECK_EQ(v, 481173000);
+    CHECK(nmea_parse_coord(&(nmea_field_t){ "01131.000", 9 }, &e, &v));
+    CHECK_EQ(v, 115166667);
+    CHECK(nmea_parse_coord(&(nmea_field_t){ "3356.12345", 10 }, &s, &v));
+    CHECK_EQ(v, -339353908);
+    CHECK(nmea_parse_coord(&(nmea_field_t){ "17959.99999", 11 }, &w, &v));
+    CHECK_EQ(v, -1799999998);
+    CHECK(!nmea_parse_coord(&(nmea_field_t){ "48", 2 }, &n, &v));
+    CHECK(!nmea_parse_coord(&(nmea_field_t){ "4807.0x8", 8 }, &n, &v));
+
+    nmea_field_t f = field("545.4");
+    CHECK(nmea_parse_fixed(&f, 1, &v));
+    CHECK_EQ(v, 5454);
+    f = field("-12.345");
+    CHECK(nmea_parse_fixed(&f, 2, &v));
+    CHECK_EQ(v, -1234);
+    f = field("022");
+    CHECK(nmea_parse_fixed(&f, 3, &v));
+    CHECK_EQ(v, 22000);
+    f = field(".");
+    CHECK(!nmea_parse_fixed(&f, 1, &v));
+    f = field("1.2.3");
+    CHECK(!nmea_parse_fixed(&f, 1, &v));
+
+    uint32_t u;
+    f = field("08");
+    CHECK(nmea_parse_uint(&f, &u));
+    CHECK_EQ(u, 8);
+    f = field("");
+    CHECK(!nmea_parse_uint(&f, &u));
+
+    int h, m, sec, ms;
+    f = field("101500.25");
+    CHECK(nmea_parse_time(&f, &h, &m, &sec, &ms));
+    CHECK_EQ(h * 10000 + m * 100 + sec, 101500);
+    CHECK_EQ(ms, 250);
+    f = field("1015");
+    CHECK(!nmea_parse_time(&f, &h, &m, &sec, &ms));
+
+    int day, month, year;
+    f = field("160126");
+    CHECK(nmea_parse_date(&f, &day, &month, &year));
+    CHECK_EQ(day, 16);
+    CHECK_EQ(month, 1);
+    CHECK_EQ(year, 2026);
+}
+
+// Every sentence of the drive is well formed; VTG and GLL have no handler
+static void test_recorded_drive(void) {
+    size_t len, count;
+    char *buf = test_read_file("nmea_drive.log", &len);
+    test_line_t *lines = test_split_lines(buf, len, &count);
+
+    s_handled = 0;
+    nmea_stats_t stats = {0};
+    for (size_t i = 0; i < count; i++) {
+        nmea_dispatch(lines[i].ptr, lines[i].len, s_table, TABLE_LEN, &stats);
+    }
+    CHECK_EQ(count, 4800);
+    CHECK_EQ(stats.accepted, 3600);
+    CHECK_EQ(stats.unknown_type, 1200);
+    CHECK_EQ(stats.checksum_errors + stats.malformed + stats.unknown_talker, 0);
+    CHECK_EQ(s_handled, stats.accepted);
+
+    free(lines);
+    free(buf);
+}
+
+int main(void) {
+    RUN(test_dispatch_table);
+    RUN(test_field_views);
+    RUN(test_conversions);
+    RUN(test_recorded_drive);
+    return TEST_RESULT();
+}
@@ -0,0 +1,124 @@
+/**
+ * NTP server on loopback: header fields per reference state, echoed
+ * version/poll/origin, timestamp ordering, rejected packets and a burst
+ * of back-to-back requests
+ * Syquens B.V. - 2026
+ */
+
+#include "ntp_server.h"
+#include "ntp_client.h"
+#include "test.h"
+
+static int s_sock;
+
+static int64_t now_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static bool exchange(uint8_t version, ntp_reply_t *reply) {
+    return ntp_client_send(s_sock, version, 6, 0x0123456789ABCDEFULL) && ntp_client_recv(s_sock, reply);
+}
+
+// Before any source: LI=3 and stratum 16, never stratum 0 (Kiss-o'-Death)
+static void test_unsynchronized(void) {
+    ntp_reply_t r = {0};
+    CHECK(exchange(4, &r));
+    CHECK_EQ(r.li, 3);
+    CHECK_EQ(r.stratum, 16);
+    CHECK_EQ(r.refid, NTP_REFID_NONE);
+    CHECK_EQ(r.mode, 4);
+}
+
+static void test_gps_reference(void) {
+    struct timeval ref;
+    gettimeofday(&ref, NULL);
+    ntp_server_set_reference(NTP_STRATUM_GPS, NTP_REFID('P', 'P', 'S', 0), &ref, 1000);
+
+    ntp_reply_t r = {0};
+    CHECK(exchange(4, &r));
+    CHECK_EQ(r.li, 0);
+    CHECK_EQ(r.stratum, 1);
+    CHECK_EQ(r.refid, NTP_REFID('P', 'P', 'S', 0));
+    CHECK_EQ(r.root_dispersion, 65);        // 1 ms in 16.16 seconds
+}
+
+static void test_echoes_request(void) {
+    ntp_reply_t r = {0};
+    CHECK(ntp_client_send(s_sock, 3, 10, 0xDEADBEEF00C0FFEEULL));
+    CHECK(ntp_client_recv(s_sock, &r));
+    CHECK_EQ(r.version, 3);
+    CHECK_EQ(r.poll, 10);
+    CHECK(r.origin == 0xDEADBEEF00C0FFEEULL);
+}
+
+// Receive before transmit, both inside the client's round trip
+static void test_timestamps(void) {
+    for (int i = 0; i < 50; i++) {
+        int64_t t1 = now_us();
+        ntp_reply_t r = {0};
+        CHECK(exchange(4, &r));
+        int64_t t4 = now_us();
+        int64_t t2 = ntp_client_ts_us(r.receive), t3 = ntp_client_ts_us(r.transmit);
+        CHECK(t2 <= t3);
+        CHECK(t2 >= t1 - 1);                // Fraction rounding
+        CHECK(t3 <= t4 + 1);
+    }
+}
+
+static void test_rejects(void) {
+    ntp_server_stats_t before, after;
+    ntp_server_get_stats(&before);
+
+    uint8_t short_pkt[20] = { (4 << 3) | 3 };
+    uint8_t server_pkt[NTP_CLIENT_PACKET_SIZE] = { (4 << 3) | 4 };
+    send(s_sock, short_pkt, sizeof(short_pkt), 0);
+    send(s_sock, server_pkt, sizeof(server_pkt), 0);
+
+    // A valid request behind them proves both were consumed unanswered
+    ntp_reply_t r = {0};
+    CHECK(exchange(4, &r));
+    CHECK(r.origin == 0x0123456789ABCDEFULL);
+    ntp_server_get_stats(&after);
+    CHECK_EQ(after.rejected - before.rejected, 2);
+    CHECK_EQ(after.requests - before.requests, 1);
+}
+
+// Fleet polling at once: every request answered, in order
+static void test_burst(void) {
+    enum { BURST = 200 };
+    ntp_server_stats_t before, after;
+    ntp_server_get_stats(&before);
+    for (uint64_t i = 0; i < BURST; i++) {
+        CHECK(ntp_client_send(s_sock, 4, 6, i));
+    }
+    int answered = 0;
+    ntp_reply_t r = {0};
+    while (answered < BURST && ntp_client_recv(s_sock, &r)) {
+        CHECK(r.origin == (uint64_t)answered);
+        answered++;
+    }
+    // responses is counted after sendto(), so it may trail the last reply
+    ntp_server_get_stats(&after);
+    CHECK_EQ(answered, BURST);
+    CHECK_EQ(after.requests - before.requests, BURST);
+    CHECK_EQ(after.send_errors, before.send_errors);
+}
+
+int main(void) {
+    if (ntp_server_start() != ESP_OK) {
+        fprintf(stderr, "cannot bind UDP %d\n", NTP_SERVER_PORT);
+        return EXIT_FAILURE;
+    }
+    s_sock = ntp_client_open(1000);
+
+    RUN(test_unsynchronized);
+    RUN(test_gps_reference);
+    RUN(test_echoes_request);
+    RUN(test_timestamps);
+    RUN(test_rejects);
+    RUN(test_burst);
+    close(s_sock);
+    return TEST_RESULT();
+}
@@ -0,0 +1,118 @@
+/**
+ * NVS budget: the nvs partition in partitions.csv must hold the device
+ * config, the WiFi driver's records, the geocache table and a full outbox
+ * spill ring of the largest messages, and still have room for NVS to
+ * write each of them again (a new value is written before the old one is
+ * erased).
+ * Syquens B.V. - 2026
+ */
+
+#include "config.h"
+#include "geocache.h"
+#include "outbox.h"
+#include "nvs.h"
+#include "fakes.h"
+#include "test.h"
+
+#define WIFI_NVS_ALLOWANCE  4096    // nvs.net80211: station config, calibration; generous
+
+static esp_err_t set_str_len(nvs_handle_t nvs, const char *key, size_t len) {
+    char value[128];
+    memset(value, 'x', len);
+    value[len] = '\0';
+    return nvs_set_str(nvs, key, value);
+}
+
+// What serial_save_settings() in main.c writes, at the longest values, plus the credentials
+static void write_config(void) {
+    nvs_handle_t nvs;
+    CHECK_EQ(nvs_open("config", NVS_READWRITE, &nvs), ESP_OK);
+    CHECK_EQ(set_str_len(nvs, NVS_WIFI_SSID, 31), ESP_OK);
+    CHECK_EQ(set_str_len(nvs, NVS_WIFI_PASS, 63), ESP_OK);
+    CHECK_EQ(set_str_len(nvs, NVS_MQTT_BROKER, 127), ESP_OK);
+    CHECK_EQ(set_str_len(nvs, NVS_MQTT_USER, 63), ESP_OK);
+    CHECK_EQ(set_str_len(nvs, NVS_MQTT_PASS, 63), ESP_OK);
+    CHECK_EQ(set_str_len(nvs, NVS_DEVICE_ID, 31), ESP_OK);
+    CHECK_EQ(nvs_set_u8(nvs, "rtc_sync_src", 1), ESP_OK);
+    CHECK_EQ(nvs_set_u8(nvs, "gps_debug", 0), ESP_OK);
+    CHECK_EQ(nvs_set_u16(nvs, "trk_min_dist", 25), ESP_OK);
+    CHECK_EQ(nvs_set_u16(nvs, "trk_max_dev", 10), ESP_OK);
+    CHECK_EQ(nvs_set_u16(nvs, "trk_heading", 30), ESP_OK);
+    CHECK_EQ(nvs_set_u16(nvs, "trk_max_int", 300), ESP_OK);
+    CHECK_EQ(nvs_set_u8(nvs, "trk_window", 8), ESP_OK);
+    nvs_close(nvs);
+
+    static uint8_t wifi[WIFI_NVS_ALLOWANCE];
+    CHECK_EQ(nvs_open("nvs.net80211", NVS_READWRITE, &nvs), ESP_OK);
+    CHECK_EQ(nvs_set_blob(nvs, "sta.apinfo", wifi, sizeof(wifi)), ESP_OK);
+    nvs_close(nvs);
+}
+
+// Every cell filled, then written back
+static void persist_geocache(void) {
+    for (int i = 0; i < GEOCACHE_SIZE; i++) {
+        geocache_store(geocache_cell_key(520000000 + i * GEOCACHE_CELL_E7, 50000000),
+                       "Straatweg", "Utrecht", "nl");
+    }
+    fake_ticks_advance(GEOCACHE_PERSIST_MS);
+    geocache_persist();
+}
+
+static int s_refused;
+
+static int refuse(void *ctx, const char *topic, const void *data, size_t len, int qos) {
+    s_refused++;
+    return -1;
+}
+
+#define POOL_MSGS   (OUTBOX_SLOTS / (OUTBOX_MSG_MAX / OUTBOX_SLOT_SIZE))
+#define FILL_MSGS   (POOL_MSGS + OUTBOX_SPILL_SLOTS + 2)
+
+// Link down long enough to fill the pool and wrap the spill ring
+static void fill_spill_ring(int topic) {
+    static uint8_t msg[OUTBOX_MSG_MAX];
+    for (int i = 0; i < FILL_MSGS; i++) {
+        memset(msg, i, sizeof(msg));
+        CHECK(outbox_put(topic, msg, sizeof(msg)));
+    }
+}
+
+static void test_everything_fits(void) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s", test_tmp_path("nvs_capacity.bin"));
+    fake_nvs_init(path, NVS_PARTITION_SIZE);
+    geocache_init();
+    outbox_transport_t transport = {.publish = refuse};
+    CHECK_EQ(outbox_init(&transport), ESP_OK);
+    int topic = outbox_add_topic("camper/test/track", 1, OUTBOX_DROP_OLDEST);
+
+    write_config();
+    persist_geocache();
+    fill_spill_ring(topic);
+    persist_geocache();
+    fill_spill_ring(topic);
+    write_config();
+
+    outbox_stats_t ob;
+    outbox_get_stats(&ob);
+    fake_nvs_stats_t nvs;
+    fake_nvs_get_stats(&nvs);
+    printf("  nvs: %u of %u entries used, %u writes\n", nvs.entries_used, nvs.entries_total, nvs.writes);
+    CHECK_EQ(nvs.no_space, 0);
+    CHECK_EQ(ob.spill_depth, OUTBOX_SPILL_SLOTS);
+    CHECK_EQ(ob.spilled, 2 * FILL_MSGS - POOL_MSGS);
+    CHECK_EQ(ob.dropped, 2 * FILL_MSGS - POOL_MSGS - OUTBOX_SPILL_SLOTS);   // Ring overwrites only
+    CHECK_EQ(s_refused, 0);
+
+    // The table comes back after a reboot
+    fake_nvs_init(path, NVS_PARTITION_SIZE);
+    geocache_init();
+    geocache_stats_t geo;
+    geocache_get_stats(&geo);
+    CHECK_EQ(geo.entries, GEOCACHE_SIZE);
+}
+
+int main(void) {
+    RUN(test_everything_fits);
+    return TEST_RESULT();
+}
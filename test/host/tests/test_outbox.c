@@ -0,0 +1,264 @@
+/**
+ * MQTT outbox against the fake esp-mqtt client and broker: the client owns
+ * retransmission of in-flight messages; the outbox takes them back only on
+ * a disconnect or MQTT_EVENT_DELETED, and backs off after a refusal.
+ * Messages larger than a slot take a run of slots.
+ * Each test leaves the outbox empty for the next one.
+ * Syquens B.V. - 2026
+ */
+
+#include "config.h"
+#include "outbox.h"
+#include "fakes.h"
+#include "test.h"
+
+static fake_mqtt_t s_mqtt;
+static uint32_t s_now;
+static int s_track;
+static int s_gps;
+static int s_status;
+static uint32_t s_msg;
+
+// Client and outbox side by side on a 10 ms simulated tick
+static void run(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 10) {
+        s_now += 10;
+        fake_mqtt_step(&s_mqtt, s_now);
+        outbox_service(s_now, s_mqtt.connected);
+    }
+}
+
+static void put(int topic) {
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "message %u", s_msg++);
+    CHECK(outbox_put(topic, buf, n));
+}
+
+static outbox_stats_t stats(void) {
+    outbox_stats_t st;
+    outbox_get_stats(&st);
+    return st;
+}
+
+static void reset_link(void) {
+    fake_mqtt_init(&s_mqtt);
+    s_mqtt.on_published = outbox_acked;
+    s_mqtt.on_deleted = outbox_failed;
+    s_mqtt.clean_session = true;
+}
+
+// PUBACKs slower than any old ack timeout: the outbox hands each message
+// over once and leaves the resends to the client
+static void test_slow_broker_no_republish(void) {
+    reset_link();
+    s_mqtt.ack_delay_ms = 20000;
+    s_mqtt.expire_ms = 60000;
+    outbox_stats_t before = stats();
+
+    for (int i = 0; i < OUTBOX_MAX_INFLIGHT; i++) put(s_track);
+    run(25000);
+
+    outbox_stats_t after = stats();
+    CHECK_EQ(s_mqtt.publishes, OUTBOX_MAX_INFLIGHT);
+    CHECK(s_mqtt.client_resends > 0);
+    CHECK_EQ(after.delivered - before.delivered, OUTBOX_MAX_INFLIGHT);
+    CHECK_EQ(after.retries, before.retries);
+    CHECK_EQ(after.depth, 0);
+}
+
+// Link drops with messages in flight: they go back to READY and are sent
+// again after the reconnect (the clean session lost the client's copies)
+static void test_disconnect_releases_inflight(void) {
+    reset_link();
+    s_mqtt.ack_delay_ms = 5000;
+    outbox_stats_t before = stats();
+
+    for (int i = 0; i < OUTBOX_MAX_INFLIGHT; i++) put(s_track);
+    run(100);
+    CHECK_EQ(stats().inflight, OUTBOX_MAX_INFLIGHT);
+
+    fake_mqtt_set_connected(&s_mqtt, false);
+    run(10);
+    outbox_stats_t down = stats();
+    CHECK_EQ(down.inflight, 0);
+    CHECK_EQ(down.depth, OUTBOX_MAX_INFLIGHT);
+    CHECK_EQ(down.retries - before.retries, OUTBOX_MAX_INFLIGHT);
+
+    run(3000);
+    CHECK_EQ(s_mqtt.publishes, OUTBOX_MAX_INFLIGHT);    // Nothing while down
+
+    fake_mqtt_set_connected(&s_mqtt, true);
+    run(6000);
+    outbox_stats_t after = stats();
+    CHECK_EQ(s_mqtt.publishes, 2 * OUTBOX_MAX_INFLIGHT);
+    CHECK_EQ(after.delivered - before.delivered, OUTBOX_MAX_INFLIGHT);
+    CHECK_EQ(s_mqtt.unique, OUTBOX_MAX_INFLIGHT);
+    CHECK_EQ(after.depth, 0);
+}
+
+// The client gives up on a message (MQTT_EVENT_DELETED): queued again,
+// after a backoff
+static void test_deleted_requeues_with_backoff(void) {
+    reset_link();
+    s_mqtt.stalled = true;
+    s_mqtt.expire_ms = 30000;
+    outbox_stats_t before = stats();
+
+    put(s_track);
+    put(s_track);
+    run(30010);
+    outbox_stats_t failed = stats();
+    CHECK_EQ(s_mqtt.expired, 2);
+    CHECK_EQ(failed.inflight, 0);
+    CHECK_EQ(failed.depth, 2);
+    CHECK_EQ(failed.retries - before.retries, 2);
+
+    run(OUTBOX_RETRY_MIN_MS - 100);
+    CHECK_EQ(s_mqtt.publishes, 2);                      // Still backing off
+
+    s_mqtt.stalled = false;
+    run(1000);
+    outbox_stats_t after = stats();
+    CHECK_EQ(s_mqtt.publishes, 4);
+    CHECK_EQ(after.delivered - before.delivered, 2);
+    CHECK_EQ(after.depth, 0);
+}
+
+// Released while a newer position waits: the old one is dropped
+static void test_release_drops_superseded(void) {
+    reset_link();
+    s_mqtt.ack_delay_ms = 5000;
+    outbox_stats_t before = stats();
+
+    put(s_gps);
+    run(20);
+    CHECK_EQ(stats().inflight, 1);
+
+    fake_mqtt_set_connected(&s_mqtt, false);
+    put(s_gps);
+    run(10);
+    outbox_stats_t down = stats();
+    CHECK_EQ(down.depth, 1);
+    CHECK_EQ(down.coalesced - before.coalesced, 1);
+    CHECK_EQ(down.retries, before.retries);
+
+    fake_mqtt_set_connected(&s_mqtt, true);
+    run(6000);
+    outbox_stats_t after = stats();
+    CHECK_EQ(s_mqtt.publishes, 2);
+    CHECK_EQ(after.delivered - before.delivered, 1);
+    CHECK_EQ(after.depth, 0);
+}
+
+// A refused publish keeps its backoff, also across a reconnect
+static void test_refused_keeps_backoff(void) {
+    reset_link();
+    s_mqtt.limit = 4;                                   // Smaller than any message
+    outbox_stats_t before = stats();
+
+    put(s_track);
+    run(10);
+    CHECK_EQ(s_mqtt.publishes, 1);
+    CHECK_EQ(stats().retries - before.retries, 1);
+
+    fake_mqtt_set_connected(&s_mqtt, false);
+    run(100);
+    fake_mqtt_set_connected(&s_mqtt, true);
+    s_mqtt.limit = 8192;
+    run(OUTBOX_RETRY_MIN_MS - 300);
+    CHECK_EQ(s_mqtt.publishes, 1);
+
+    run(1000);
+    outbox_stats_t after = stats();
+    CHECK_EQ(s_mqtt.publishes, 2);
+    CHECK_EQ(after.delivered - before.delivered, 1);
+    CHECK_EQ(after.retries - before.retries, 1);
+    CHECK_EQ(after.depth, 0);
+}
+
+// A message larger than a slot: the oldest queued messages are spilled
+// until a run of slots is free, and commit hands back the unused tail
+static void test_large_message_spans(void) {
+    reset_link();
+    fake_mqtt_set_connected(&s_mqtt, false);
+    outbox_stats_t before = stats();
+
+    for (int i = 0; i < OUTBOX_SLOTS; i++) put(s_track);
+    CHECK_EQ(outbox_free_slots(), 0);
+
+    size_t size;
+    char *buf = outbox_reserve(s_status, OUTBOX_MSG_MAX, &size);
+    CHECK(buf != NULL);
+    CHECK_EQ(size, OUTBOX_MSG_MAX);
+    CHECK_EQ(stats().spilled - before.spilled, OUTBOX_MSG_MAX / OUTBOX_SLOT_SIZE);
+    memset(buf, '{', 2 * OUTBOX_SLOT_SIZE - 10);
+    CHECK(outbox_commit(buf, 2 * OUTBOX_SLOT_SIZE - 10));
+    CHECK_EQ(outbox_free_slots(), OUTBOX_MSG_MAX / OUTBOX_SLOT_SIZE - 2);
+
+    outbox_stats_t queued = stats();
+    CHECK_EQ(queued.depth, OUTBOX_SLOTS - OUTBOX_MSG_MAX / OUTBOX_SLOT_SIZE + 1);
+    CHECK_EQ(queued.spill_depth, OUTBOX_MSG_MAX / OUTBOX_SLOT_SIZE);
+
+    // Too large for the pool, and a reservation released unused
+    CHECK(outbox_reserve(s_status, OUTBOX_MSG_MAX + 1, &size) == NULL);
+    buf = outbox_reserve(s_track, 10, &size);
+    CHECK_EQ(size, OUTBOX_SLOT_SIZE);
+    CHECK(!outbox_commit(buf, 0));
+
+    fake_mqtt_set_connected(&s_mqtt, true);
+    run(5000);
+    outbox_stats_t after = stats();
+    CHECK_EQ(s_mqtt.unique, OUTBOX_SLOTS + 1);
+    CHECK_EQ(s_mqtt.duplicates, 0);
+    CHECK_EQ(after.delivered - before.delivered, OUTBOX_SLOTS + 1);
+    CHECK_EQ(after.depth, 0);
+    CHECK_EQ(after.spill_depth, 0);
+}
+
+// In-flight messages split the pool: no run can be made for a large
+// message, so the reservation fails without spilling the unsent ones
+static void test_large_message_no_room(void) {
+    reset_link();
+    s_mqtt.ack_delay_ms = 100000;
+    s_mqtt.expire_ms = 200000;
+
+    for (int i = 0; i < OUTBOX_SLOTS; i++) put(s_track);
+    run(10);
+    outbox_acked(s_mqtt.pending[0].msg_id);
+    outbox_acked(s_mqtt.pending[2].msg_id);
+    run(10);
+    outbox_stats_t before = stats();
+    CHECK_EQ(before.inflight, OUTBOX_MAX_INFLIGHT);
+    CHECK_EQ(before.depth, OUTBOX_SLOTS - 2);
+
+    size_t size;
+    CHECK(outbox_reserve(s_status, OUTBOX_MSG_MAX, &size) == NULL);
+    outbox_stats_t after = stats();
+    CHECK_EQ(after.spilled, before.spilled);
+    CHECK_EQ(after.depth, before.depth);
+    CHECK_EQ(after.spill_depth, before.spill_depth);
+    CHECK_EQ(after.dropped, before.dropped + 1);
+
+    s_mqtt.ack_delay_ms = 100;
+    run(5000);
+    CHECK_EQ(stats().depth, 0);
+}
+
+int main(void) {
+    fake_nvs_init(NULL, 0);
+    reset_link();
+    outbox_transport_t transport = {.ctx = &s_mqtt, .publish = fake_mqtt_publish};
+    CHECK_EQ(outbox_init(&transport), ESP_OK);
+    s_track = outbox_add_topic("camper/test/track", 1, OUTBOX_DROP_OLDEST);
+    s_gps = outbox_add_topic("camper/test/gps", 1, OUTBOX_COALESCE);
+    s_status = outbox_add_topic("camper/test/status", 0, OUTBOX_COALESCE);
+
+    RUN(test_slow_broker_no_republish);
+    RUN(test_disconnect_releases_inflight);
+    RUN(test_deleted_requeues_with_backoff);
+    RUN(test_release_drops_superseded);
+    RUN(test_refused_keeps_backoff);
+    RUN(test_large_message_spans);
+    RUN(test_large_message_no_room);
+    return TEST_RESULT();
+}
@@ -0,0 +1,183 @@
+/**
+ * Offline place index: images built the way tools/build_place_index.py
+ * lays them out, looked up through the fake flash mapping, and truncated
+ * or inconsistent images that init must refuse
+ * Syquens B.V. - 2026
+ */
+
+#include "config.h"
+#include "place_index.h"
+#include "fakes.h"
+#include "test.h"
+
+#define PART_SIZE   0x2000
+#define TILE_E7     1000000         // 0.1 degree
+
+typedef struct {
+    int32_t lat_e7;
+    int32_t lon_e7;
+    const char *name;
+    place_kind_t kind;
+} test_place_t;
+
+static const esp_partition_t *s_part;
+
+static int32_t floor_div(int32_t a, int32_t b) {
+    return a / b - (a % b < 0);
+}
+
+// 51.9..52.3 N, 4.0..5.0 E; places must be given sorted by tile
+static place_index_header_t *build_image(const test_place_t *places, uint32_t count) {
+    uint8_t *image = fake_flash_data(s_part);
+    memset(image, 0xFF, PART_SIZE);
+
+    place_index_header_t *hdr = (place_index_header_t *)image;
+    *hdr = (place_index_header_t){
+        .magic = PLACE_INDEX_MAGIC,
+        .version = 1,
+        .tile_e7 = TILE_E7,
+        .lat0_tile = 519,
+        .lon0_tile = 40,
+        .rows = 4,
+        .cols = 10,
+        .count = count,
+        .tiles_off = sizeof(place_index_header_t),
+    };
+    uint32_t tiles_n = hdr->rows * hdr->cols;
+    hdr->places_off = hdr->tiles_off + (tiles_n + 1) * sizeof(uint32_t);
+    hdr->strings_off = hdr->places_off + count * sizeof(place_index_entry_t);
+
+    uint32_t *tiles = (uint32_t *)(image + hdr->tiles_off);
+    place_index_entry_t *entries = (place_index_entry_t *)(image + hdr->places_off);
+    uint32_t str = 0;
+    uint32_t next = 0;
+    for (uint32_t t = 0; t <= tiles_n; t++) {
+        while (next < count) {
+            int32_t r = floor_div(places[next].lat_e7, TILE_E7) - hdr->lat0_tile;
+            int32_t c = floor_div(places[next].lon_e7, TILE_E7) - hdr->lon0_tile;
+            if ((uint32_t)(r * hdr->cols + c) >= t) break;
+            next++;
+        }
+        tiles[t] = next;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        entries[i] = (place_index_entry_t){
+            .lat_e7 = places[i].lat_e7,
+            .lon_e7 = places[i].lon_e7,
+            .name_off = str,
+            .country = { 'n', 'l' },
+            .kind = places[i].kind,
+        };
+        size_t len = strlen(places[i].name) + 1;
+        memcpy(image + hdr->strings_off + str, places[i].name, len);
+        str += len;
+    }
+    hdr->size = hdr->strings_off + str;
+    return hdr;
+}
+
+static const test_place_t s_places[] = {
+    { 520116000, 43571000, "Delft", PLACE_TOWN },
+    { 520116000, 43700000, "Tanthof", PLACE_SUBURB },
+};
+
+// Refused images run first: a failed init leaves the previous mapping alone
+static void test_rejects_bad_offsets(void) {
+    place_index_header_t *hdr = build_image(s_places, 2);
+    hdr->size = PART_SIZE + 1;
+    CHECK_EQ(place_index_init(), ESP_ERR_INVALID_SIZE);
+
+    hdr = build_image(s_places, 2);
+    hdr->tiles_off = hdr->size - 8;                 // Tile table runs past the end
+    CHECK_EQ(place_index_init(), ESP_ERR_INVALID_SIZE);
+
+    hdr = build_image(s_places, 2);
+    hdr->count = 1000;                              // Truncated place table
+    CHECK_EQ(place_index_init(), ESP_ERR_INVALID_SIZE);
+
+    hdr = build_image(s_places, 2);
+    hdr->strings_off = hdr->size;
+    CHECK_EQ(place_index_init(), ESP_ERR_INVALID_SIZE);
+
+    place_result_t res = { .name = "" };
+    CHECK(!place_index_lookup(520116000, 43571000, &res));
+}
+
+static void test_rejects_bad_tables(void) {
+    place_index_header_t *hdr = build_image(s_places, 2);
+    uint32_t *tiles = (uint32_t *)((uint8_t *)hdr + hdr->tiles_off);
+    tiles[5] = 7;                                   // Not monotonic
+    CHECK_EQ(place_index_init(), ESP_ERR_INVALID_STATE);
+
+    hdr = build_image(s_places, 2);
+    tiles = (uint32_t *)((uint8_t *)hdr + hdr->tiles_off);
+    tiles[hdr->rows * hdr->cols] = 3;               // Past the place table
+    CHECK_EQ(place_index_init(), ESP_ERR_INVALID_STATE);
+
+    hdr = build_image(s_places, 2);
+    hdr->size--;                                    // Last name unterminated
+    CHECK_EQ(place_index_init(), ESP_ERR_INVALID_STATE);
+}
+
+static void test_lookup(void) {
+    build_image(s_places, 2);
+    CHECK_EQ(place_index_init(), ESP_OK);
+
+    // A suburb 300 m away loses to the town 600 m away
+    place_result_t res = { .name = "" };
+    CHECK(place_index_lookup(520116000, 43650000, &res));
+    CHECK_STR(res.name, "Delft");
+    CHECK_STR(res.country, "nl");
+    CHECK_EQ(res.kind, PLACE_TOWN);
+    CHECK(res.distance_m > 500 && res.distance_m < 600);
+
+    CHECK(place_index_lookup(520116000, 43720000, &res));
+    CHECK_STR(res.name, "Tanthof");
+
+    CHECK(!place_index_lookup(522900000, 49900000, &res));
+}
+
+// 0.1 degree of longitude is 6.9 km at 52 N: a city 12 km east is two
+// columns over, outside the 3x3 tiles around the query
+static void test_lookup_spans_max_distance(void) {
+    static const test_place_t city[] = {
+        { 520500000, 42250000, "Leiden", PLACE_CITY },
+    };
+    build_image(city, 1);
+    CHECK_EQ(place_index_init(), ESP_OK);
+
+    place_result_t res = { .name = "" };
+    CHECK(place_index_lookup(520500000, 40500000, &res));
+    CHECK_STR(res.name, "Leiden");
+    CHECK(res.distance_m > 11500 && res.distance_m < 12500);
+
+    // 15.4 km: past the maximum distance
+    CHECK(!place_index_lookup(520500000, 40000000, &res));
+}
+
+// Out of range places are not ranked: a city 16 km away (score 1.6) must
+// not hide a village 3.5 km away (score 1.75)
+static void test_lookup_ignores_out_of_range(void) {
+    static const test_place_t places[] = {
+        { 520500000, 40500000, "Village", PLACE_VILLAGE },
+        { 520500000, 43340000, "City", PLACE_CITY },
+    };
+    build_image(places, 2);
+    CHECK_EQ(place_index_init(), ESP_OK);
+
+    place_result_t res = { .name = "" };
+    CHECK(place_index_lookup(520500000, 40990000, &res));
+    CHECK_STR(res.name, "Village");
+    CHECK(res.distance_m > 3000 && res.distance_m < 4000);
+}
+
+int main(void) {
+    s_part = fake_flash_add(PLACE_INDEX_PARTITION_LABEL, PLACE_INDEX_PARTITION_SUBTYPE, PART_SIZE, NULL);
+
+    RUN(test_rejects_bad_offsets);
+    RUN(test_rejects_bad_tables);
+    RUN(test_lookup);
+    RUN(test_lookup_spans_max_distance);
+    RUN(test_lookup_ignores_out_of_range);
+    return TEST_RESULT();
+}
@@ -0,0 +1,207 @@
+/**
+ * PPS discipline replayed on a simulated clock: a crystal with a fixed
+ * frequency error, adjtime() slewing at the IDF rate (1/6 of elapsed
+ * time), and PPS timestamps with Gaussian interrupt-latency jitter.
+ * Checks acquisition, lock quality, missing edges and holdover.
+ * Syquens B.V. - 2026
+ */
+
+#include <math.h>
+#include "config.h"
+#include "time_discipline.h"
+#include "test.h"
+
+#define SIM_TICK_US         10000
+#define SIM_SLEW_DIVISOR    6       // IDF adjtime: corrects at 1/6 of elapsed time
+
+typedef struct {
+    double drift_ppm;       // Crystal error: the local clocks gain this much
+    double jitter_us;       // Sigma of the PPS timestamp latency
+    uint64_t rng;
+
+    int64_t true_us;        // UTC, from the simulation start
+    double offset_us;       // System clock minus UTC
+    double slew_left_us;    // Pending adjtime() correction
+    td_context_t td;
+} sim_t;
+
+static double sim_gauss(sim_t *s) {
+    // xorshift64 + Box-Muller: deterministic on every host
+    double u[2];
+    for (int i = 0; i < 2; i++) {
+        s->rng ^= s->rng << 13;
+        s->rng ^= s->rng >> 7;
+        s->rng ^= s->rng << 17;
+        u[i] = ((s->rng >> 11) + 0.5) / 9007199254740992.0;
+    }
+    return sqrt(-2.0 * log(u[0])) * cos(2.0 * M_PI * u[1]);
+}
+
+// esp_timer runs off the same crystal
+static int64_t sim_mono_us(const sim_t *s) {
+    return (int64_t)(s->true_us * (1.0 + s->drift_ppm * 1e-6));
+}
+
+static void sim_init(sim_t *s, double drift_ppm, double jitter_us, double offset_us) {
+    memset(s, 0, sizeof(*s));
+    s->drift_ppm = drift_ppm;
+    s->jitter_us = jitter_us;
+    s->offset_us = offset_us;
+    s->rng = 0x9E3779B97F4A7C15ULL;
+    s->true_us = 1000000;
+    td_init(&s->td);
+}
+
+static void sim_apply(sim_t *s, td_result_t res) {
+    if (res.action == TD_ACTION_STEP) {
+        s->offset_us += res.correction_us;
+        s->slew_left_us = 0;
+    } else if (res.action == TD_ACTION_SLEW) {
+        s->slew_left_us = res.correction_us;       // adjtime replaces, not adds
+    }
+}
+
+// Run to the next whole second; feed its PPS edge unless missing
+static void sim_second(sim_t *s, bool edge) {
+    for (int t = 0; t < 1000000 / SIM_TICK_US; t++) {
+        s->true_us += SIM_TICK_US;
+        s->offset_us += s->drift_ppm * SIM_TICK_US * 1e-6;
+        double max = (double)SIM_TICK_US / SIM_SLEW_DIVISOR;
+        double step = fabs(s->slew_left_us) < max ? s->slew_left_us : copysign(max, s->slew_left_us);
+        s->offset_us += step;
+        s->slew_left_us -= step;
+    }
+    if (edge) {
+        double jitter = s->jitter_us * sim_gauss(s);
+        sim_apply(s, td_update(&s->td, llround(s->offset_us + jitter), sim_mono_us(s) + llround(jitter)));
+    }
+    // td_service runs some time later in the same second
+    sim_apply(s, td_tick(&s->td, sim_mono_us(s) + 300000));
+}
+
+static int sim_until_locked(sim_t *s, int max_s) {
+    for (int i = 1; i <= max_s; i++) {
+        sim_second(s, true);
+        if (s->td.state == TD_STATE_LOCKED) return i;
+    }
+    return -1;
+}
+
+// Residual |offset| over n locked seconds: RMS and max
+static void sim_track(sim_t *s, int n, int miss_every, double *rms, double *max) {
+    double sum = 0;
+    *max = 0;
+    for (int i = 0; i < n; i++) {
+        sim_second(s, miss_every == 0 || i % miss_every != 0);
+        sum += s->offset_us * s->offset_us;
+        if (fabs(s->offset_us) > *max) *max = fabs(s->offset_us);
+    }
+    *rms = sqrt(sum / n);
+}
+
+static void test_acquires_and_locks(void) {
+    sim_t s;
+    sim_init(&s, 40.0, 10.0, 350000.0);     // Booted from the RTC, 350 ms off
+
+    int locked_after = sim_until_locked(&s, 120);
+    printf("  locked after %d s, %u steps, %ld ppb\n", locked_after, s.td.steps, (long)s.td.freq_ppb);
+    CHECK(locked_after > 0);
+    CHECK(locked_after <= 60);
+    CHECK_EQ(s.td.steps, 1);                // One step, then slews only
+
+    double rms, max;
+    sim_track(&s, 600, 0, &rms, &max);
+    printf("  locked: rms %.1f us, max %.1f us, jitter estimate %u us, %ld ppb\n",
+           rms, max, s.td.jitter_us, (long)s.td.freq_ppb);
+    CHECK_EQ(s.td.state, TD_STATE_LOCKED);
+    CHECK(rms < 20.0);
+    CHECK(max < 100.0);
+    CHECK(fabs(s.td.freq_ppb - 40000.0) < 5000.0);   // Wanders with the jitter
+}
+
+// Sub-millisecond on the worst plausible crystal
+static void test_large_frequency_error(void) {
+    sim_t s;
+    sim_init(&s, -150.0, 10.0, -20000.0);
+    CHECK(sim_until_locked(&s, 180) > 0);
+
+    double rms, max;
+    sim_track(&s, 300, 0, &rms, &max);
+    printf("  -150 ppm: rms %.1f us, max %.1f us\n", rms, max);
+    CHECK_EQ(s.td.state, TD_STATE_LOCKED);
+    CHECK(max < TD_LOCK_THRESHOLD_US);
+}
+
+// Missed edges (noise on the PPS line) lengthen the interval, nothing more
+static void test_missing_edges(void) {
+    sim_t s;
+    sim_init(&s, 40.0, 10.0, 1000.0);
+    CHECK(sim_until_locked(&s, 120) > 0);
+
+    double rms, max;
+    sim_track(&s, 600, 7, &rms, &max);
+    CHECK_EQ(s.td.state, TD_STATE_LOCKED);
+    CHECK(rms < 30.0);
+}
+
+// Jitter is tracked, and reported as dispersion
+static void test_jitter_and_dispersion(void) {
+    const double sigmas[] = { 2.0, 20.0, 80.0 };
+    uint32_t last = 0;
+    for (int i = 0; i < 3; i++) {
+        sim_t s;
+        sim_init(&s, 40.0, sigmas[i], 1000.0);
+        sim_until_locked(&s, 120);
+        double rms, max;
+        sim_track(&s, 300, 0, &rms, &max);
+        uint32_t disp = td_dispersion_us(&s.td, sim_mono_us(&s));
+        printf("  sigma %.0f us: rms %.1f us, dispersion %u us\n", sigmas[i], rms, disp);
+        CHECK(disp >= last);
+        CHECK(disp >= rms / 2);
+        last = disp;
+    }
+}
+
+// PPS lost: holdover keeps the learned frequency, then gives up
+static void test_holdover(void) {
+    sim_t s;
+    sim_init(&s, 40.0, 10.0, 1000.0);
+    CHECK(sim_until_locked(&s, 120) > 0);
+    double rms, max;
+    sim_track(&s, 300, 0, &rms, &max);
+
+    int seconds = 0;
+    while (s.td.state == TD_STATE_LOCKED && seconds < 10) {
+        sim_second(&s, false);
+        seconds++;
+    }
+    CHECK_EQ(s.td.state, TD_STATE_HOLDOVER);
+    CHECK(seconds <= TD_PPS_TIMEOUT_US / 1000000 + 1);
+
+    // A minute later the clock has drifted far less than the raw 40 ppm
+    for (int i = 0; i < 60; i++) sim_second(&s, false);
+    seconds += 60;
+    printf("  holdover 60 s: offset %.1f us (free-running: 2400 us)\n", s.offset_us);
+    CHECK_EQ(s.td.state, TD_STATE_HOLDOVER);
+    CHECK(fabs(s.offset_us) < 500.0);
+    CHECK(td_dispersion_us(&s.td, sim_mono_us(&s)) > s.td.jitter_us);
+
+    while (s.td.state == TD_STATE_HOLDOVER && seconds < 2000) {
+        sim_second(&s, false);
+        seconds++;
+    }
+    CHECK_EQ(s.td.state, TD_STATE_UNLOCKED);
+    CHECK(seconds >= TD_HOLDOVER_MAX_US / 1000000);
+
+    // PPS returns: acquired again
+    CHECK(sim_until_locked(&s, 120) > 0);
+}
+
+int main(void) {
+    RUN(test_acquires_and_locks);
+    RUN(test_large_frequency_error);
+    RUN(test_missing_edges);
+    RUN(test_jitter_and_dispersion);
+    RUN(test_holdover);
+    return TEST_RESULT();
+}
@@ -0,0 +1,133 @@
+/**
+ * Track codec: round trips, antimeridian and range wrap, backwards time
+ * Syquens B.V. - 2026
+ */
+
+#include "track_codec.h"
+#include "drive.h"
+#include "test.h"
+
+#define MAX_POINTS 255
+
+static uint8_t s_buf[TRACK_CODEC_HEADER_SIZE + MAX_POINTS * TRACK_CODEC_POINT_MAX];
+static track_record_t s_out[MAX_POINTS];
+
+// Everything the codec carries; crc/reserved/sent are flash bookkeeping
+static bool same_point(const track_record_t *a, const track_record_t *b) {
+    return a->time == b->time && a->millis == b->millis &&
+           a->lat_e7 == b->lat_e7 && a->lon_e7 == b->lon_e7 && a->alt_dm == b->alt_dm &&
+           a->speed_ckn == b->speed_ckn && a->hdop_c == b->hdop_c &&
+           a->sats == b->sats && a->fix_type == b->fix_type;
+}
+
+// Encode, decode and compare; returns the encoded size
+static size_t round_trip(const track_record_t *recs, int count) {
+    size_t len = track_codec_encode(recs, count, s_buf, sizeof(s_buf));
+    CHECK(len >= TRACK_CODEC_HEADER_SIZE);
+    CHECK(len <= TRACK_CODEC_HEADER_SIZE + (size_t)count * TRACK_CODEC_POINT_MAX);
+    CHECK_EQ(track_codec_decode(s_buf, len, s_out, MAX_POINTS), count);
+    for (int i = 0; i < count; i++) {
+        if (!same_point(&recs[i], &s_out[i])) {
+            fprintf(stderr, "  point %d differs\n", i);
+            CHECK(same_point(&recs[i], &s_out[i]));
+            break;
+        }
+    }
+    return len;
+}
+
+static track_record_t point(uint32_t time, uint16_t millis, int32_t lat, int32_t lon, int32_t alt) {
+    return (track_record_t){ .time = time, .millis = millis, .lat_e7 = lat, .lon_e7 = lon,
+                             .alt_dm = alt, .speed_ckn = 1234, .hdop_c = 92, .sats = 9, .fix_type = 3 };
+}
+
+static void test_drive_batches(void) {
+    int count = drive_load();
+    CHECK_EQ(count, 600);
+
+    size_t total = 0;
+    for (int i = 0; i + 16 <= count; i += 16) {
+        total += round_trip(&drive_recs[i], 16);
+    }
+    // 1 Hz driving: the batch header amortised, about a dozen bytes per point
+    size_t points = (count / 16) * 16;
+    CHECK(total < points * 14);
+
+    round_trip(drive_recs, 255);
+}
+
+static void test_antimeridian(void) {
+    track_record_t recs[] = {
+        point(1768550400, 0, -170000000, 1799999990, 50),
+        point(1768550401, 0, -170000010, -1799999995, 50),  // Crossed eastwards
+        point(1768550402, 0, -170000020, 1799999985, 50),   // And back
+        point(1768550403, 0, -170000030, -1800000000, 50),
+    };
+    size_t len = round_trip(recs, 4);
+    CHECK(len < TRACK_CODEC_HEADER_SIZE + 4 * 20);
+}
+
+// Deltas that overflow int32 in plain subtraction
+static void test_extreme_deltas(void) {
+    track_record_t recs[] = {
+        point(1768550400, 0, 900000000, 1800000000, INT32_MAX),
+        point(1768550401, 0, -900000000, -1800000000, INT32_MIN),
+        point(1768550402, 0, INT32_MAX, INT32_MIN, 0),
+        point(1768550403, 0, INT32_MIN, INT32_MAX, -1),
+    };
+    round_trip(recs, 4);
+}
+
+static void test_backwards_time(void) {
+    track_record_t recs[] = {
+        point(1768550400, 500, 520907000, 51214000, 42),
+        point(1768550401, 500, 520907100, 51214100, 43),
+        point(1768550390, 0, 520907200, 51214200, 44),      // RTC stepped back 11.5 s
+        point(1768550391, 0, 520907300, 51214300, 45),
+        point(1768550391, 0, 520907300, 51214300, 45),      // Same instant: dt 0, no keyframe
+        point(1768550391, 999, 520907300, 51214300, 45),
+        point(1768550391, 998, 520907300, 51214300, 45),    // One ms back
+        point(0, 0, 0, 0, 0),                                // Unset clock
+        point(1768550400, 0, 520907000, 51214000, 42),       // Beyond the dt varint: keyframe too
+    };
+    size_t len = round_trip(recs, 9);
+
+    // Keyframes are absolute and do not disturb the deltas after them
+    track_record_t one = recs[2];
+    track_record_t pair[] = { recs[1], recs[2] };
+    size_t single = track_codec_encode(&one, 1, s_buf, sizeof(s_buf));
+    size_t with_key = track_codec_encode(pair, 2, s_buf, sizeof(s_buf));
+    CHECK_EQ(s_buf[single], 0);     // Second point starts with the keyframe marker
+    CHECK(with_key - single <= TRACK_CODEC_POINT_MAX);
+    CHECK(len > 0);
+}
+
+static void test_malformed(void) {
+    track_record_t recs[] = {
+        point(1768550400, 0, 520907000, 51214000, 42),
+        point(1768550390, 0, 520907200, 51214200, 44),
+        point(1768550391, 0, 520907300, 51214300, 45),
+    };
+    size_t len = track_codec_encode(recs, 3, s_buf, sizeof(s_buf));
+
+    // Every truncation is rejected, never read past the end
+    for (size_t cut = 0; cut < len; cut++) {
+        CHECK_EQ(track_codec_decode(s_buf, cut, s_out, MAX_POINTS), -1);
+    }
+    CHECK_EQ(track_codec_decode(s_buf, len, s_out, 2), -1);     // More points than room
+
+    s_buf[0] = 1;
+    CHECK_EQ(track_codec_decode(s_buf, len, s_out, MAX_POINTS), -1);
+
+    CHECK_EQ(track_codec_encode(recs, 3, s_buf, TRACK_CODEC_HEADER_SIZE + 40), 0);
+    CHECK_EQ(track_codec_encode(recs, 0, s_buf, sizeof(s_buf)), 0);
+}
+
+int main(void) {
+    RUN(test_drive_batches);
+    RUN(test_antimeridian);
+    RUN(test_extreme_deltas);
+    RUN(test_backwards_time);
+    RUN(test_malformed);
+    return TEST_RESULT();
+}
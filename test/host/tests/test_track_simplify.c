@@ -0,0 +1,88 @@
+/**
+ * Track simplifier: Douglas-Peucker tolerance bound and endpoints
+ * Syquens B.V. - 2026
+ */
+
+#include "track_simplify.h"
+#include "drive.h"
+#include "test.h"
+
+static track_record_t s_out[1024];
+
+// Run the whole drive through the simplifier; returns the points emitted
+static int simplify(const track_record_t *in, int n, const ts_config_t *cfg) {
+    static ts_context_t ts;
+    ts_init(&ts, cfg);
+    int n_out = 0;
+    for (int i = 0; i < n; i++) {
+        n_out += ts_push(&ts, &in[i], &s_out[n_out]);
+    }
+    n_out += ts_flush(&ts, &s_out[n_out]);
+    return n_out;
+}
+
+// Every point dropped lies within max_deviation_m of the emitted polyline
+static void test_tolerance_bound(void) {
+    int n = drive_load();
+    const float tolerances[] = { 0.5f, 2, 5, 15, 50 };
+    int prev_out = n + 1;
+
+    for (size_t t = 0; t < sizeof(tolerances) / sizeof(tolerances[0]); t++) {
+        ts_config_t cfg = { .max_deviation_m = tolerances[t], .window = TS_WINDOW_MAX };
+        int n_out = simplify(drive_recs, n, &cfg);
+
+        CHECK(n_out >= 2);
+        CHECK(n_out < prev_out);    // Looser tolerance, fewer points
+        prev_out = n_out;
+        // Float projection in the firmware vs double here: allow a few cm
+        double dev = drive_max_deviation(drive_recs, n, s_out, n_out);
+        if (dev > tolerances[t] + 0.05) {
+            fprintf(stderr, "  tolerance %.1f m: deviation %.2f m\n", tolerances[t], dev);
+            CHECK(dev <= tolerances[t] + 0.05);
+        }
+    }
+}
+
+static void test_endpoints_kept(void) {
+    int n = drive_load();
+    ts_config_t cfg = { .max_deviation_m = 1000, .window = 16 };
+    int n_out = simplify(drive_recs, n, &cfg);
+
+    CHECK_EQ(s_out[0].time, drive_recs[0].time);
+    CHECK_EQ(s_out[n_out - 1].time, drive_recs[n - 1].time);
+    // A huge tolerance keeps only the window ends
+    CHECK(n_out <= n / (cfg.window - 1) + 2);
+    for (int i = 1; i < n_out; i++) {
+        CHECK(s_out[i].time > s_out[i - 1].time);
+    }
+}
+
+static void test_straight_line(void) {
+    track_record_t line[40];
+    for (int i = 0; i < 40; i++) {
+        line[i] = (track_record_t){ .time = 1000 + i, .lat_e7 = 520000000 + i * 1000, .lon_e7 = 51000000 + i * 500 };
+    }
+    ts_config_t cfg = { .max_deviation_m = 1, .window = TS_WINDOW_MAX };
+    CHECK_EQ(simplify(line, 40, &cfg), 2);
+    CHECK_EQ(s_out[1].time, 1039);
+}
+
+static void test_parked_jitter(void) {
+    track_record_t parked[30];
+    for (int i = 0; i < 30; i++) {
+        // +-0.5 m around one spot
+        parked[i] = (track_record_t){ .time = 1000 + i, .lat_e7 = 520000000 + (i % 3 - 1) * 45,
+                                      .lon_e7 = 51000000 + (i % 2) * 70 };
+    }
+    ts_config_t cfg = { .min_distance_m = 3, .max_deviation_m = 2, .max_interval_s = 10, .window = 16 };
+    int n_out = simplify(parked, 30, &cfg);
+    CHECK_EQ(n_out, 1 + 2);     // First point, then one heartbeat every 10 s
+}
+
+int main(void) {
+    RUN(test_tolerance_bound);
+    RUN(test_endpoints_kept);
+    RUN(test_straight_line);
+    RUN(test_parked_jitter);
+    return TEST_RESULT();
+}
@@ -0,0 +1,308 @@
+/**
+ * Track log against the file-backed flash emulator: append and recover,
+ * wrap-around, and power cuts at every flash operation of an append run
+ * and of a drain. Each boot is a fork()ed child sharing the flash image
+ * file; a power cut (fake_flash_cut_after) ends the child with exit
+ * status FAKE_FLASH_CUT_EXIT, leaving the image as the cut left it.
+ * Syquens B.V. - 2026
+ */
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "config.h"
+#include "tracklog.h"
+#include "fakes.h"
+#include "test.h"
+
+#define IMAGE_SECTORS   4
+#define IMAGE_SIZE      (IMAGE_SECTORS * 4096)
+#define SLOTS           (IMAGE_SECTORS * 127)
+#define TIME_BASE       1760000000u
+
+static char s_image[512];
+static char s_saved[512];
+
+// Results a child hands back to the parent
+typedef struct {
+    uint32_t pending;
+    uint32_t valid;             // Records returned by peek
+    uint32_t first;             // Index of the oldest unsent record
+    uint32_t last;
+    uint32_t overwritten;
+} boot_result_t;
+
+static boot_result_t *s_result;
+static track_record_t s_recs[SLOTS];
+
+static track_record_t make_record(uint32_t i) {
+    track_record_t r = {0};
+    r.time = TIME_BASE + i;
+    r.lat_e7 = 520000000 + (int32_t)i * 13;
+    r.lon_e7 = 51000000 - (int32_t)i * 7;
+    r.alt_dm = (int32_t)(i % 1000);
+    r.millis = (uint16_t)(i * 100 % 1000);
+    r.speed_ckn = (uint16_t)(i % 5000);
+    r.hdop_c = 90;
+    r.sats = 9;
+    r.fix_type = 3;
+    return r;
+}
+
+// Every field as written, not just a valid CRC
+static bool record_intact(const track_record_t *r) {
+    track_record_t e = make_record(r->time - TIME_BASE);
+    return memcmp(r, &e, offsetof(track_record_t, crc)) == 0;
+}
+
+static void append_records(uint32_t first, uint32_t count) {
+    for (uint32_t i = first; i < first + count; i++) {
+        track_record_t r = make_record(i);
+        while (!tracklog_append(&r)) {
+            usleep(200);    // Writer queue full
+        }
+    }
+}
+
+// Full pages reach flash; the last partial page stays in RAM until the
+// idle flush, which a test does not wait for. Returns once the writer
+// has been quiet for 50 ms.
+static void wait_written(void) {
+    tracklog_stats_t st, prev = {0};
+    int quiet = 0;
+    while (quiet < 50) {
+        usleep(1000);
+        tracklog_get_stats(&st);
+        quiet = st.appended == prev.appended && st.sector_erases == prev.sector_erases ? quiet + 1 : 0;
+        prev = st;
+    }
+}
+
+// Boot: mount, then check what recovery found. Records must be intact
+// and consecutive from the drain position.
+static void boot_and_check(void) {
+    CHECK_EQ(tracklog_init(), ESP_OK);
+    tracklog_stats_t st;
+    tracklog_get_stats(&st);
+    int n = tracklog_peek_unsent(s_recs, SLOTS);
+
+    s_result->pending = st.pending;
+    s_result->valid = n;
+    s_result->overwritten = st.overwritten;
+    s_result->first = n > 0 ? s_recs[0].time - TIME_BASE : 0;
+    s_result->last = n > 0 ? s_recs[n - 1].time - TIME_BASE : 0;
+
+    CHECK(n <= (int)st.pending);
+    CHECK(st.pending - n <= 1);         // At most one torn record
+    for (int i = 0; i < n; i++) {
+        CHECK(record_intact(&s_recs[i]));
+        if (i > 0) CHECK_EQ(s_recs[i].time, s_recs[i - 1].time + 1);
+    }
+}
+
+static void child_append(uint32_t first, uint32_t count, long cut) {
+    CHECK_EQ(tracklog_init(), ESP_OK);
+    if (cut >= 0) fake_flash_cut_after(cut);
+    append_records(first, count);
+    wait_written();
+}
+
+static void child_drain(uint32_t count, long cut) {
+    CHECK_EQ(tracklog_init(), ESP_OK);
+    if (cut >= 0) fake_flash_cut_after(cut);
+    int n = tracklog_peek_unsent(s_recs, count);
+    CHECK_EQ(tracklog_mark_sent(n), ESP_OK);
+}
+
+typedef enum { BOOT_CHECK, BOOT_APPEND, BOOT_DRAIN } boot_kind_t;
+
+// One power-on in a child process. Returns its exit status.
+static int boot(boot_kind_t kind, uint32_t first, uint32_t count, long cut) {
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        test_failures = 0;                      // Report this boot only
+        fake_flash_add(TRACKLOG_PARTITION_LABEL, TRACKLOG_PARTITION_SUBTYPE, IMAGE_SIZE, s_image);
+        switch (kind) {
+        case BOOT_CHECK: boot_and_check(); break;
+        case BOOT_APPEND: child_append(first, count, cut); break;
+        case BOOT_DRAIN: child_drain(count, cut); break;
+        }
+        fflush(stderr);
+        _exit(test_failures ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void copy_image(const char *from, const char *to) {
+    FILE *in = fopen(from, "rb"), *out = fopen(to, "wb");
+    static uint8_t buf[IMAGE_SIZE];
+    size_t n = fread(buf, 1, sizeof(buf), in);
+    fwrite(buf, 1, n, out);
+    fclose(in);
+    fclose(out);
+}
+
+static void fresh_image(void) {
+    strcpy(s_image, test_tmp_path("tracklog.bin"));
+}
+
+static void test_append_and_recover(void) {
+    fresh_image();
+    CHECK_EQ(boot(BOOT_APPEND, 0, 100, -1), 0);
+    CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+    uint32_t written = s_result->valid;
+    CHECK(written > 100 - 8);                // All but the RAM page
+    CHECK_EQ(s_result->first, 0);
+    CHECK_EQ(s_result->pending, written);
+
+    // Drain part of it; the drain position survives the reboot
+    CHECK_EQ(boot(BOOT_DRAIN, 0, 40, -1), 0);
+    CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+    CHECK_EQ(s_result->first, 40);
+    CHECK_EQ(s_result->valid, written - 40);
+
+    // Appending after a reboot continues where the log ends
+    CHECK_EQ(boot(BOOT_APPEND, written, 50, -1), 0);
+    CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+    CHECK_EQ(s_result->first, 40);
+    CHECK(s_result->last >= written + 50 - 8);
+}
+
+// Offline for longer than the ring lasts: the oldest sectors are reclaimed
+static void test_wrap(void) {
+    fresh_image();
+    uint32_t total = SLOTS * 3;
+    CHECK_EQ(boot(BOOT_APPEND, 0, total, -1), 0);
+    CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+    printf("  wrap: %u of %u records kept, oldest %u, newest %u\n",
+           s_result->valid, total, s_result->first, s_result->last);
+    CHECK(s_result->valid >= SLOTS - 2 * 127);     // Head sector partly filled
+    CHECK(s_result->valid < SLOTS);
+    CHECK(s_result->last >= total - 8);
+    CHECK_EQ(s_result->last - s_result->first + 1, s_result->valid);
+
+    // And the ring keeps working after the reboot
+    uint32_t next = s_result->last + 1;
+    CHECK_EQ(boot(BOOT_APPEND, next, 300, -1), 0);
+    CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+    CHECK(s_result->last >= next + 300 - 8);
+    CHECK_EQ(s_result->last - s_result->first + 1, s_result->valid);
+}
+
+// Cut power at every flash operation of an append run (through a sector
+// change): recovery always succeeds, never returns a damaged record, loses
+// at most what was in flight, and the log accepts new records afterwards
+static void test_power_cut_append(void) {
+    const uint32_t count = 300;
+    uint32_t prev_valid = 0;
+    int cuts = 0;
+    for (long cut = 0;; cut++) {
+        fresh_image();
+        int status = boot(BOOT_APPEND, 0, count, cut);
+        if (status == 0) break;                 // Ran to completion: all cuts covered
+        CHECK_EQ(status, FAKE_FLASH_CUT_EXIT);
+        cuts++;
+
+        CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+        CHECK_EQ(s_result->first, 0);
+        CHECK(s_result->valid + 8 >= prev_valid);   // Later cut, no fewer records (one page of slack)
+        prev_valid = s_result->valid;
+
+        uint32_t next = s_result->valid ? s_result->last + 1 : 0;
+        CHECK_EQ(boot(BOOT_APPEND, next, 40, -1), 0);
+        CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+        CHECK_EQ(s_result->first, 0);
+        CHECK(s_result->last >= next + 40 - 8);
+        if (test_failures) break;
+    }
+    printf("  %d power cuts during append\n", cuts);
+    CHECK(cuts > count / 8);
+}
+
+// Same on a full ring: cuts land in erases of sectors still holding records
+static void test_power_cut_wrap(void) {
+    fresh_image();
+    CHECK_EQ(boot(BOOT_APPEND, 0, SLOTS + 100, -1), 0);
+    CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+    uint32_t next = s_result->last + 1;
+    strcpy(s_saved, s_image);
+    strcat(s_saved, ".saved");
+    copy_image(s_image, s_saved);
+
+    int cuts = 0;
+    for (long cut = 0;; cut++) {
+        copy_image(s_saved, s_image);
+        int status = boot(BOOT_APPEND, next, 300, cut);
+        if (status == 0) break;
+        CHECK_EQ(status, FAKE_FLASH_CUT_EXIT);
+        cuts++;
+
+        CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+        CHECK(s_result->valid >= SLOTS - 2 * 127);
+        CHECK(s_result->last + 1 >= next);
+        if (test_failures) break;
+    }
+    printf("  %d power cuts during wrap-around\n", cuts);
+    CHECK(cuts > 300 / 8);
+    remove(s_saved);
+}
+
+// Cut power while marking records sent: exactly the completed marks stick
+static void test_power_cut_drain(void) {
+    fresh_image();
+    CHECK_EQ(boot(BOOT_APPEND, 0, 120, -1), 0);
+    strcpy(s_saved, s_image);
+    strcat(s_saved, ".saved");
+    copy_image(s_image, s_saved);
+
+    for (long cut = 0; cut < 64; cut++) {
+        copy_image(s_saved, s_image);
+        CHECK_EQ(boot(BOOT_DRAIN, 0, 64, cut), FAKE_FLASH_CUT_EXIT);
+        CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+        CHECK_EQ(s_result->first, cut);
+        if (test_failures) break;
+    }
+    remove(s_saved);
+}
+
+// A record torn by a cut must not hold the drain position once the log
+// around it has been published: only records appended later come back
+static void test_torn_record_drained(void) {
+    fresh_image();
+    // Records 0-6 fill the sector's first page; the cut writes half of it
+    CHECK_EQ(boot(BOOT_APPEND, 0, 7, 0), FAKE_FLASH_CUT_EXIT);
+    CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+    CHECK_EQ(s_result->valid, 3);
+    CHECK_EQ(s_result->pending, 3);
+
+    // 3 + 8 records end on a page boundary, so all of them reach flash
+    CHECK_EQ(boot(BOOT_APPEND, 3, 11, -1), 0);
+    CHECK_EQ(boot(BOOT_DRAIN, 0, 64, -1), 0);
+    CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+    CHECK_EQ(s_result->pending, 0);
+    CHECK_EQ(s_result->valid, 0);
+
+    CHECK_EQ(boot(BOOT_APPEND, 14, 8, -1), 0);
+    for (int i = 0; i < 2; i++) {
+        CHECK_EQ(boot(BOOT_CHECK, 0, 0, -1), 0);
+        CHECK_EQ(s_result->pending, 8);
+        CHECK_EQ(s_result->valid, 8);
+        CHECK_EQ(s_result->first, 14);
+    }
+}
+
+int main(void) {
+    s_result = mmap(NULL, sizeof(*s_result), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    RUN(test_append_and_recover);
+    RUN(test_wrap);
+    RUN(test_power_cut_append);
+    RUN(test_power_cut_wrap);
+    RUN(test_power_cut_drain);
+    RUN(test_torn_record_drained);
+    return TEST_RESULT();
+}
@@ -0,0 +1,168 @@
+/**
+ * UBX NAV-PVT: payload layout, frame stream of the recorded drive, resync
+ * after corrupted, short and oversized frames, and the NMEA fix sentences
+ * staying on until a NAV-PVT frame has actually arrived
+ * Syquens B.V. - 2026
+ */
+
+#include <stddef.h>
+#include "ubx.h"
+#include "drive.h"
+#include "fakes.h"
+#include "test.h"
+
+// Offsets from the u-blox M8 interface description, UBX-NAV-PVT
+static void test_payload_layout(void) {
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, year), 4);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, valid), 11);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, nano), 16);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, fix_type), 20);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, num_sv), 23);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, lon), 24);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, lat), 28);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, h_msl), 36);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, h_acc), 40);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, g_speed), 60);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, head_mot), 64);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, p_dop), 76);
+    CHECK_EQ(offsetof(ubx_nav_pvt_t, head_veh), 84);
+}
+
+// Feed the capture in fixed-size chunks; decode every frame
+static int replay(const uint8_t *data, size_t len, size_t chunk, ubx_parser_t *p, ubx_nav_pvt_t *out, int max) {
+    int n = 0;
+    ubx_parser_reset(p);
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t left = len - off < chunk ? len - off : chunk;
+        const uint8_t *d = data + off;
+        while (left > 0) {
+            bool frame;
+            size_t used = ubx_parse(p, d, left, &frame);
+            d += used;
+            left -= used;
+            if (frame && n < max && ubx_decode_nav_pvt(p, &out[n])) n++;
+        }
+    }
+    return n;
+}
+
+static ubx_nav_pvt_t s_pvt[700];
+
+static void test_drive_frames(void) {
+    size_t len;
+    uint8_t *data = (uint8_t *)test_read_file("nav_pvt_drive.ubx", &len);
+    int n_nmea = drive_load();
+    const size_t chunks[] = { 1, 7, 92, 100, 4096, len };
+
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        ubx_parser_t p;
+        int n = replay(data, len, chunks[c], &p, s_pvt, 700);
+        CHECK_EQ(n, n_nmea);
+        CHECK_EQ(p.frames, n_nmea);
+        CHECK_EQ(p.checksum_errors, 0);
+    }
+
+    const ubx_nav_pvt_t *f = &s_pvt[0];
+    CHECK_EQ(f->year, 2026);
+    CHECK_EQ(f->month, 1);
+    CHECK_EQ(f->day, 16);
+    CHECK_EQ(f->hour * 10000 + f->min * 100 + f->sec, 101500);
+    CHECK_EQ(f->valid & (UBX_PVT_VALID_DATE | UBX_PVT_VALID_TIME), UBX_PVT_VALID_DATE | UBX_PVT_VALID_TIME);
+    CHECK_EQ(f->nano, -3210);
+    CHECK_EQ(f->fix_type, 3);
+    CHECK(f->flags & UBX_PVT_FLAGS_FIX_OK);
+    CHECK_EQ(f->h_acc, 2100);
+    CHECK_EQ(f->p_dop, 171);
+
+    // Same epochs as the NMEA log, which rounds to 1e-5 arc minutes
+    int worst = 0;
+    for (int i = 0; i < n_nmea; i++) {
+        int dlat = abs(s_pvt[i].lat - drive_recs[i].lat_e7);
+        int dlon = abs(s_pvt[i].lon - drive_recs[i].lon_e7);
+        if (dlat > worst) worst = dlat;
+        if (dlon > worst) worst = dlon;
+        CHECK_EQ(s_pvt[i].sec, drive_recs[i].time % 60);
+        CHECK_EQ(s_pvt[i].num_sv, drive_recs[i].sats);
+    }
+    CHECK(worst <= 2);
+    free(data);
+}
+
+static void test_resync(void) {
+    uint8_t stream[3 * 100 + 16];
+    ubx_nav_pvt_t pvt = { .year = 2026, .fix_type = 3, .lat = 520907000, .lon = 51214000 };
+    size_t pos = 0;
+
+    // Good frame, frame with a flipped payload byte, good frame
+    pos += ubx_build(UBX_CLASS_NAV, UBX_NAV_PVT, &pvt, sizeof(pvt), stream + pos, sizeof(stream) - pos);
+    size_t bad = pos;
+    pos += ubx_build(UBX_CLASS_NAV, UBX_NAV_PVT, &pvt, sizeof(pvt), stream + pos, sizeof(stream) - pos);
+    stream[bad + 6 + 30] ^= 0x10;
+    pos += ubx_build(UBX_CLASS_NAV, UBX_NAV_PVT, &pvt, sizeof(pvt), stream + pos, sizeof(stream) - pos);
+
+    ubx_parser_t p;
+    ubx_nav_pvt_t out[3];
+    CHECK_EQ(replay(stream, pos, 13, &p, out, 3), 2);
+    CHECK_EQ(p.checksum_errors, 1);
+    CHECK_EQ(out[1].lat, 520907000);
+
+    // Short NAV-PVT (valid checksum) is framed but not decoded
+    pos = ubx_build(UBX_CLASS_NAV, UBX_NAV_PVT, &pvt, 84, stream, sizeof(stream));
+    CHECK_EQ(replay(stream, pos, pos, &p, out, 3), 0);
+    CHECK_EQ(p.frames, 1);
+
+    // Oversized length: dropped, the next frame is found
+    const uint8_t huge[] = { UBX_SYNC1, UBX_SYNC2, UBX_CLASS_NAV, UBX_NAV_PVT, 0x00, 0x04 };
+    memcpy(stream, huge, sizeof(huge));
+    pos = sizeof(huge);
+    pos += ubx_build(UBX_CLASS_NAV, UBX_NAV_PVT, &pvt, sizeof(pvt), stream + pos, sizeof(stream) - pos);
+    CHECK_EQ(replay(stream, pos, 5, &p, out, 3), 1);
+    CHECK_EQ(p.oversized, 1);
+}
+
+// CFG-MSG frames in the captured writes that set an NMEA fix sentence's rate
+static int nmea_fix_cfgs(const fake_uart_t *u) {
+    ubx_parser_t p;
+    ubx_parser_reset(&p);
+    int n = 0;
+    for (size_t i = 0; i < u->tx_len; i++) {
+        if (ubx_parse_byte(&p, u->tx[i]) && p.cls == UBX_CLASS_CFG && p.id == UBX_CFG_MSG &&
+            p.payload[0] == UBX_CLASS_NMEA &&
+            (p.payload[1] == NMEA_ID_RMC || p.payload[1] == NMEA_ID_GGA)) {
+            n++;
+        }
+    }
+    return n;
+}
+
+// An ACK for NAV-PVT is no promise of frames: RMC and GGA are left on for
+// the GPS task to mute once one has decoded
+static void test_configure_keeps_nmea_fix(void) {
+    fake_uart_t u;
+    hal_uart_t hal;
+    fake_uart_init(&u, &hal);
+    fake_uart_gnss(&u, 9600, true);
+    ubx_config_t cfg = { .baud = 115200, .fallback_baud = 9600, .meas_rate_ms = 200,
+                         .ack_timeout_ms = 500, .nav_pvt = true };
+    ubx_config_result_t res;
+
+    CHECK(ubx_configure(&hal, &cfg, &res));
+    CHECK(res.nav_pvt);
+    CHECK_EQ(res.baud, 115200);
+    CHECK_EQ(nmea_fix_cfgs(&u), 0);
+
+    CHECK_EQ(ubx_set_msg_rate(&hal, UBX_CLASS_NMEA, NMEA_ID_RMC, 0), ESP_OK);
+    CHECK_EQ(ubx_set_msg_rate(&hal, UBX_CLASS_NMEA, NMEA_ID_GGA, 0), ESP_OK);
+    CHECK_EQ(nmea_fix_cfgs(&u), 2);
+
+    u.fail_writes = 1;
+    CHECK(ubx_set_msg_rate(&hal, UBX_CLASS_NAV, UBX_NAV_PVT, 0) != ESP_OK);
+}
+
+int main(void) {
+    RUN(test_payload_layout);
+    RUN(test_drive_frames);
+    RUN(test_resync);
+    RUN(test_configure_keeps_nmea_fix);
+    return TEST_RESULT();
+}
@@ -0,0 +1,67 @@
+/**
+ * Replays a capture through the fake UART driver into gps_rx, on a
+ * simulated clock: bytes arrive at the baud rate in FIFO bursts, and the
+ * GPS task drains the event queue every service_ms unless it is stalled.
+ * Syquens B.V. - 2026
+ */
+
+#ifndef UART_REPLAY_H
+#define UART_REPLAY_H
+
+#include <math.h>
+#include <string.h>
+#include "gps_rx.h"
+#include "fakes.h"
+
+#define REPLAY_PORT         1
+#define REPLAY_FIFO_BURST   120     // IDF default RX FIFO full threshold
+
+typedef struct {
+    uint32_t baud;
+    uint32_t service_ms;            // GPS task wakes this often (0: after every burst)
+    uint32_t stall_every_ms;        // Task blocked for stall_ms once per period (0: never)
+    uint32_t stall_ms;
+    bool binary;
+} replay_cfg_t;
+
+static inline void uart_replay(gps_rx_t *rx, const replay_cfg_t *cfg, const uint8_t *data, size_t len,
+                               void (*on_line)(const char *, size_t),
+                               void (*on_data)(const uint8_t *, size_t)) {
+    QueueHandle_t queue;
+    uart_driver_install(REPLAY_PORT, GPS_BUFFER_SIZE, 0, GPS_EVENT_QUEUE_SIZE, &queue, 0);
+    memset(rx, 0, sizeof(*rx));
+    rx->port = REPLAY_PORT;
+    rx->queue = queue;
+    rx->binary = cfg->binary;
+    rx->on_line = on_line;
+    rx->on_data = on_data;
+    gps_rx_start(rx);
+
+    double us_per_byte = 10e6 / cfg->baud;
+    double next_service_us = 0;
+    size_t sent = 0;
+    uart_event_t event;
+
+    while (sent < len) {
+        size_t burst = len - sent < REPLAY_FIFO_BURST ? len - sent : REPLAY_FIFO_BURST;
+        fake_uart_driver_rx(REPLAY_PORT, data + sent, burst);
+        sent += burst;
+
+        double now_us = sent * us_per_byte;
+        bool stalled = cfg->stall_every_ms &&
+                       fmod(now_us / 1000.0, cfg->stall_every_ms) < cfg->stall_ms;
+        if (stalled || now_us < next_service_us) continue;
+
+        while (xQueueReceive(queue, &event, 0) == pdTRUE) {
+            gps_rx_handle(rx, &event);
+        }
+        next_service_us = now_us + cfg->service_ms * 1000.0;
+    }
+
+    // Line goes quiet: the task catches up
+    while (xQueueReceive(queue, &event, 0) == pdTRUE) {
+        gps_rx_handle(rx, &event);
+    }
+}
+
+#endif // UART_REPLAY_H
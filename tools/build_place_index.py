@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Build the offline place index image for the "places" flash partition.
+
+Input is an OSM XML file containing place nodes, e.g. from a Geofabrik
+country extract:
+
+    osmium tags-filter netherlands-latest.osm.pbf \
+        n/place=city,town,village,suburb,hamlet -o places.osm
+    python3 tools/build_place_index.py places.osm places.bin --country nl
+    parttool.py write_partition --partition-name places --input places.bin
+
+The image layout is documented in main/place_index.h.
+
+Syquens B.V. - 2026
+"""
+
+import argparse
+import struct
+import sys
+import xml.etree.ElementTree as ET
+
+MAGIC = 0x31494C50          # "PLI1"
+VERSION = 1
+HEADER = struct.Struct("<IHHIiiHHIIIII")
+ENTRY = struct.Struct("<iiI2sBB")
+KINDS = {"city": 0, "town": 1, "village": 2, "suburb": 3, "hamlet": 4}
+PARTITION_SIZE = 0x100000
+
+
+def read_places(path, default_country):
+    places = []
+    for _, elem in ET.iterparse(path, events=("end",)):
+        if elem.tag != "node":
+            continue
+        tags = {t.get("k"): t.get("v") for t in elem.findall("tag")}
+        kind = KINDS.get(tags.get("place"))
+        name = tags.get("name")
+        if kind is not None and name:
+            country = (tags.get("is_in:country_code") or tags.get("ISO3166-1") or default_country)
+            places.append((round(float(elem.get("lat")) * 1e7),
+                           round(float(elem.get("lon")) * 1e7),
+                           name, country.lower()[:2].ljust(2), kind))
+        elem.clear()
+    return places
+
+
+def build(places, tile_e7):
+    tile_of = lambda p: (p[0] // tile_e7, p[1] // tile_e7)
+    rows_all = [tile_of(p)[0] for p in places]
+    cols_all = [tile_of(p)[1] for p in places]
+    lat0, lon0 = min(rows_all), min(cols_all)
+    rows, cols = max(rows_all) - lat0 + 1, max(cols_all) - lon0 + 1
+    if rows > 0xFFFF or cols > 0xFFFF:
+        sys.exit("region too large for the tile size")
+
+    key = lambda p: (tile_of(p)[0] - lat0) * cols + (tile_of(p)[1] - lon0)
+    places.sort(key=key)
+
+    # Tile table: first place index per tile, plus a terminating entry
+    tiles = [0] * (rows * cols + 1)
+    for p in places:
+        tiles[key(p) + 1] += 1
+    for i in range(1, len(tiles)):
+        tiles[i] += tiles[i - 1]
+
+    strings = bytearray()
+    offsets = {}
+    entries = bytearray()
+    for lat, lon, name, country, kind in places:
+        if name not in offsets:
+            offsets[name] = len(strings)
+            strings += name.encode("utf-8") + b"\0"
+        entries += ENTRY.pack(lat, lon, offsets[name], country.encode("ascii"), kind, 0)
+
+    tiles_off = HEADER.size
+    places_off = tiles_off + 4 * len(tiles)
+    strings_off = places_off + len(entries)
+    size = strings_off + len(strings)
+    header = HEADER.pack(MAGIC, VERSION, 0, tile_e7, lat0, lon0, rows, cols, len(places),
+                         tiles_off, places_off, strings_off, size)
+    return header + struct.pack("<%dI" % len(tiles), *tiles) + bytes(entries) + bytes(strings)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("input", help="OSM XML with place nodes")
+    ap.add_argument("output", help="partition image to write")
+    ap.add_argument("--country", default="--", help="country code for places without one")
+    ap.add_argument("--tile", type=float, default=0.1, help="tile edge in degrees (default 0.1)")
+    args = ap.parse_args()
+
+    places = read_places(args.input, args.country)
+    if not places:
+        sys.exit("no place nodes found")
+    image = build(places, round(args.tile * 1e7))
+    if len(image) > PARTITION_SIZE:
+        sys.exit("image is %d bytes, partition holds %d" % (len(image), PARTITION_SIZE))
+
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("%d places, %d bytes" % (len(places), len(image)))
+
+
+if __name__ == "__main__":
+    main()